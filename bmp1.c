@@ -0,0 +1,593 @@
+/**
+ * @file bmp1.c
+ *
+ * @brief
+ * Images 1 bit : lecture et écriture du format, passage octets <-> bits
+ * (SSE2 : comparaison de 16 octets puis _mm_movemask_epi8 pour ranger,
+ * masques par bit pour développer), et traitements directement sur les
+ * bits : la morphologie traite huit pixels par opération d'octet, le
+ * comptage des composantes connexes travaille sur des segments de pixels
+ * à 1 et saute les octets entièrement vides ou pleins.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp1.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define BMP1_DATA_OFFSET (BMP_HEADER_SIZE + BMP1_PALETTE_SIZE)
+#define BMP1_GRAIN 64
+
+typedef struct {
+    const t_bmp1 *src;
+    uint8_t *dst;
+    int erode;
+    atomic_int failed;  // Une bande n'a pas pu allouer son anneau
+} t_bmp1_morph_pass;
+
+typedef struct {
+    t_bmp8 *gray;
+    t_bmp1 *bits;
+    int threshold;
+} t_bmp1_convert_pass;
+
+
+/* Inverse l'ordre des bits d'un octet (movemask range le pixel 0 en bit 0) */
+static inline uint8_t bmp1_reverseBits(uint32_t v) {
+    v = ((v & 0xF0) >> 4) | ((v & 0x0F) << 4);
+    v = ((v & 0xCC) >> 2) | ((v & 0x33) << 2);
+    v = ((v & 0xAA) >> 1) | ((v & 0x55) << 1);
+    return (uint8_t)v;
+}
+
+
+static void bmp1_setField(unsigned char *header, int offset, uint32_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        header[offset + i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+
+static uint32_t bmp1_getField(const unsigned char *header, int offset, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint32_t)header[offset + i] << (8 * i);
+    }
+    return value;
+}
+
+
+/* En-tête cohérent avec les dimensions (lignes de bas en haut, non compressé) */
+static void bmp1_fillHeader(t_bmp1 *img) {
+    uint32_t dataSize = img->stride * img->height;
+
+    memset(img->header, 0, BMP_HEADER_SIZE);
+    img->header[0] = 'B';
+    img->header[1] = 'M';
+    bmp1_setField(img->header, 2, BMP1_DATA_OFFSET + dataSize, 4);
+    bmp1_setField(img->header, 10, BMP1_DATA_OFFSET, 4);
+    bmp1_setField(img->header, 14, 40, 4);
+    bmp1_setField(img->header, 18, img->width, 4);
+    bmp1_setField(img->header, 22, img->height, 4);
+    bmp1_setField(img->header, 26, 1, 2);
+    bmp1_setField(img->header, 28, 1, 2);
+    bmp1_setField(img->header, 34, dataSize, 4);
+    bmp1_setField(img->header, 38, 2835, 4); // 72 DPI
+    bmp1_setField(img->header, 42, 2835, 4);
+    bmp1_setField(img->header, 46, 2, 4);
+}
+
+
+/* Masque des bits valides du dernier octet d'une ligne */
+static inline uint8_t bmp1_lastMask(uint32_t width) {
+    return (width % 8 == 0) ? 0xFF : (uint8_t)(0xFF << (8 - width % 8));
+}
+
+
+t_bmp1 *bmp1_allocate(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        fprintf(stderr, "Erreur: Dimensions invalides\n");
+        return NULL;
+    }
+
+    t_bmp1 *img = (t_bmp1 *)malloc(sizeof(t_bmp1));
+    if (img == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        return NULL;
+    }
+
+    img->width = width;
+    img->height = height;
+    img->stride = ((width + 31) / 32) * 4;
+    img->data = (uint8_t *)calloc((size_t)img->stride * height, 1);
+    if (img->data == NULL) {
+        perror("Erreur: Allocation mémoire échouée pour les données");
+        free(img);
+        return NULL;
+    }
+
+    // Couleur 0 noire, couleur 1 blanche
+    memset(img->palette, 0, BMP1_PALETTE_SIZE);
+    memset(img->palette + 4, 255, 3);
+    bmp1_fillHeader(img);
+    return img;
+}
+
+
+void bmp1_free(t_bmp1 *img) {
+    if (img != NULL) {
+        free(img->data);
+        free(img);
+    }
+}
+
+
+t_bmp1 *bmp1_loadImage(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier");
+        return NULL;
+    }
+
+    unsigned char header[BMP_HEADER_SIZE];
+    if (fread(header, 1, BMP_HEADER_SIZE, file) != BMP_HEADER_SIZE || header[0] != 'B' || header[1] != 'M') {
+        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP\n");
+        fclose(file);
+        return NULL;
+    }
+    if (bmp1_getField(header, 28, 2) != 1 || bmp1_getField(header, 30, 4) != 0) {
+        fprintf(stderr, "Erreur: L'image n'est pas en 1 bit non compressé\n");
+        fclose(file);
+        return NULL;
+    }
+
+    int32_t width = (int32_t)bmp1_getField(header, 18, 4);
+    int32_t height = (int32_t)bmp1_getField(header, 22, 4);
+    int topDown = (height < 0);
+    if (topDown) {
+        height = -height;
+    }
+
+    t_bmp1 *img = (width > 0 && height > 0) ? bmp1_allocate((uint32_t)width, (uint32_t)height) : NULL;
+    if (img == NULL) {
+        fclose(file);
+        return NULL;
+    }
+
+    // La palette suit l'en-tête d'informations, dont la taille peut dépasser 40 octets
+    uint32_t infoSize = bmp1_getField(header, 14, 4);
+    if (fseek(file, 14 + (long)infoSize, SEEK_SET) != 0 ||
+        fread(img->palette, 1, BMP1_PALETTE_SIZE, file) != BMP1_PALETTE_SIZE ||
+        fseek(file, (long)bmp1_getField(header, 10, 4), SEEK_SET) != 0 ||
+        fread(img->data, 1, (size_t)img->stride * img->height, file) != (size_t)img->stride * img->height) {
+        fprintf(stderr, "Erreur: Impossible de lire les données de l'image\n");
+        bmp1_free(img);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    // On garde l'ordre du fichier classique (de bas en haut)
+    if (topDown) {
+        uint8_t *tmp = (uint8_t *)malloc(img->stride);
+        if (tmp == NULL) {
+            perror("Erreur: Allocation mémoire échouée");
+            bmp1_free(img);
+            return NULL;
+        }
+        for (uint32_t y = 0; y < img->height / 2; y++) {
+            uint8_t *a = img->data + (size_t)y * img->stride;
+            uint8_t *b = img->data + (size_t)(img->height - 1 - y) * img->stride;
+            memcpy(tmp, a, img->stride);
+            memcpy(a, b, img->stride);
+            memcpy(b, tmp, img->stride);
+        }
+        free(tmp);
+    }
+
+    // Bits de remplissage remis à 0
+    uint32_t bytes = (img->width + 7) / 8;
+    for (uint32_t y = 0; y < img->height; y++) {
+        uint8_t *row = img->data + (size_t)y * img->stride;
+        row[bytes - 1] &= bmp1_lastMask(img->width);
+        memset(row + bytes, 0, img->stride - bytes);
+    }
+
+    return img;
+}
+
+
+int bmp1_saveImage(const char *filename, t_bmp1 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier pour l'écriture");
+        return -1;
+    }
+
+    bmp1_fillHeader(img);
+    size_t dataSize = (size_t)img->stride * img->height;
+    if (fwrite(img->header, 1, BMP_HEADER_SIZE, file) != BMP_HEADER_SIZE ||
+        fwrite(img->palette, 1, BMP1_PALETTE_SIZE, file) != BMP1_PALETTE_SIZE ||
+        fwrite(img->data, 1, dataSize, file) != dataSize) {
+        perror("Erreur: Impossible d'écrire l'image");
+        fclose(file);
+        return -1;
+    }
+
+    fclose(file);
+    return 0;
+}
+
+
+/* OCTETS <-> BITS */
+
+void bmp_packRow(const uint8_t *src, uint8_t *dst, int width, uint8_t threshold) {
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i limit = _mm_set1_epi8((char)threshold);
+    for (; x + 16 <= width; x += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x));
+        // v >= seuil  <=>  max(v, seuil) == v
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, limit), v));
+        dst[x / 8] = bmp1_reverseBits(mask & 0xFF);
+        dst[x / 8 + 1] = bmp1_reverseBits((mask >> 8) & 0xFF);
+    }
+#endif
+
+    for (; x < width; x += 8) {
+        uint8_t byte = 0;
+        for (int b = 0; b < 8 && x + b < width; b++) {
+            byte |= (uint8_t)((src[x + b] >= threshold) << (7 - b));
+        }
+        dst[x / 8] = byte;
+    }
+}
+
+
+void bmp_unpackRow(const uint8_t *src, uint8_t *dst, int width) {
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i bits = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                       (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    for (; x + 16 <= width; x += 16) {
+        // Chaque octet source répété 8 fois, puis test de son bit
+        __m128i v = _mm_cvtsi32_si128(src[x / 8] | (src[x / 8 + 1] << 8));
+        v = _mm_unpacklo_epi8(v, v);
+        v = _mm_unpacklo_epi16(v, v);
+        v = _mm_unpacklo_epi32(v, v);
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_cmpeq_epi8(_mm_and_si128(v, bits), bits));
+    }
+#endif
+
+    for (; x < width; x++) {
+        dst[x] = ((src[x / 8] >> (7 - x % 8)) & 1) ? 255 : 0;
+    }
+}
+
+
+static void bmp1_packBand(void *arg, int begin, int end) {
+    const t_bmp1_convert_pass *pass = (const t_bmp1_convert_pass *)arg;
+    uint32_t height = pass->gray->height;
+
+    // Lignes 1 bit de bas en haut, ligne y comptée depuis le bas
+    for (int y = begin; y < end; y++) {
+        bmp_packRow(bmp8_row(pass->gray, height - 1 - y), pass->bits->data + (size_t)y * pass->bits->stride,
+                    pass->gray->width, (uint8_t)pass->threshold);
+    }
+}
+
+
+static void bmp1_unpackBand(void *arg, int begin, int end) {
+    const t_bmp1_convert_pass *pass = (const t_bmp1_convert_pass *)arg;
+    uint32_t height = pass->gray->height;
+
+    for (int y = begin; y < end; y++) {
+        bmp_unpackRow(pass->bits->data + (size_t)y * pass->bits->stride, bmp8_row(pass->gray, height - 1 - y),
+                      pass->gray->width);
+    }
+}
+
+
+t_bmp1 *bmp8_toBmp1(t_bmp8 *img, int threshold) {
+    if (img == NULL || img->data == NULL || threshold < 0 || threshold > 256) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp1 *bits = bmp1_allocate(img->width, img->height);
+    if (bits == NULL) {
+        return NULL;
+    }
+
+    if (threshold == 256) {
+        return bits;    // Aucun pixel n'atteint le seuil
+    }
+
+    t_bmp1_convert_pass pass = {img, bits, threshold};
+    bmp_parallelFor(img->height, BMP1_GRAIN, bmp1_packBand, &pass);
+    return bits;
+}
+
+
+t_bmp8 *bmp1_toBmp8(t_bmp1 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    t_bmp8 *gray = bmp8_allocate(img->width, img->height);
+    if (gray == NULL) {
+        return NULL;
+    }
+
+    t_bmp1_convert_pass pass = {gray, img, 0};
+    bmp_parallelFor(img->height, BMP1_GRAIN, bmp1_unpackBand, &pass);
+    return gray;
+}
+
+
+void bmp1_invert(t_bmp1 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return;
+    }
+
+    uint32_t bytes = (img->width + 7) / 8;
+    for (uint32_t y = 0; y < img->height; y++) {
+        uint8_t *row = img->data + (size_t)y * img->stride;
+        for (uint32_t i = 0; i < bytes; i++) {
+            row[i] = (uint8_t)~row[i];
+        }
+        row[bytes - 1] &= bmp1_lastMask(img->width);
+    }
+}
+
+
+/* MORPHOLOGIE */
+
+/*
+ * Voisinage horizontal d'une ligne : pixel OU (dilatation) / ET (érosion)
+ * ses deux voisins. Le voisin de gauche d'un pixel est le bit de poids
+ * plus fort ; hors de l'image on prend l'élément neutre de l'opération.
+ */
+static void bmp1_horizontal(const uint8_t *row, uint8_t *dst, uint32_t bytes, uint8_t lastMask, int erode) {
+    uint8_t outside = erode ? 0xFF : 0x00;
+
+    for (uint32_t i = 0; i < bytes; i++) {
+        uint8_t cur = row[i];
+        uint8_t prev = (i > 0) ? row[i - 1] : outside;
+        uint8_t next = (i + 1 < bytes) ? row[i + 1] : outside;
+        if (erode && i + 1 == bytes) {
+            cur |= (uint8_t)~lastMask;      // Remplissage vu comme hors de l'image
+        }
+
+        uint8_t left = (uint8_t)((cur >> 1) | (prev << 7));
+        uint8_t right = (uint8_t)((cur << 1) | (next >> 7));
+        dst[i] = erode ? (cur & left & right) : (cur | left | right);
+    }
+}
+
+
+static void bmp1_morphBand(void *arg, int begin, int end) {
+    t_bmp1_morph_pass *pass = (t_bmp1_morph_pass *)arg;
+    const t_bmp1 *src = pass->src;
+    uint32_t bytes = (src->width + 7) / 8;
+    uint8_t lastMask = bmp1_lastMask(src->width);
+    uint8_t *lines = (uint8_t *)malloc((size_t)3 * bytes);
+
+    if (lines == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    // Anneau des voisinages horizontaux des lignes y - 1, y, y + 1
+    for (int y = begin - 1; y <= begin; y++) {
+        if (y >= 0) {
+            bmp1_horizontal(src->data + (size_t)y * src->stride, lines + (size_t)((y + 3) % 3) * bytes,
+                            bytes, lastMask, pass->erode);
+        }
+    }
+
+    for (int y = begin; y < end; y++) {
+        if (y + 1 < (int)src->height) {
+            bmp1_horizontal(src->data + (size_t)(y + 1) * src->stride, lines + (size_t)((y + 1) % 3) * bytes,
+                            bytes, lastMask, pass->erode);
+        }
+
+        const uint8_t *above = (y > 0) ? lines + (size_t)((y + 2) % 3) * bytes : NULL;
+        const uint8_t *middle = lines + (size_t)(y % 3) * bytes;
+        const uint8_t *below = (y + 1 < (int)src->height) ? lines + (size_t)((y + 1) % 3) * bytes : NULL;
+        uint8_t *dst = pass->dst + (size_t)y * src->stride;
+
+        for (uint32_t i = 0; i < bytes; i++) {
+            uint8_t v = middle[i];
+            if (pass->erode) {
+                v &= (above != NULL) ? above[i] : 0xFF;
+                v &= (below != NULL) ? below[i] : 0xFF;
+            } else {
+                v |= (above != NULL) ? above[i] : 0x00;
+                v |= (below != NULL) ? below[i] : 0x00;
+            }
+            dst[i] = v;
+        }
+        dst[bytes - 1] &= lastMask;
+    }
+
+    free(lines);
+}
+
+
+static int bmp1_morphology(t_bmp1 *img, int iterations, int erode) {
+    if (img == NULL || img->data == NULL || iterations < 0) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    size_t size = (size_t)img->stride * img->height;
+    uint8_t *buffer = (uint8_t *)calloc(size, 1);
+    if (buffer == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        return -1;
+    }
+
+    // Si une bande échoue, l'image garde le résultat de l'itération précédente
+    int status = 0;
+    for (int i = 0; i < iterations && status == 0; i++) {
+        t_bmp1_morph_pass pass = {img, buffer, erode};
+        atomic_init(&pass.failed, 0);
+        bmp_parallelFor(img->height, BMP1_GRAIN, bmp1_morphBand, &pass);
+        if (atomic_load(&pass.failed) != 0) {
+            status = -1;
+            break;
+        }
+
+        uint8_t *tmp = img->data;
+        img->data = buffer;
+        buffer = tmp;
+    }
+
+    free(buffer);
+    return status;
+}
+
+
+int bmp1_erode(t_bmp1 *img, int iterations) {
+    return bmp1_morphology(img, iterations, 1);
+}
+
+
+int bmp1_dilate(t_bmp1 *img, int iterations) {
+    return bmp1_morphology(img, iterations, 0);
+}
+
+
+/* COMPOSANTES CONNEXES */
+
+/* Segments [start, end) de pixels à 1 d'une ligne ; renvoie leur nombre */
+static int bmp1_runs(const uint8_t *row, int width, int *starts, int *ends) {
+    int count = 0, x = 0;
+
+    while (x < width) {
+        uint8_t byte = row[x / 8];
+        if (x % 8 == 0 && byte == 0x00) {
+            x += 8;
+            continue;
+        }
+        if (!((byte >> (7 - x % 8)) & 1)) {
+            x++;
+            continue;
+        }
+
+        starts[count] = x;
+        while (x < width) {
+            if (x % 8 == 0 && row[x / 8] == 0xFF) {
+                x += 8;
+            } else if ((row[x / 8] >> (7 - x % 8)) & 1) {
+                x++;
+            } else {
+                break;
+            }
+        }
+        ends[count++] = (x < width) ? x : width;
+    }
+
+    return count;
+}
+
+
+static int bmp1_find(int *parent, int label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];
+        label = parent[label];
+    }
+    return label;
+}
+
+
+int bmp1_countComponents(t_bmp1 *img, int connectivity) {
+    if (img == NULL || img->data == NULL || (connectivity != 4 && connectivity != 8)) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    int width = (int)img->width;
+    int maxRuns = width / 2 + 1;
+    int *runs = (int *)malloc((size_t)6 * maxRuns * sizeof(int));
+    int capacity = 1024;
+    int *parent = (int *)malloc((size_t)capacity * sizeof(int));
+
+    if (runs == NULL || parent == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        free(runs);
+        free(parent);
+        return -1;
+    }
+
+    // Segments et étiquettes de la ligne précédente et de la ligne courante
+    int *prevStart = runs, *prevEnd = runs + maxRuns, *prevLabel = runs + 2 * maxRuns;
+    int *curStart = runs + 3 * maxRuns, *curEnd = runs + 4 * maxRuns, *curLabel = runs + 5 * maxRuns;
+    int prevCount = 0, labels = 0, components = 0;
+    int reach = (connectivity == 8) ? 1 : 0;   // Les diagonales prolongent un segment d'un pixel
+
+    for (uint32_t y = 0; y < img->height; y++) {
+        int count = bmp1_runs(img->data + (size_t)y * img->stride, width, curStart, curEnd);
+
+        int j = 0;
+        for (int i = 0; i < count; i++) {
+            if (labels == capacity) {
+                int *grown = (int *)realloc(parent, (size_t)capacity * 2 * sizeof(int));
+                if (grown == NULL) {
+                    perror("Erreur: Allocation mémoire échouée");
+                    free(runs);
+                    free(parent);
+                    return -1;
+                }
+                parent = grown;
+                capacity *= 2;
+            }
+            curLabel[i] = labels;
+            parent[labels++] = curLabel[i];
+            components++;
+
+            // Segments du dessus qui touchent celui-ci (les deux listes sont triées)
+            while (j < prevCount && prevEnd[j] + reach <= curStart[i]) {
+                j++;
+            }
+            for (int k = j; k < prevCount && prevStart[k] < curEnd[i] + reach; k++) {
+                int a = bmp1_find(parent, curLabel[i]);
+                int b = bmp1_find(parent, prevLabel[k]);
+                if (a != b) {
+                    parent[a] = b;
+                    components--;
+                }
+            }
+        }
+
+        int *swap;
+        swap = prevStart; prevStart = curStart; curStart = swap;
+        swap = prevEnd; prevEnd = curEnd; curEnd = swap;
+        swap = prevLabel; prevLabel = curLabel; curLabel = swap;
+        prevCount = count;
+    }
+
+    free(runs);
+    free(parent);
+    return components;
+}
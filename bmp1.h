@@ -0,0 +1,112 @@
+/**
+ * @file bmp1.h
+ *
+ * @brief
+ * Images BMP 1 bit (noir et blanc) : huit pixels par octet, en mémoire
+ * comme dans le fichier. Après un seuillage, chaque pixel ne vaut que 0 ou
+ * 255 : les ranger sur un bit divise par huit la mémoire, la taille du
+ * fichier et le volume lu par les traitements (morphologie, composantes
+ * connexes) qui travaillent directement sur les bits.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMP1_H
+#define BMP1_H
+
+#include <stdint.h>
+#include "bmp8.h"
+
+#define BMP1_PALETTE_SIZE 8
+
+/*
+ * Image 1 bit. Les lignes sont rangées de bas en haut comme dans le
+ * fichier (même ordre que t_bmp8), le pixel 0 d'une ligne est le bit de
+ * poids fort de son premier octet, et chaque ligne occupe stride octets
+ * (multiple de 4). Les bits de remplissage en fin de ligne valent 0.
+ * Un bit à 1 correspond à la couleur 1 de la palette (blanc par défaut).
+ */
+typedef struct {
+    unsigned char header[BMP_HEADER_SIZE];      // En-tête du fichier BMP
+    unsigned char palette[BMP1_PALETTE_SIZE];   // Deux couleurs B, G, R, réservé
+    uint8_t *data;                              // Pixels (stride * height octets)
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;                            // Octets par ligne
+} t_bmp1;
+
+/* bmp1_allocate
+ * Rôle : Crée une image 1 bit vide (tous les bits à 0, palette noir/blanc)
+ * Retour : Nouvelle image, NULL si erreur
+ */
+t_bmp1 *bmp1_allocate(uint32_t width, uint32_t height);
+
+/* bmp1_free
+ * Rôle : Libère une image 1 bit
+ */
+void bmp1_free(t_bmp1 *img);
+
+/* bmp1_loadImage
+ * Rôle : Charge un fichier BMP 1 bit non compressé
+ * Retour : Image chargée, NULL si erreur
+ */
+t_bmp1 *bmp1_loadImage(const char *filename);
+
+/* bmp1_saveImage
+ * Rôle : Enregistre une image 1 bit
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp1_saveImage(const char *filename, t_bmp1 *img);
+
+/* bmp_packRow
+ * Rôle : Range une ligne d'octets sur des bits (bit à 1 si valeur >= threshold)
+ * Paramètres :
+ *   src       - width octets
+ *   dst       - (width + 7) / 8 octets ; les bits après width sont mis à 0
+ *   width     - Nombre de pixels
+ *   threshold - Seuil (128 pour une image déjà binarisée en 0 / 255)
+ */
+void bmp_packRow(const uint8_t *src, uint8_t *dst, int width, uint8_t threshold);
+
+/* bmp_unpackRow
+ * Rôle : Développe une ligne de bits en octets (0 ou 255)
+ */
+void bmp_unpackRow(const uint8_t *src, uint8_t *dst, int width);
+
+/* bmp8_toBmp1
+ * Rôle : Seuille une image 8 bits directement dans une image 1 bit
+ *        (même règle que bmp8_threshold : valeur >= threshold -> blanc)
+ * Retour : Nouvelle image 1 bit, NULL si erreur
+ */
+t_bmp1 *bmp8_toBmp1(t_bmp8 *img, int threshold);
+
+/* bmp1_toBmp8
+ * Rôle : Convertit une image 1 bit en image 8 bits (0 ou 255)
+ * Retour : Nouvelle image 8 bits, NULL si erreur
+ */
+t_bmp8 *bmp1_toBmp8(t_bmp1 *img);
+
+/* bmp1_invert
+ * Rôle : Inverse tous les pixels (pour traiter le texte noir comme objet)
+ */
+void bmp1_invert(t_bmp1 *img);
+
+/* bmp1_erode / bmp1_dilate
+ * Rôle : Érosion / dilatation des pixels à 1 par un carré 3x3, répétée
+ *        iterations fois ; les pixels hors de l'image sont ignorés
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp1_erode(t_bmp1 *img, int iterations);
+int bmp1_dilate(t_bmp1 *img, int iterations);
+
+/* bmp1_countComponents
+ * Rôle : Compte les composantes connexes de pixels à 1
+ * Paramètres :
+ *   img          - Image analysée
+ *   connectivity - 4 ou 8 voisins
+ * Retour : Nombre de composantes, -1 si erreur
+ */
+int bmp1_countComponents(t_bmp1 *img, int connectivity);
+
+#endif
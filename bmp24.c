@@ -11,9 +11,13 @@
  */
 
 #include "bmp24.h"
+#include "bmp8.h"
 #include <string.h>
 #include <stdlib.h>
 
+// Les traitements génériques voient une ligne comme 3 octets par pixel
+_Static_assert(sizeof(t_pixel) == 3, "t_pixel doit faire 3 octets");
+
 
 
 
@@ -42,6 +46,8 @@ void file_rawWrite(uint32_t position, void *buffer, uint32_t size, size_t n, FIL
  *   width  - Largeur de l'image
  *   height - Hauteur de l'image
  * Retour : Tableau 2D de pixels ou NULL si erreur
+ * Note : Toutes les lignes sont dans un seul bloc contigu (pixels[0]),
+ *        pixels[y] pointe sur le début de la ligne y
  */
 t_pixel **bmp24_allocateDataPixels(int width, int height) {
     t_pixel **pixels = (t_pixel **)malloc(height * sizeof(t_pixel *));
@@ -50,16 +56,15 @@ t_pixel **bmp24_allocateDataPixels(int width, int height) {
         return NULL;
     }
 
+    t_pixel *block = (t_pixel *)malloc((size_t)width * height * sizeof(t_pixel));
+    if (block == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour les pixels de l'image\n");
+        free(pixels);
+        return NULL;
+    }
+
     for (int i = 0; i < height; i++) {
-        pixels[i] = (t_pixel *)malloc(width * sizeof(t_pixel));
-        if (pixels[i] == NULL) {
-            printf("Erreur: Impossible d'allouer de la mémoire pour les pixels de la ligne %d\n", i);
-            for (int j = 0; j < i; j++) {
-                free(pixels[j]);
-            }
-            free(pixels);
-            return NULL;
-        }
+        pixels[i] = block + (size_t)i * width;
     }
 
     return pixels;
@@ -68,7 +73,7 @@ t_pixel **bmp24_allocateDataPixels(int width, int height) {
 /* bmp24_freeDataPixels
  * Rôle : Libère la mémoire d'un tableau de pixels
  * Paramètres :
- *   pixels - Tableau à libérer
+ *   pixels - Tableau à libérer (alloué par bmp24_allocateDataPixels)
  *   height - Nombre de lignes du tableau
  */
 void bmp24_freeDataPixels(t_pixel **pixels, int height) {
@@ -76,10 +81,8 @@ void bmp24_freeDataPixels(t_pixel **pixels, int height) {
         return;
     }
 
-    for (int i = 0; i < height; i++) {
-        if (pixels[i] != NULL) {
-            free(pixels[i]);
-        }
+    if (height > 0) {
+        free(pixels[0]);
     }
     free(pixels);
 }
@@ -106,11 +109,54 @@ t_bmp24 *bmp24_allocate(int width, int height, int colorDepth) {
         return NULL;
     }
 
+    // En-têtes par défaut (remplacés par ceux du fichier lors d'un chargement)
+    uint32_t rowSize = bmp24_rowSize(width);
+    img->topDown = 0;
+    memset(&img->header, 0, sizeof(t_bmp_header));
+    memset(&img->header_info, 0, sizeof(t_bmp_info));
+    img->header.type = BMP_TYPE;
+    img->header.offset = HEADER_SIZE + INFO_SIZE;
+    img->header.size = img->header.offset + rowSize * height;
+    img->header_info.size = INFO_SIZE;
+    img->header_info.width = width;
+    img->header_info.height = height;
+    img->header_info.planes = 1;
+    img->header_info.bits = DEFAULT_DEPTH;
+    img->header_info.imageSize = rowSize * height;
+    img->header_info.xPixelsPerMeter = 2835;
+    img->header_info.yPixelsPerMeter = 2835;
+
     return img;
 }
 
 
 
+/* bmp24_getRows
+ * Rôle : Donne les lignes de l'image vues comme des octets entrelacés
+ *        (3 octets par pixel), pour les traitements génériques
+ * Retour : Tableau de height pointeurs à libérer avec free(), NULL si erreur
+ */
+uint8_t **bmp24_getRows(t_bmp24 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    uint8_t **rows = (uint8_t **)malloc(img->height * sizeof(uint8_t *));
+    if (rows == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour les lignes\n");
+        return NULL;
+    }
+
+    for (int y = 0; y < img->height; y++) {
+        rows[y] = (uint8_t *)img->data[y];
+    }
+
+    return rows;
+}
+
+
+
 
 
 
@@ -128,19 +174,71 @@ void bmp24_free(t_bmp24 *img) {
 }
 
 
+/* bmp24_lumaRow
+ * Rôle : Calcule la luminance d'une ligne de pixels
+ * Paramètres :
+ *   row   - Ligne de pixels RGB
+ *   luma  - Ligne de sortie (width octets)
+ *   width - Nombre de pixels
+ * Calcul : Y = 0.299 R + 0.587 G + 0.114 B en virgule fixe sur 8 bits
+ */
+void bmp24_lumaRow(const t_pixel *row, uint8_t *luma, int width) {
+    for (int x = 0; x < width; x++) {
+        luma[x] = (uint8_t)((77 * row[x].red + 150 * row[x].green + 29 * row[x].blue + 128) >> 8);
+    }
+}
+
+
 /* FONCTIONS DE LECTURE/ÉCRITURE PIXELS */
 
+/* bmp24_rowSize
+ * Rôle : Taille d'une ligne dans le fichier, padding compris
+ */
+uint32_t bmp24_rowSize(int width) {
+    return ((uint32_t)width * 3 + 3) & ~3u;
+}
+
+/* bmp24_fileRow
+ * Rôle : Position de la ligne y (comptée depuis le haut) dans le fichier
+ */
+static int bmp24_fileRow(const t_bmp24 *image, int y) {
+    return image->topDown ? y : image->height - 1 - y;
+}
+
+/* bmp24_decodeRow
+ * Rôle : Convertit une ligne du fichier (B, G, R) en pixels
+ */
+void bmp24_decodeRow(const uint8_t *line, t_pixel *row, int width) {
+    for (int x = 0; x < width; x++) {
+        row[x].blue = line[3 * x];
+        row[x].green = line[3 * x + 1];
+        row[x].red = line[3 * x + 2];
+    }
+}
+
+/* bmp24_encodeRow
+ * Rôle : Convertit des pixels en ligne du fichier (B, G, R), sans le padding
+ */
+void bmp24_encodeRow(const t_pixel *row, uint8_t *line, int width) {
+    for (int x = 0; x < width; x++) {
+        line[3 * x] = row[x].blue;
+        line[3 * x + 1] = row[x].green;
+        line[3 * x + 2] = row[x].red;
+    }
+}
+
 /* bmp24_readPixelValue
  * Rôle : Lit un pixel depuis le fichier BMP
  * Paramètres :
  *   image - Image en cours de lecture
  *   x, y  - Coordonnées du pixel
  *   file  - Fichier source
- * Note : Gère l'inversion verticale du format BMP
+ * Note : Gère l'ordre des lignes du fichier (de bas en haut, ou de haut en
+ *        bas si la hauteur est négative) et le padding des lignes
  */
 void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 
-    uint32_t position = image->header.offset + ((image->height - 1 - y) * image->width + x) * 3;
+    uint32_t position = image->header.offset + bmp24_fileRow(image, y) * bmp24_rowSize(image->width) + x * 3;
 
 
     uint8_t bgr[3];
@@ -153,15 +251,35 @@ void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 }
 
 
-
-
-
-void bmp24_readPixelData(t_bmp24 *image, FILE *file) {
-    for (int y = 0; y < image->height; y++) {
-        for (int x = 0; x < image->width; x++) {
-            bmp24_readPixelValue(image, x, y, file);
+/* bmp24_readPixelData
+ * Rôle : Lit tous les pixels, ligne par ligne dans l'ordre du fichier
+ * Retour : 0 si toutes les lignes sont lues, -1 sinon (mémoire ou fichier tronqué)
+ * Note : Une seule lecture séquentielle, chaque ligne est rangée
+ *        directement à sa place (pas de retournement après coup)
+ */
+int bmp24_readPixelData(t_bmp24 *image, FILE *file) {
+    uint32_t rowSize = bmp24_rowSize(image->width);
+    uint8_t *line = (uint8_t *)malloc(rowSize);
+    if (line == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour la lecture\n");
+        return -1;
+    }
+
+    int status = 0;
+    fseek(file, image->header.offset, SEEK_SET);
+    for (int i = 0; i < image->height; i++) {
+        // Le padding de la dernière ligne est parfois absent
+        if (fread(line, 1, rowSize, file) < (size_t)image->width * 3) {
+            printf("Erreur: Données de l'image incomplètes\n");
+            status = -1;
+            break;
         }
+
+        bmp24_decodeRow(line, image->data[bmp24_fileRow(image, i)], image->width);
     }
+
+    free(line);
+    return status;
 }
 
 
@@ -171,7 +289,7 @@ void bmp24_readPixelData(t_bmp24 *image, FILE *file) {
  */
 void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 
-    uint32_t position = image->header.offset + ((image->height - 1 - y) * image->width + x) * 3;
+    uint32_t position = image->header.offset + bmp24_fileRow(image, y) * bmp24_rowSize(image->width) + x * 3;
 
 
     uint8_t bgr[3];
@@ -183,21 +301,68 @@ void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file) {
 }
 
 
+/* bmp24_writePixelData
+ * Rôle : Écrit tous les pixels, ligne par ligne dans l'ordre du fichier,
+ *        padding compris
+ */
+void bmp24_writePixelData(t_bmp24 *image, FILE *file) {
+    uint32_t rowSize = bmp24_rowSize(image->width);
+    uint8_t *line = (uint8_t *)calloc(rowSize, 1);
+    if (line == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour l'écriture\n");
+        return;
+    }
 
+    fseek(file, image->header.offset, SEEK_SET);
+    for (int i = 0; i < image->height; i++) {
+        bmp24_encodeRow(image->data[bmp24_fileRow(image, i)], line, image->width);
 
-
-
-void bmp24_writePixelData(t_bmp24 *image, FILE *file) {
-    for (int y = 0; y < image->height; y++) {
-        for (int x = 0; x < image->width; x++) {
-            bmp24_writePixelValue(image, x, y, file);
+        if (fwrite(line, 1, rowSize, file) != rowSize) {
+            printf("Erreur: Impossible d'écrire les données de l'image\n");
+            break;
         }
     }
+
+    free(line);
 }
 
 
 
 
+/* bmp24_checkHeaders
+ * Rôle : Vérifie les en-têtes lus d'un fichier 24 bits et en tire les
+ *        dimensions (hauteur négative : lignes rangées de haut en bas)
+ */
+int bmp24_checkHeaders(const t_bmp_header *header, const t_bmp_info *info, int *width, int *height, int *topDown) {
+    if (header->type != BMP_TYPE) {
+        printf("Erreur: Le fichier n'est pas au format BMP\n");
+        return -1;
+    }
+
+    if (info->bits != 24) {
+        printf("Cette image ne fait pas 24 bits");
+        return -1;
+    }
+
+    if (info->compression != BMP_BI_RGB) {
+        printf("Erreur: Les images 24 bits compressées ne sont pas supportées\n");
+        return -1;
+    }
+
+    *width = info->width;
+    *height = info->height;
+    *topDown = (*height < 0);
+    if (*topDown) {
+        *height = -*height;
+    }
+    if (*width <= 0 || *height <= 0) {
+        printf("Erreur: Dimensions invalides\n");
+        return -1;
+    }
+    return 0;
+}
+
+
 t_bmp24 *bmp24_loadImage(const char *filename) {
     FILE *file = fopen(filename, "rb");
 
@@ -215,24 +380,13 @@ t_bmp24 *bmp24_loadImage(const char *filename) {
     file_rawRead(0, &header, sizeof(t_bmp_header), 1, file);
     file_rawRead(sizeof(t_bmp_header), &header_info, sizeof(t_bmp_info), 1, file);
 
-    if (header.type != 0x4D42) {  // "BM" en hexadécimal
-        printf("Erreur: Le fichier n'est pas au format BMP\n");
-        fclose(file);
-        return NULL;
-    }
-
-
-    int width = header_info.width;
-    int height = header_info.height;
-    int colorDepth = header_info.bits;
-
-    if (colorDepth != 24) {
-        printf("Cette image ne fait pas 24 bits");
+    int width, height, topDown;
+    if (bmp24_checkHeaders(&header, &header_info, &width, &height, &topDown) != 0) {
         fclose(file);
         return NULL;
     }
 
-    t_bmp24 *image = bmp24_allocate(width, height, colorDepth);
+    t_bmp24 *image = bmp24_allocate(width, height, DEFAULT_DEPTH);
     if (image == NULL) {
         fclose(file);
         return NULL;
@@ -241,20 +395,111 @@ t_bmp24 *bmp24_loadImage(const char *filename) {
     // Set headers
     image->header = header;
     image->header_info = header_info;
+    image->topDown = topDown;
 
     // Read pixel data
-    bmp24_readPixelData(image, file);
+    if (bmp24_readPixelData(image, file) != 0) {
+        bmp24_free(image);
+        fclose(file);
+        return NULL;
+    }
 
     fclose(file);
     return image;
 }
 
 
+/* bmp24_decodeHeaders
+ * Rôle : Lit et vérifie les en-têtes d'un fichier 24 bits en mémoire
+ */
+int bmp24_decodeHeaders(const uint8_t *file, size_t size, t_bmp24 *img) {
+    if (size < HEADER_SIZE + INFO_SIZE) {
+        printf("Erreur: Le fichier n'est pas au format BMP\n");
+        return -1;
+    }
+    memcpy(&img->header, file, sizeof(t_bmp_header));
+    memcpy(&img->header_info, file + HEADER_SIZE, sizeof(t_bmp_info));
+
+    if (bmp24_checkHeaders(&img->header, &img->header_info, &img->width, &img->height, &img->topDown) != 0) {
+        return -1;
+    }
+    img->colorDepth = DEFAULT_DEPTH;
+
+    // Le padding de la dernière ligne est parfois absent
+    size_t offset = img->header.offset;
+    if (offset > size ||
+        size - offset < (size_t)bmp24_rowSize(img->width) * (img->height - 1) + (size_t)img->width * 3) {
+        printf("Erreur: Données de l'image incomplètes\n");
+        return -1;
+    }
+    return 0;
+}
 
 
+/* bmp24_decodePixels
+ * Rôle : Range les pixels d'un fichier en mémoire dans img->data, comme
+ *        bmp24_readPixelData
+ */
+void bmp24_decodePixels(const uint8_t *file, t_bmp24 *img) {
+    uint32_t rowSize = bmp24_rowSize(img->width);
+    const uint8_t *pixels = file + img->header.offset;
+    for (int i = 0; i < img->height; i++) {
+        bmp24_decodeRow(pixels + (size_t)i * rowSize, img->data[bmp24_fileRow(img, i)], img->width);
+    }
+}
 
 
 
+
+
+
+
+/* bmp24_prepareHeaders
+ * Rôle : Met les en-têtes en accord avec l'image : 24 bits non compressé,
+ *        pixels juste après les 54 octets d'en-tête, signe de la hauteur
+ *        selon topDown
+ */
+void bmp24_prepareHeaders(t_bmp24 *img) {
+    uint32_t dataSize = bmp24_rowSize(img->width) * img->height;
+    img->header.type = BMP_TYPE;
+    img->header.offset = HEADER_SIZE + INFO_SIZE;
+    img->header.size = img->header.offset + dataSize;
+    img->header_info.size = INFO_SIZE;
+    img->header_info.width = img->width;
+    img->header_info.height = img->topDown ? -img->height : img->height;
+    img->header_info.planes = 1;
+    img->header_info.bits = DEFAULT_DEPTH;
+    img->header_info.compression = BMP_BI_RGB;
+    img->header_info.imageSize = dataSize;
+}
+
+
+/* bmp24_encodedSize
+ * Rôle : Taille du fichier BMP d'une image (en-têtes et lignes avec padding)
+ */
+size_t bmp24_encodedSize(const t_bmp24 *img) {
+    return HEADER_SIZE + INFO_SIZE + (size_t)bmp24_rowSize(img->width) * img->height;
+}
+
+
+/* bmp24_encode
+ * Rôle : Écrit l'image au format BMP en mémoire, comme bmp24_saveImage
+ */
+void bmp24_encode(t_bmp24 *img, uint8_t *file) {
+    bmp24_prepareHeaders(img);
+    memcpy(file, &img->header, sizeof(t_bmp_header));
+    memcpy(file + HEADER_SIZE, &img->header_info, sizeof(t_bmp_info));
+
+    uint32_t rowSize = bmp24_rowSize(img->width);
+    uint32_t padding = rowSize - 3 * (uint32_t)img->width;
+    for (int i = 0; i < img->height; i++) {
+        uint8_t *line = file + img->header.offset + (size_t)i * rowSize;
+        bmp24_encodeRow(img->data[bmp24_fileRow(img, i)], line, img->width);
+        memset(line + 3 * img->width, 0, padding);
+    }
+}
+
+
 void bmp24_saveImage(t_bmp24 *img, const char *filename) {
     if (img == NULL) {
         printf("Erreur: Image invalide\n");
@@ -267,6 +512,8 @@ void bmp24_saveImage(t_bmp24 *img, const char *filename) {
         return;
     }
 
+    bmp24_prepareHeaders(img);
+
 
     file_rawWrite(BITMAP_MAGIC, &img->header, sizeof(t_bmp_header), 1, file);
     file_rawWrite(HEADER_SIZE, &img->header_info, sizeof(t_bmp_info), 1, file);
@@ -283,6 +530,23 @@ void bmp24_saveImage(t_bmp24 *img, const char *filename) {
 
 
 
+void bmp24_setTopDown(t_bmp24 *img, int topDown) {
+    if (img == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    // Seul l'ordre d'écriture change : en mémoire data[0] reste la ligne du haut
+    img->topDown = (topDown != 0);
+    img->header_info.height = img->topDown ? -img->height : img->height;
+}
+
+
+
+
+
+
+
 void bmp24_negative(t_bmp24 *img) {
     if (img == NULL || img->data == NULL) {
         printf("Erreur: Image invalide\n");
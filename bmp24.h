@@ -85,7 +85,8 @@ typedef struct {
     int width;               // Largeur en pixels
     int height;              // Hauteur en pixels
     int colorDepth;          // Profondeur de couleur (24)
-    t_pixel **data;          // Tableau 2D des pixels
+    t_pixel **data;          // Tableau 2D des pixels (data[0] = ligne du haut)
+    int topDown;             // Ordre des lignes dans le fichier (1 : de haut en bas, hauteur négative)
 } t_bmp24;
 
 /* Déclarations des fonctions - groupées par catégorie */
@@ -95,6 +96,7 @@ t_pixel **bmp24_allocateDataPixels(int width, int height);
 void bmp24_freeDataPixels(t_pixel **pixels, int height);
 t_bmp24 *bmp24_allocate(int width, int height, int colorDepth);
 void bmp24_free(t_bmp24 *img);
+uint8_t **bmp24_getRows(t_bmp24 *img); // Lignes en octets entrelacés (à libérer avec free)
 
 /* Lecture/Écriture de fichiers */
 /* file_rawRead
@@ -114,11 +116,22 @@ void file_rawRead(uint32_t position, void *buffer, uint32_t size, size_t n, FILE
 void file_rawWrite(uint32_t position, void *buffer, uint32_t size, size_t n, FILE *file);
 
 /* Manipulation des pixels */
+/* bmp24_rowSize
+ * Rôle : Taille d'une ligne dans le fichier (3 octets par pixel, alignée sur 4)
+ */
+uint32_t bmp24_rowSize(int width);
 void bmp24_readPixelValue(t_bmp24 *image, int x, int y, FILE *file);
-void bmp24_readPixelData(t_bmp24 *image, FILE *file);
+int bmp24_readPixelData(t_bmp24 *image, FILE *file);
 void bmp24_writePixelValue(t_bmp24 *image, int x, int y, FILE *file);
 void bmp24_writePixelData(t_bmp24 *image, FILE *file);
 
+/* bmp24_decodeRow / bmp24_encodeRow
+ * Rôle : Passe d'une ligne du fichier (B, G, R par pixel, sans padding) à
+ *        une ligne de pixels et inversement
+ */
+void bmp24_decodeRow(const uint8_t *line, t_pixel *row, int width);
+void bmp24_encodeRow(const t_pixel *row, uint8_t *line, int width);
+
 /* Chargement et sauvegarde */
 /* FONCTIONS PRINCIPALES */
 
@@ -128,17 +141,77 @@ void bmp24_writePixelData(t_bmp24 *image, FILE *file);
  *   filename - Chemin du fichier à charger
  * Retour : Structure image ou NULL si erreur
  * Vérifie : Format 24 bits, existence fichier
+ * Note : Les lignes sont lues d'un trait dans l'ordre du fichier (hauteur
+ *        négative : de haut en bas) et rangées directement à leur place
  */
 t_bmp24 *bmp24_loadImage(const char *filename);
 
+/* bmp24_checkHeaders
+ * Rôle : Vérifie les en-têtes d'un fichier (signature, 24 bits, non compressé)
+ * Paramètres :
+ *   header, info    - En-têtes lus du fichier
+ *   width, height   - Reçoivent les dimensions (hauteur positive)
+ *   topDown         - Reçoit 1 si la hauteur du fichier est négative
+ * Retour : 0 si l'image est lisible, -1 sinon (message affiché)
+ */
+int bmp24_checkHeaders(const t_bmp_header *header, const t_bmp_info *info, int *width, int *height, int *topDown);
+
+/* bmp24_decodeHeaders
+ * Rôle : Lit les en-têtes d'un fichier 24 bits déjà en mémoire, comme
+ *        bmp24_loadImage
+ * Paramètres :
+ *   file - Contenu du fichier
+ *   size - Taille du fichier en octets
+ *   img  - Reçoit les en-têtes, les dimensions et topDown (data n'est pas touché)
+ * Retour : 0 si réussi, -1 si le fichier est invalide ou trop court
+ */
+int bmp24_decodeHeaders(const uint8_t *file, size_t size, t_bmp24 *img);
+
+/* bmp24_decodePixels
+ * Rôle : Range les pixels d'un fichier en mémoire dans img->data (alloué
+ *        aux dimensions lues par bmp24_decodeHeaders)
+ */
+void bmp24_decodePixels(const uint8_t *file, t_bmp24 *img);
+
 /* bmp24_saveImage
  * Rôle : Sauvegarde une image en BMP
  * Paramètres :
  *   img      - Image à sauvegarder
  *   filename - Nom du fichier destination
+ * Note : Les lignes sont écrites d'un trait dans l'ordre choisi par topDown
  */
 void bmp24_saveImage(t_bmp24 *img, const char *filename);
 
+/* bmp24_prepareHeaders
+ * Rôle : Met les en-têtes en accord avec l'image avant l'écriture
+ *        (24 bits non compressé, signe de la hauteur selon topDown)
+ */
+void bmp24_prepareHeaders(t_bmp24 *img);
+
+/* bmp24_encodedSize
+ * Rôle : Taille du fichier BMP de l'image, en-têtes compris
+ */
+size_t bmp24_encodedSize(const t_bmp24 *img);
+
+/* bmp24_encode
+ * Rôle : Écrit l'image au format BMP en mémoire, octet pour octet comme
+ *        bmp24_saveImage
+ * Paramètres :
+ *   img  - Image à écrire (en-têtes mis à jour)
+ *   file - Destination de bmp24_encodedSize(img) octets
+ */
+void bmp24_encode(t_bmp24 *img, uint8_t *file);
+
+/* bmp24_setTopDown
+ * Rôle : Choisit l'ordre des lignes du fichier enregistré
+ * Paramètres :
+ *   img     - Image concernée
+ *   topDown - 1 : de haut en bas (hauteur négative), écriture dans l'ordre
+ *             de production des lignes ; 0 : de bas en haut (BMP classique)
+ * Note : Les pixels en mémoire ne bougent pas
+ */
+void bmp24_setTopDown(t_bmp24 *img, int topDown);
+
 /* Effets de base */
 /* bmp24_negative
  * Rôle : Inverse les couleurs de l'image
@@ -162,6 +235,15 @@ void bmp24_grayscale(t_bmp24 *img); // Convertit en niveaux de gris
  */
 void bmp24_brightness(t_bmp24 *img, int value); // Ajuste la luminosité
 
+/* bmp24_lumaRow
+ * Rôle : Calcule la luminance (niveau de gris perçu) d'une ligne de pixels
+ * Paramètres :
+ *   row   - Ligne source
+ *   luma  - Tableau de sortie de width octets
+ *   width - Nombre de pixels de la ligne
+ */
+void bmp24_lumaRow(const t_pixel *row, uint8_t *luma, int width);
+
 /* Effets avancés utilisant des filtres */
 void bmp24_boxBlur(t_bmp24 *img);      // Flou simple
 void bmp24_gaussianBlur(t_bmp24 *img);  // Flou gaussien
@@ -0,0 +1,508 @@
+/**
+ * @file bmp32.c
+ *
+ * @brief
+ * Images 32 bits BGRA. Le chargement lit le fichier ligne par ligne : les
+ * lignes déjà en BGRA sont recopiées telles quelles, les autres masques
+ * (BI_BITFIELDS) et les lignes 24 bits sont convertis au passage, sans
+ * image intermédiaire. Les traitements ponctuels travaillent sur des mots
+ * de 32 bits (SSE2 : 4 pixels par registre, avec un masque qui laisse
+ * l'octet alpha intact) et sont répartis par bandes de lignes.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp32.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+_Static_assert(sizeof(t_pixel32) == 4, "t_pixel32 doit faire 4 octets");
+
+#define BMP32_GRAIN 64
+#define BMP32_INFO_V3_SIZE 56 // En-tête + 4 masques (R, G, B, A)
+#define BMP32_BI_ALPHABITFIELDS 6
+
+/* Masques standard BGRA (octets B, G, R, A dans le fichier) */
+#define BMP32_MASK_RED   0x00FF0000u
+#define BMP32_MASK_GREEN 0x0000FF00u
+#define BMP32_MASK_BLUE  0x000000FFu
+#define BMP32_MASK_ALPHA 0xFF000000u
+
+typedef enum {
+    BMP32_OP_NEGATIVE,
+    BMP32_OP_GRAYSCALE,
+    BMP32_OP_BRIGHTNESS,
+    BMP32_OP_LUT
+} t_bmp32_op;
+
+typedef struct {
+    t_bmp32 *img;
+    t_bmp32_op op;
+    int value;
+    const uint8_t (*luts)[256];
+} t_bmp32_point_pass;
+
+/*
+ * Extraction d'une composante à partir d'un masque quelconque
+ */
+typedef struct {
+    uint32_t mask;
+    int shift;      // Position du premier bit du masque
+    int bits;       // Nombre de bits du masque
+} t_bmp32_channel;
+
+
+static uint32_t bmp32_readLE32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static void bmp32_writeLE32(uint8_t *p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+
+static t_bmp32_channel bmp32_channel(uint32_t mask) {
+    t_bmp32_channel c = {mask, 0, 0};
+    if (mask != 0) {
+        while (((mask >> c.shift) & 1) == 0) {
+            c.shift++;
+        }
+        while (c.shift + c.bits < 32 && ((mask >> (c.shift + c.bits)) & 1) != 0) {
+            c.bits++;
+        }
+    }
+    return c;
+}
+
+
+/* Valeur de la composante ramenée sur 8 bits (0 pour un masque vide) */
+static inline uint8_t bmp32_extract(uint32_t word, const t_bmp32_channel *c) {
+    if (c->bits == 0) {
+        return 0;
+    }
+    uint32_t v = (word & c->mask) >> c->shift;
+    if (c->bits >= 8) {
+        return (uint8_t)(v >> (c->bits - 8));
+    }
+    return (uint8_t)(v * 255 / ((1u << c->bits) - 1));
+}
+
+
+t_bmp32 *bmp32_allocate(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        printf("Erreur: Dimensions invalides\n");
+        return NULL;
+    }
+
+    t_bmp32 *img = (t_bmp32 *)malloc(sizeof(t_bmp32));
+    t_pixel32 **rows = (t_pixel32 **)malloc(height * sizeof(t_pixel32 *));
+    t_pixel32 *block = (t_pixel32 *)malloc((size_t)width * height * sizeof(t_pixel32));
+    if (img == NULL || rows == NULL || block == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour l'image\n");
+        free(img);
+        free(rows);
+        free(block);
+        return NULL;
+    }
+
+    // Noir opaque
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        block[i] = (t_pixel32){0, 0, 0, 255};
+    }
+    for (int y = 0; y < height; y++) {
+        rows[y] = block + (size_t)y * width;
+    }
+
+    img->width = width;
+    img->height = height;
+    img->data = rows;
+    img->topDown = 0;
+
+    // En-têtes par défaut (complétés à l'enregistrement)
+    memset(&img->header, 0, sizeof(t_bmp_header));
+    memset(&img->header_info, 0, sizeof(t_bmp_info));
+    img->header.type = BMP_TYPE;
+    img->header_info.size = INFO_SIZE;
+    img->header_info.width = width;
+    img->header_info.height = height;
+    img->header_info.planes = 1;
+    img->header_info.bits = 32;
+    img->header_info.xPixelsPerMeter = 2835;
+    img->header_info.yPixelsPerMeter = 2835;
+    return img;
+}
+
+
+void bmp32_free(t_bmp32 *img) {
+    if (img == NULL) {
+        return;
+    }
+    if (img->data != NULL) {
+        free(img->data[0]);
+        free(img->data);
+    }
+    free(img);
+}
+
+
+uint8_t **bmp32_getRows(t_bmp32 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    uint8_t **rows = (uint8_t **)malloc(img->height * sizeof(uint8_t *));
+    if (rows == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour les lignes\n");
+        return NULL;
+    }
+    for (int y = 0; y < img->height; y++) {
+        rows[y] = (uint8_t *)img->data[y];
+    }
+    return rows;
+}
+
+
+/* Convertit une ligne du fichier en pixels BGRA */
+static void bmp32_decodeRow(const uint8_t *src, t_pixel32 *dst, int width, int bits,
+                            int standard, const t_bmp32_channel channels[4]) {
+    if (bits == 24) {
+        for (int x = 0; x < width; x++) {
+            dst[x] = (t_pixel32){src[3 * x], src[3 * x + 1], src[3 * x + 2], 255};
+        }
+    } else if (standard) {
+        memcpy(dst, src, (size_t)width * 4);
+    } else {
+        for (int x = 0; x < width; x++) {
+            uint32_t word = bmp32_readLE32(src + 4 * x);
+            dst[x].red = bmp32_extract(word, &channels[0]);
+            dst[x].green = bmp32_extract(word, &channels[1]);
+            dst[x].blue = bmp32_extract(word, &channels[2]);
+            dst[x].alpha = (channels[3].mask != 0) ? bmp32_extract(word, &channels[3]) : 255;
+        }
+    }
+}
+
+
+t_bmp32 *bmp32_loadImage(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        printf("Erreur lors de l'ouverture du fichier!\n");
+        return NULL;
+    }
+
+    t_bmp_header header;
+    t_bmp_info info;
+    uint8_t masks[16] = {0};
+    if (fread(&header, sizeof(t_bmp_header), 1, file) != 1 ||
+        fread(&info, sizeof(t_bmp_info), 1, file) != 1 || header.type != BMP_TYPE) {
+        printf("Erreur: Le fichier n'est pas au format BMP\n");
+        fclose(file);
+        return NULL;
+    }
+
+    int bits = info.bits;
+    int bitfields = (info.compression == BMP_BI_BITFIELDS || info.compression == BMP32_BI_ALPHABITFIELDS);
+    if (!((bits == 24 && info.compression == BMP_BI_RGB) ||
+          (bits == 32 && (info.compression == BMP_BI_RGB || bitfields)))) {
+        printf("Erreur: L'image n'est pas en 24 ou 32 bits non compressé\n");
+        fclose(file);
+        return NULL;
+    }
+
+    // Masques R, G, B (et A si l'en-tête est assez grand) à la suite des 40 octets
+    uint32_t red = BMP32_MASK_RED, green = BMP32_MASK_GREEN, blue = BMP32_MASK_BLUE;
+    uint32_t alpha = BMP32_MASK_ALPHA;
+    if (bitfields) {
+        int count = (info.size >= BMP32_INFO_V3_SIZE || info.compression == BMP32_BI_ALPHABITFIELDS) ? 4 : 3;
+        if (fread(masks, 4, count, file) != (size_t)count) {
+            printf("Erreur: Masques de couleur illisibles\n");
+            fclose(file);
+            return NULL;
+        }
+        red = bmp32_readLE32(masks);
+        green = bmp32_readLE32(masks + 4);
+        blue = bmp32_readLE32(masks + 8);
+        alpha = bmp32_readLE32(masks + 12);
+        // Seul le masque alpha peut être vide (pas de transparence)
+        if (red == 0 || green == 0 || blue == 0) {
+            printf("Erreur: Masque de couleur vide\n");
+            fclose(file);
+            return NULL;
+        }
+    }
+    int standard = (red == BMP32_MASK_RED && green == BMP32_MASK_GREEN &&
+                    blue == BMP32_MASK_BLUE && alpha == BMP32_MASK_ALPHA);
+    t_bmp32_channel channels[4] = {bmp32_channel(red), bmp32_channel(green),
+                                   bmp32_channel(blue), bmp32_channel(alpha)};
+
+    int width = info.width;
+    int height = (info.height < 0) ? -info.height : info.height;
+    int topDown = (info.height < 0);
+    size_t fileStride = (bits == 32) ? (size_t)width * 4 : (((size_t)width * 3 + 3) & ~(size_t)3);
+
+    t_bmp32 *img = bmp32_allocate(width, height);
+    uint8_t *line = (uint8_t *)malloc(fileStride > 0 ? fileStride : 1);
+    if (img == NULL || line == NULL || fseek(file, header.offset, SEEK_SET) != 0) {
+        printf("Erreur: Impossible de charger l'image\n");
+        bmp32_free(img);
+        free(line);
+        fclose(file);
+        return NULL;
+    }
+
+    // Lignes du fichier de bas en haut, sauf hauteur négative
+    for (int i = 0; i < height; i++) {
+        int y = topDown ? i : height - 1 - i;
+        if (fread(line, 1, fileStride, file) != fileStride) {
+            printf("Erreur: Impossible de lire les données de l'image\n");
+            bmp32_free(img);
+            free(line);
+            fclose(file);
+            return NULL;
+        }
+        bmp32_decodeRow(line, img->data[y], width, bits, standard, channels);
+    }
+    free(line);
+    fclose(file);
+
+    // En BI_RGB l'octet alpha est souvent laissé à 0 : l'image est alors opaque
+    if (bits == 32 && !bitfields) {
+        size_t count = (size_t)width * height;
+        size_t i = 0;
+        while (i < count && img->data[0][i].alpha == 0) {
+            i++;
+        }
+        if (i == count) {
+            for (i = 0; i < count; i++) {
+                img->data[0][i].alpha = 255;
+            }
+        }
+    }
+
+    img->header = header;
+    img->header_info = info;
+    img->topDown = topDown;
+    return img;
+}
+
+
+int bmp32_saveImage(t_bmp32 *img, const char *filename) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("Erreur: Impossible de créer le fichier %s\n", filename);
+        return -1;
+    }
+
+    uint32_t dataSize = (uint32_t)img->width * img->height * 4;
+    t_bmp_header header = img->header;
+    t_bmp_info info = img->header_info;
+    header.type = BMP_TYPE;
+    header.offset = HEADER_SIZE + BMP32_INFO_V3_SIZE;
+    header.size = header.offset + dataSize;
+    info.size = BMP32_INFO_V3_SIZE;
+    info.width = img->width;
+    info.height = img->topDown ? -img->height : img->height;
+    info.planes = 1;
+    info.bits = 32;
+    info.compression = BMP_BI_BITFIELDS;
+    info.imageSize = dataSize;
+    info.colorsUsed = 0;
+    info.importantColors = 0;
+
+    uint8_t masks[16];
+    bmp32_writeLE32(masks, BMP32_MASK_RED);
+    bmp32_writeLE32(masks + 4, BMP32_MASK_GREEN);
+    bmp32_writeLE32(masks + 8, BMP32_MASK_BLUE);
+    bmp32_writeLE32(masks + 12, BMP32_MASK_ALPHA);
+
+    int status = 0;
+    if (fwrite(&header, sizeof(t_bmp_header), 1, file) != 1 ||
+        fwrite(&info, sizeof(t_bmp_info), 1, file) != 1 ||
+        fwrite(masks, 1, sizeof(masks), file) != sizeof(masks)) {
+        status = -1;
+    }
+
+    // Lignes dans l'ordre du fichier, déjà alignées sur 4 octets
+    for (int i = 0; status == 0 && i < img->height; i++) {
+        int y = img->topDown ? i : img->height - 1 - i;
+        if (fwrite(img->data[y], sizeof(t_pixel32), img->width, file) != (size_t)img->width) {
+            status = -1;
+        }
+    }
+
+    if (fclose(file) != 0) {
+        status = -1;
+    }
+    if (status != 0) {
+        printf("Erreur: Impossible d'écrire le fichier %s\n", filename);
+    }
+    return status;
+}
+
+
+void bmp32_setTopDown(t_bmp32 *img, int topDown) {
+    if (img == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+    img->topDown = (topDown != 0);
+}
+
+
+t_bmp32 *bmp24_toBmp32(t_bmp24 *img, uint8_t alpha) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    t_bmp32 *result = bmp32_allocate(img->width, img->height);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int y = 0; y < img->height; y++) {
+        const t_pixel *src = img->data[y];
+        t_pixel32 *dst = result->data[y];
+        for (int x = 0; x < img->width; x++) {
+            dst[x] = (t_pixel32){src[x].blue, src[x].green, src[x].red, alpha};
+        }
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
+
+
+t_bmp24 *bmp32_toBmp24(t_bmp32 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    t_bmp24 *result = bmp24_allocate(img->width, img->height, DEFAULT_DEPTH);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int y = 0; y < img->height; y++) {
+        const t_pixel32 *src = img->data[y];
+        t_pixel *dst = result->data[y];
+        for (int x = 0; x < img->width; x++) {
+            dst[x] = (t_pixel){src[x].red, src[x].green, src[x].blue};
+        }
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
+
+
+static void bmp32_pointBand(void *arg, int begin, int end) {
+    const t_bmp32_point_pass *pass = (const t_bmp32_point_pass *)arg;
+    int width = pass->img->width;
+
+    // Valeur ajoutée ou retirée à B, G, R (octet alpha à 0)
+    int amount = (pass->value < 0) ? -pass->value : pass->value;
+    if (amount > 255) {
+        amount = 255;
+    }
+    uint32_t delta = (uint32_t)amount * 0x010101u;
+
+    for (int y = begin; y < end; y++) {
+        t_pixel32 *row = pass->img->data[y];
+        int x = 0;
+
+#ifdef __SSE2__
+        if (pass->op == BMP32_OP_NEGATIVE || pass->op == BMP32_OP_BRIGHTNESS) {
+            __m128i color = _mm_set1_epi32(0x00FFFFFF);
+            __m128i d = _mm_set1_epi32((int)delta);
+            for (; x + 4 <= width; x += 4) {
+                __m128i p = _mm_loadu_si128((const __m128i *)(row + x));
+                if (pass->op == BMP32_OP_NEGATIVE) {
+                    p = _mm_xor_si128(p, color);
+                } else if (pass->value >= 0) {
+                    p = _mm_adds_epu8(p, d);
+                } else {
+                    p = _mm_subs_epu8(p, d);
+                }
+                _mm_storeu_si128((__m128i *)(row + x), p);
+            }
+        }
+#endif
+
+        for (; x < width; x++) {
+            t_pixel32 *p = &row[x];
+            if (pass->op == BMP32_OP_NEGATIVE) {
+                p->red = 255 - p->red;
+                p->green = 255 - p->green;
+                p->blue = 255 - p->blue;
+            } else if (pass->op == BMP32_OP_GRAYSCALE) {
+                uint8_t gray = (uint8_t)((p->red + p->green + p->blue) / 3);
+                p->red = p->green = p->blue = gray;
+            } else if (pass->op == BMP32_OP_BRIGHTNESS) {
+                int r = p->red + pass->value, g = p->green + pass->value, b = p->blue + pass->value;
+                p->red = (uint8_t)((r > 255) ? 255 : ((r < 0) ? 0 : r));
+                p->green = (uint8_t)((g > 255) ? 255 : ((g < 0) ? 0 : g));
+                p->blue = (uint8_t)((b > 255) ? 255 : ((b < 0) ? 0 : b));
+            } else {
+                p->red = pass->luts[0][p->red];
+                p->green = pass->luts[1][p->green];
+                p->blue = pass->luts[2][p->blue];
+            }
+        }
+    }
+}
+
+
+static int bmp32_point(t_bmp32 *img, t_bmp32_op op, int value, const uint8_t (*luts)[256]) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    t_bmp32_point_pass pass = {img, op, value, luts};
+    bmp_parallelFor(img->height, BMP32_GRAIN, bmp32_pointBand, &pass);
+    return 0;
+}
+
+
+void bmp32_negative(t_bmp32 *img) {
+    bmp32_point(img, BMP32_OP_NEGATIVE, 0, NULL);
+}
+
+
+void bmp32_grayscale(t_bmp32 *img) {
+    bmp32_point(img, BMP32_OP_GRAYSCALE, 0, NULL);
+}
+
+
+void bmp32_brightness(t_bmp32 *img, int value) {
+    bmp32_point(img, BMP32_OP_BRIGHTNESS, value, NULL);
+}
+
+
+int bmp32_applyLut(t_bmp32 *img, const uint8_t luts[3][256]) {
+    if (luts == NULL) {
+        printf("Erreur: Table de correspondance invalide\n");
+        return -1;
+    }
+    return bmp32_point(img, BMP32_OP_LUT, 0, luts);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file bmp32.h
+ *
+ * @brief
+ * Images BMP 32 bits (BGRA) : quatre octets par pixel, dans l'ordre du
+ * fichier. Chaque pixel tient dans un mot de 32 bits aligné, ce qui
+ * simplifie les traitements vectoriels, et la transparence (alpha) est
+ * conservée par les traitements. Les images 24 bits peuvent aussi être
+ * chargées ou converties dans ce format.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMP32_H
+#define BMP32_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+/*
+ * Pixel 32 bits, même ordre que dans le fichier
+ */
+typedef struct {
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+    uint8_t alpha;  // 0 : transparent, 255 : opaque
+} t_pixel32;
+
+/*
+ * Image 32 bits. Comme t_bmp24, les lignes sont rangées de haut en bas
+ * dans un seul bloc (data[0]), sans padding (une ligne = width * 4 octets).
+ */
+typedef struct {
+    t_bmp_header header;      // En-tête du fichier
+    t_bmp_info header_info;   // Informations sur l'image (résolution...)
+    int width;
+    int height;
+    t_pixel32 **data;         // data[0] = ligne du haut
+    int topDown;              // Ordre des lignes dans le fichier (1 : de haut en bas)
+} t_bmp32;
+
+/* Gestion de la mémoire */
+t_bmp32 *bmp32_allocate(int width, int height);   // Pixels noirs opaques, NULL si erreur
+void bmp32_free(t_bmp32 *img);
+uint8_t **bmp32_getRows(t_bmp32 *img);           // Lignes en octets (4 par pixel), à libérer avec free
+
+/* bmp32_loadImage
+ * Rôle : Charge une image BMP 32 bits (BI_RGB ou BI_BITFIELDS) ou 24 bits
+ * Paramètre :
+ *   filename - Chemin du fichier à charger
+ * Retour : Image chargée, NULL si erreur
+ * Note : Les masques de couleur quelconques sont ramenés à BGRA ; sans
+ *        masque alpha, ou si tous les alpha valent 0 en BI_RGB, l'image
+ *        est opaque. Une image 24 bits est lue directement avec alpha 255.
+ */
+t_bmp32 *bmp32_loadImage(const char *filename);
+
+/* bmp32_saveImage
+ * Rôle : Enregistre l'image en 32 bits BI_BITFIELDS avec masque alpha,
+ *        lignes dans l'ordre choisi par topDown
+ * Paramètres :
+ *   img      - Image à sauvegarder
+ *   filename - Nom du fichier destination
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp32_saveImage(t_bmp32 *img, const char *filename);
+
+/* bmp32_setTopDown
+ * Rôle : Choisit l'ordre des lignes du fichier enregistré (comme bmp24_setTopDown)
+ */
+void bmp32_setTopDown(t_bmp32 *img, int topDown);
+
+/* bmp24_toBmp32
+ * Rôle : Copie une image 24 bits en 32 bits (alpha donné à tous les pixels)
+ * Retour : Nouvelle image, NULL si erreur
+ */
+t_bmp32 *bmp24_toBmp32(t_bmp24 *img, uint8_t alpha);
+
+/* bmp32_toBmp24
+ * Rôle : Copie une image 32 bits en 24 bits (la transparence est perdue)
+ * Retour : Nouvelle image, NULL si erreur
+ */
+t_bmp24 *bmp32_toBmp24(t_bmp32 *img);
+
+/* Traitements ponctuels : la couleur change, alpha est conservé */
+void bmp32_negative(t_bmp32 *img);
+void bmp32_grayscale(t_bmp32 *img);              // Moyenne des composantes RGB
+void bmp32_brightness(t_bmp32 *img, int value);  // Ajustement (-255 à +255)
+
+/* bmp32_applyLut
+ * Rôle : Applique une table par composante (luts[0] rouge, luts[1] vert,
+ *        luts[2] bleu), alpha inchangé
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp32_applyLut(t_bmp32 *img, const uint8_t luts[3][256]);
+
+#endif
@@ -15,15 +15,212 @@
 #include <string.h>
 #include <stdio.h>
 #include "bmp8.h"
+#include "bmprle.h"
 
+// Le champ taille du fichier (4 octets) doit pouvoir contenir en-tête, palette et pixels
+#define BMP8_MAX_DATA_SIZE ((size_t)UINT32_MAX - BMP_HEADER_SIZE - BMP_COLOR_TABLE_SIZE)
+
+
+/*
+ * Écrit un champ little-endian de l'en-tête (2 ou 4 octets)
+ */
+static void bmp8_setHeaderField(unsigned char *header, int offset, uint32_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        header[offset + i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+/*
+ * Lit un champ little-endian de l'en-tête (2 ou 4 octets)
+ */
+static uint32_t bmp8_getHeaderField(const unsigned char *header, int offset, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint32_t)header[offset + i] << (8 * i);
+    }
+    return value;
+}
+
+/*
+ * Lit l'en-tête et la palette d'une image en noir et blanc
+ *
+ * Ce qu'elle fait :
+ * - Vérifie l'en-tête (signature, 8 bits, compression brute ou RLE8) et
+ *   les dimensions, avant toute allocation
+ * - Recopie l'en-tête et la palette, calcule rowPadding et dataSize
+ * - Trouve où commencent les pixels et combien d'octets les décrivent
+ *
+ * Paramètres :
+ * - file : le début du fichier (en-tête et palette au moins)
+ * - available : nombre d'octets de file
+ * - size : taille du fichier entier
+ * - img : l'image à remplir (img->data n'est pas touché)
+ * - offset : position des pixels dans le fichier
+ * - stream : octets à lire à partir de offset (dataSize, ou le flux RLE8)
+ *
+ * Renvoie :
+ * - 1 si les pixels sont compressés en RLE8, 0 s'ils sont bruts
+ * - -1 si il y a eu un problème
+ */
+static int bmp8_decodeHeaders(const unsigned char *file, size_t available, size_t size, t_bmp8 *img,
+                              size_t *offset, size_t *stream) {
+    if (available < BMP_HEADER_SIZE) {
+        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP valide\n");
+        return -1;
+    }
+
+    // Vérification de la signature BMP
+    if (file[0] != 'B' || file[1] != 'M') {
+        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP\n");
+        return -1;
+    }
+    memcpy(img->header, file, BMP_HEADER_SIZE);
+
+    // Extraction des informations de l'image
+    img->width = bmp8_getHeaderField(img->header, 18, 4);
+    int32_t height = (int32_t)bmp8_getHeaderField(img->header, 22, 4);
+    img->topDown = (height < 0);
+    img->height = (uint32_t)(img->topDown ? -height : height);
+    img->colorDepth = (uint16_t)bmp8_getHeaderField(img->header, 28, 2);
+    uint32_t compression = bmp8_getHeaderField(img->header, 30, 4);
+    uint32_t compressedSize = bmp8_getHeaderField(img->header, 34, 4);
+
+    // Vérification que l'image est en 8 bits
+    if (img->colorDepth != 8) {
+        fprintf(stderr, "Erreur: L'image n'est pas en 8 bits\n");
+        return -1;
+    }
+
+    // Seules les données brutes et la compression RLE8 sont gérées
+    if (compression != BMP_BI_RGB && (compression != BMP_BI_RLE8 || img->topDown)) {
+        fprintf(stderr, "Erreur: Compression non supportée (%u)\n", compression);
+        return -1;
+    }
+
+    // Dimensions venues du fichier : vérifiées avant tout calcul de taille
+    if (img->width == 0 || img->width > INT32_MAX || height == 0 || height == INT32_MIN) {
+        fprintf(stderr, "Erreur: Dimensions invalides\n");
+        return -1;
+    }
+
+    // Calcul du padding (à ajouter après width), taille calculée sans débordement
+    img->rowPadding = (4 - (img->width % 4)) % 4;
+    size_t stride = (size_t)img->width + img->rowPadding;
+    if (stride > BMP8_MAX_DATA_SIZE / img->height) {
+        fprintf(stderr, "Erreur: Image trop grande (%u x %u)\n", img->width, img->height);
+        return -1;
+    }
+    img->dataSize = (uint32_t)(stride * img->height);
+
+    // Table de couleurs (colorsUsed entrées, 256 si 0)
+    uint32_t colors = bmp8_getHeaderField(img->header, 46, 4);
+    if (colors == 0 || colors > 256) {
+        colors = 256;
+    }
+    if (available < BMP_HEADER_SIZE + (size_t)colors * 4) {
+        fprintf(stderr, "Erreur: Impossible de lire la table de couleurs\n");
+        return -1;
+    }
+    memset(img->colorTable, 0, BMP_COLOR_TABLE_SIZE);
+    memcpy(img->colorTable, file + BMP_HEADER_SIZE, (size_t)colors * 4);
+
+    // Les pixels commencent à l'offset indiqué dans l'en-tête, sinon juste après la palette
+    *offset = bmp8_getHeaderField(img->header, 10, 4);
+    if (*offset == 0) {
+        *offset = BMP_HEADER_SIZE + (size_t)colors * 4;
+    }
+    if (*offset > size || (compression == BMP_BI_RGB && size - *offset < img->dataSize)) {
+        fprintf(stderr, "Erreur: Impossible de lire les données de l'image\n");
+        return -1;
+    }
+
+    if (compression == BMP_BI_RGB) {
+        *stream = img->dataSize;
+        return 0;
+    }
+    // Taille du flux compressé : champ de l'en-tête, sinon jusqu'à la fin du fichier
+    *stream = (compressedSize == 0 || compressedSize > size - *offset) ? size - *offset : compressedSize;
+    return 1;
+}
+
+/*
+ * Décompresse un flux RLE8 dans img->data (pixels sautés par le flux à 0)
+ */
+static int bmp8_decodeStream(const unsigned char *stream, size_t size, t_bmp8 *img) {
+    memset(img->data, 0, img->dataSize);
+    if (bmp_decodeRLE8(stream, size, img->data, img->width, img->height, img->width + img->rowPadding) != 0) {
+        fprintf(stderr, "Erreur: Données RLE8 invalides\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * En mémoire l'image est toujours brute : l'en-tête est réécrit en
+ * conséquence pour bmp8_encode
+ */
+static void bmp8_rawHeader(t_bmp8 *img) {
+    bmp8_setHeaderField(img->header, 2, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + img->dataSize, 4);
+    bmp8_setHeaderField(img->header, 10, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, 4);
+    bmp8_setHeaderField(img->header, 30, BMP_BI_RGB, 4);
+    bmp8_setHeaderField(img->header, 34, img->dataSize, 4);
+    bmp8_setHeaderField(img->header, 46, 256, 4);
+}
+
+/*
+ * Décode une image en noir et blanc déjà en mémoire (fichier BMP 8 bits entier)
+ *
+ * Ce qu'elle fait :
+ * - Lit l'en-tête et la palette avec bmp8_decodeHeaders
+ * - Range les pixels dans img->data, agrandi si le bloc est trop petit
+ * - Réécrit l'en-tête comme pour une image brute (voir bmp8_encode)
+ *
+ * Paramètres :
+ * - file : le contenu du fichier
+ * - size : sa taille en octets
+ * - img : l'image à remplir (img->data : bloc existant ou NULL)
+ * - capacity : taille du bloc img->data, mise à jour s'il est agrandi
+ *
+ * Renvoie :
+ * - 0 si tout va bien
+ * - -1 si il y a eu un problème
+ */
+int bmp8_decode(const unsigned char *file, size_t size, t_bmp8 *img, size_t *capacity) {
+    size_t offset, stream;
+    int compressed = bmp8_decodeHeaders(file, size, size, img, &offset, &stream);
+    if (compressed < 0) {
+        return -1;
+    }
+
+    if (img->data == NULL || img->dataSize > *capacity) {
+        unsigned char *data = (unsigned char *)realloc(img->data, img->dataSize);
+        if (data == NULL) {
+            perror("Erreur: Allocation mémoire échouée pour les données");
+            return -1;
+        }
+        img->data = data;
+        *capacity = img->dataSize;
+    }
+
+    if (compressed) {
+        if (bmp8_decodeStream(file + offset, stream, img) != 0) {
+            return -1;
+        }
+    } else {
+        memcpy(img->data, file + offset, img->dataSize);
+    }
+
+    bmp8_rawHeader(img);
+    return 0;
+}
 
 /*
  * Charge une image en noir et blanc (format BMP 8 bits)
  * 
  * Ce qu'elle fait :
- * - Ouvre le fichier image
- * - Vérifie que c'est bien une image BMP en noir et blanc
- * - Charge l'image en mémoire
+ * - Lit l'en-tête et la palette (bmp8_decodeHeaders)
+ * - Lit les pixels bruts directement dans img->data ; seul un flux RLE8
+ *   passe par un tampon, à la taille du flux compressé
  * 
  * Paramètre :
  * - filename : le nom du fichier image à ouvrir
@@ -40,92 +237,273 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
         return NULL;
     }
 
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    unsigned char head[BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE];
+    size_t available = 0;
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        available = fread(head, 1, sizeof(head), file);
+    }
+
     t_bmp8 *img = (t_bmp8 *)malloc(sizeof(t_bmp8));
     if (img == NULL) {
         perror("Erreur: Allocation mémoire échouée");
         fclose(file);
         return NULL;
     }
+    img->data = NULL;
 
-    // Lecture de l'en-tête BMP
-    if (fread(img->header, sizeof(unsigned char), 54, file) != 54) {
-        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP valide\n");
-        free(img);
+    size_t offset, stream;
+    int compressed = (size >= 0) ? bmp8_decodeHeaders(head, available, (size_t)size, img, &offset, &stream) : -1;
+    if (compressed < 0) {
         fclose(file);
+        free(img);
         return NULL;
     }
 
-    // Vérification de la signature BMP
-    if (img->header[0] != 'B' || img->header[1] != 'M') {
-        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP\n");
-        free(img);
+    img->data = (unsigned char *)malloc(img->dataSize);
+    unsigned char *buffer = compressed ? (unsigned char *)malloc(stream > 0 ? stream : 1) : img->data;
+    if (img->data == NULL || buffer == NULL) {
+        perror("Erreur: Allocation mémoire échouée pour les données");
+        if (compressed) {
+            free(buffer);
+        }
         fclose(file);
+        bmp8_free(img);
         return NULL;
     }
 
-    // Extraction des informations de l'image
-    img->width = *(unsigned int *)&img->header[18];
-    img->height = *(unsigned int *)&img->header[22];
-    img->colorDepth = *(unsigned short *)&img->header[28];
-    img->dataSize = *(unsigned int *)&img->header[34];
-
-    // Fallback pour dataSize si elle vaut 0
-    if (img->dataSize == 0) {
-        img->dataSize = img->width * img->height;
+    int status = 0;
+    if (fseek(file, (long)offset, SEEK_SET) != 0 || fread(buffer, 1, stream, file) != stream) {
+        fprintf(stderr, "Erreur: Impossible de lire les données de l'image\n");
+        status = -1;
+    } else if (compressed) {
+        status = bmp8_decodeStream(buffer, stream, img);
     }
+    if (compressed) {
+        free(buffer);
+    }
+    fclose(file);
 
-    // Informations de debug
-    printf("DEBUG: Largeur=%u, Hauteur=%u, Profondeur=%u, Taille données=%u\n",
-           img->width, img->height, img->colorDepth, img->dataSize);
-
-    // Vérification que l'image est en 8 bits
-    if (img->colorDepth != 8) {
-        fprintf(stderr, "Erreur: L'image n'est pas en 8 bits\n");
-        free(img);
-        fclose(file);
+    if (status != 0) {
+        bmp8_free(img);
         return NULL;
     }
+    bmp8_rawHeader(img);
+    return img;
+}
 
-	// Calcul du padding (à ajouter après width)
-	int padding = (4 - (img->width % 4)) % 4;
-	img->dataSize = (img->width + padding) * img->height;
+/*
+ * Crée une nouvelle image en niveaux de gris vide (pixels à 0)
+ * 
+ * Ce qu'elle fait :
+ * - Remplit un en-tête BMP 8 bits valide (non compressé)
+ * - Met une palette de gris (0 à 255) dans la table des couleurs
+ * - Alloue les pixels en tenant compte du padding des lignes
+ * 
+ * Paramètres :
+ * - width, height : dimensions de l'image
+ * 
+ * Renvoie :
+ * - La nouvelle image, ou NULL si erreur
+ */
+t_bmp8 *bmp8_allocate(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        fprintf(stderr, "Erreur: Dimensions invalides\n");
+        return NULL;
+    }
 
-    // Lecture de la table de couleurs
-    if (fread(img->colorTable, sizeof(unsigned char), 1024, file) != 1024) {
-        fprintf(stderr, "Erreur: Impossible de lire la table de couleurs\n");
-        free(img);
-        fclose(file);
+    t_bmp8 *img = (t_bmp8 *)malloc(sizeof(t_bmp8));
+    if (img == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
         return NULL;
     }
 
-    // Allocation mémoire pour les données de l'image
-    img->data = (unsigned char *)malloc(img->dataSize * sizeof(unsigned char));
+    img->width = width;
+    img->height = height;
+    img->colorDepth = 8;
+    img->rowPadding = (4 - (width % 4)) % 4;
+    img->dataSize = (width + img->rowPadding) * height;
+    img->topDown = 0;
+
+    img->data = (unsigned char *)calloc(img->dataSize, sizeof(unsigned char));
     if (img->data == NULL) {
         perror("Erreur: Allocation mémoire échouée pour les données");
         free(img);
-        fclose(file);
         return NULL;
     }
 
-    // Lecture des données de l'image
-    if (fread(img->data, sizeof(unsigned char), img->dataSize, file) != img->dataSize) {
-        fprintf(stderr, "Erreur: Impossible de lire les données de l'image\n");
-        free(img->data);
-        free(img);
-        fclose(file);
-        return NULL;
+    // En-tête BMP (14 octets) + BITMAPINFOHEADER (40 octets)
+    memset(img->header, 0, BMP_HEADER_SIZE);
+    img->header[0] = 'B';
+    img->header[1] = 'M';
+    bmp8_setHeaderField(img->header, 2, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + img->dataSize, 4);
+    bmp8_setHeaderField(img->header, 10, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, 4);
+    bmp8_setHeaderField(img->header, 14, 40, 4);
+    bmp8_setHeaderField(img->header, 18, width, 4);
+    bmp8_setHeaderField(img->header, 22, height, 4);
+    bmp8_setHeaderField(img->header, 26, 1, 2);
+    bmp8_setHeaderField(img->header, 28, 8, 2);
+    bmp8_setHeaderField(img->header, 34, img->dataSize, 4);
+    bmp8_setHeaderField(img->header, 38, 2835, 4); // 72 DPI
+    bmp8_setHeaderField(img->header, 42, 2835, 4);
+    bmp8_setHeaderField(img->header, 46, 256, 4);
+
+    // Palette de gris : B, G, R, réservé
+    for (int i = 0; i < 256; i++) {
+        img->colorTable[i * 4] = (unsigned char)i;
+        img->colorTable[i * 4 + 1] = (unsigned char)i;
+        img->colorTable[i * 4 + 2] = (unsigned char)i;
+        img->colorTable[i * 4 + 3] = 0;
     }
 
-    fclose(file);
     return img;
 }
 
+/*
+ * Donne un tableau de pointeurs vers le début de chaque ligne de l'image
+ * 
+ * Ce qu'elle fait :
+ * - Tient compte du padding : la ligne y commence à y * (width + rowPadding)
+ * - Les lignes sont dans l'ordre de rangement (de bas en haut pour un BMP
+ *   classique, de haut en bas si topDown)
+ * 
+ * Paramètre :
+ * - img : l'image
+ * 
+ * Renvoie :
+ * - Un tableau de height pointeurs à libérer avec free(), ou NULL si erreur
+ */
+unsigned char **bmp8_getRows(t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    unsigned char **rows = (unsigned char **)malloc(img->height * sizeof(unsigned char *));
+    if (rows == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        return NULL;
+    }
+
+    uint32_t stride = img->width + img->rowPadding;
+    for (uint32_t y = 0; y < img->height; y++) {
+        rows[y] = img->data + (size_t)y * stride;
+    }
+
+    return rows;
+}
+
+/*
+ * Donne la ligne y comptée depuis le haut de l'image
+ *
+ * Ce qu'elle fait :
+ * - Dans un BMP classique la ligne du haut est la dernière en mémoire
+ * - Si l'image est rangée de haut en bas (topDown), c'est la première
+ */
+unsigned char *bmp8_row(const t_bmp8 *img, uint32_t y) {
+    uint32_t index = img->topDown ? y : img->height - 1 - y;
+    return img->data + (size_t)index * (img->width + img->rowPadding);
+}
+
+/*
+ * Donne un tableau de pointeurs vers chaque ligne, de haut en bas
+ *
+ * Ce qu'elle fait :
+ * - Permet aux traitements qui dépendent du sens (gradients, rotations...)
+ *   d'ignorer l'ordre de rangement des lignes
+ *
+ * Renvoie :
+ * - Un tableau de height pointeurs à libérer avec free(), ou NULL si erreur
+ */
+unsigned char **bmp8_getTopDownRows(t_bmp8 *img) {
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return NULL;
+    }
+
+    if (!img->topDown) {
+        for (uint32_t y = 0; y < img->height / 2; y++) {
+            unsigned char *tmp = rows[y];
+            rows[y] = rows[img->height - 1 - y];
+            rows[img->height - 1 - y] = tmp;
+        }
+    }
+    return rows;
+}
+
+/*
+ * Change l'ordre de rangement des lignes
+ *
+ * Ce qu'elle fait :
+ * - Échange les lignes sur place si l'ordre change
+ * - Met à jour le signe de la hauteur dans l'en-tête
+ *
+ * Renvoie :
+ * - 0 si réussi, -1 si erreur
+ */
+int bmp8_setTopDown(t_bmp8 *img, int topDown) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    topDown = (topDown != 0);
+    if (topDown != img->topDown) {
+        uint32_t stride = img->width + img->rowPadding;
+        unsigned char *tmp = (unsigned char *)malloc(stride);
+        if (tmp == NULL) {
+            perror("Erreur: Allocation mémoire échouée");
+            return -1;
+        }
+        for (uint32_t y = 0; y < img->height / 2; y++) {
+            unsigned char *a = img->data + (size_t)y * stride;
+            unsigned char *b = img->data + (size_t)(img->height - 1 - y) * stride;
+            memcpy(tmp, a, stride);
+            memcpy(a, b, stride);
+            memcpy(b, tmp, stride);
+        }
+        free(tmp);
+        img->topDown = topDown;
+    }
+
+    int32_t height = (int32_t)img->height;
+    bmp8_setHeaderField(img->header, 22, (uint32_t)(topDown ? -height : height), 4);
+    return 0;
+}
+
+/*
+ * Taille du fichier BMP produit par bmp8_encode
+ */
+size_t bmp8_encodedSize(const t_bmp8 *img) {
+    return BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + (size_t)img->dataSize;
+}
+
+/*
+ * Écrit une image en noir et blanc en mémoire, au format BMP
+ *
+ * Ce qu'elle fait :
+ * - Recopie l'en-tête, la palette complète puis les pixels, lignes dans
+ *   l'ordre de rangement (d'un seul bloc, sans retournement)
+ *
+ * Paramètres :
+ * - img : l'image à écrire
+ * - file : destination de bmp8_encodedSize(img) octets
+ */
+void bmp8_encode(const t_bmp8 *img, unsigned char *file) {
+    memcpy(file, img->header, BMP_HEADER_SIZE);
+    memcpy(file + BMP_HEADER_SIZE, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    memcpy(file + BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, img->data, img->dataSize);
+}
+
 /*
  * Sauvegarde une image en noir et blanc dans un fichier
  * 
  * Ce qu'elle fait :
- * - Crée un nouveau fichier
- * - Écrit l'image dedans au format BMP
+ * - Écrit l'image en mémoire avec bmp8_encode
+ * - Crée le fichier et l'écrit d'un seul bloc
  * 
  * Paramètres :
  * - filename : nom du fichier où sauvegarder
@@ -136,40 +514,37 @@ t_bmp8 *bmp8_loadImage(const char *filename) {
  * - -1 si il y a eu une erreur
  */
 int bmp8_saveImage(const char *filename, t_bmp8 *img) {
-    if (img == NULL) {
+    if (img == NULL || img->data == NULL) {
         fprintf(stderr, "Erreur: Image invalide\n");
         return -1;
     }
 
-    FILE *file = fopen(filename, "wb");
-    if (file == NULL) {
-        perror("Erreur: Impossible d'ouvrir le fichier pour l'écriture");
+    size_t size = bmp8_encodedSize(img);
+    unsigned char *content = (unsigned char *)malloc(size);
+    if (content == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
         return -1;
     }
+    bmp8_encode(img, content);
 
-    // Écriture de l'en-tête
-    if (fwrite(img->header, sizeof(unsigned char), 54, file) != 54) {
-        perror("Erreur: Impossible d'écrire l'en-tête");
-        fclose(file);
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier pour l'écriture");
+        free(content);
         return -1;
     }
 
-    // Écriture de la table de couleurs
-    if (fwrite(img->colorTable, sizeof(unsigned char), 1024, file) != 1024) {
-        perror("Erreur: Impossible d'écrire la table de couleurs");
-        fclose(file);
-        return -1;
+    int status = 0;
+    if (fwrite(content, 1, size, file) != size) {
+        perror("Erreur: Impossible d'écrire l'image");
+        status = -1;
     }
-
-    // Écriture des données de l'image
-    if (fwrite(img->data, sizeof(unsigned char), img->dataSize, file) != img->dataSize) {
-        perror("Erreur: Impossible d'écrire les données de l'image");
-        fclose(file);
-        return -1;
+    if (fclose(file) != 0) {
+        status = -1;
     }
 
-    fclose(file);
-    return 0;
+    free(content);
+    return status;
 }
 
 /*
@@ -296,15 +671,16 @@ void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize) {
     memcpy(tempData, img->data, img->dataSize * sizeof(unsigned char));
 
     int n = kernelSize / 2;
+    unsigned int stride = img->width + img->rowPadding;
 
     // Application du filtre seulement aux pixels intérieurs
-    for (unsigned int y = n; y < img->height - n; y++) {
-        for (unsigned int x = n; x < img->width - n; x++) {
+    for (unsigned int y = n; y + n < img->height; y++) {
+        for (unsigned int x = n; x + n < img->width; x++) {
             float sum = 0.0f;
 
             for (int j = -n; j <= n; j++) {
                 for (int i = -n; i <= n; i++) {
-                    unsigned int pixelPos = (y + j) * img->width + (x + i);
+                    unsigned int pixelPos = (y + j) * stride + (x + i);
                     sum += img->data[pixelPos] * kernel[j + n][i + n];
                 }
             }
@@ -316,7 +692,7 @@ void bmp8_applyFilter(t_bmp8 *img, float **kernel, int kernelSize) {
                 sum = 0;
             }
 
-            tempData[y * img->width + x] = (unsigned char)sum;
+            tempData[y * stride + x] = (unsigned char)sum;
         }
     }
 
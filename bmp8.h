@@ -16,12 +16,18 @@
 #define BMP8_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* Constantes pour le format BMP */
 #define BMP_HEADER_SIZE 54
 #define BMP_COLOR_TABLE_SIZE 1024
 #define BITS_PER_PIXEL 8
 
+/* Valeurs du champ compression de l'en-tête (octet 30) */
+#define BMP_BI_RGB       0  // Pixels bruts
+#define BMP_BI_RLE8      1  // Suites compressées (8 bits)
+#define BMP_BI_BITFIELDS 3  // Pixels bruts décrits par des masques (16 et 32 bits)
+
 /*
  * Structure qui représente une image en noir et blanc (8 bits)
  */
@@ -35,16 +41,77 @@ typedef struct {
     uint16_t colorDepth;                      // Nombre de bits par pixel (8)
     uint32_t dataSize;                        // Taille totale des données
     uint32_t rowPadding;                      // Padding pour alignement 4 octets
+    int topDown;                              // 1 : lignes rangées de haut en bas (hauteur négative)
 } t_bmp8;
 
 /*
- * Ouvre et charge une image depuis un fichier
+ * Ouvre et charge une image depuis un fichier (brute ou compressée en RLE8).
+ * Les lignes restent dans l'ordre du fichier : une hauteur négative donne
+ * une image topDown, sans recopie.
  * Paramètre :
  *   filename - Chemin du fichier à charger
  * Renvoie : l'image chargée ou NULL si erreur
  */
 t_bmp8 *bmp8_loadImage(const char *filename);
 
+/*
+ * Décode un fichier BMP 8 bits déjà en mémoire, comme bmp8_loadImage
+ * Paramètres :
+ *   file     - Contenu du fichier
+ *   size     - Taille du fichier en octets
+ *   img      - Image à remplir ; img->data est un bloc de *capacity octets
+ *              (NULL pour en allouer un), agrandi avec realloc si besoin
+ *   capacity - Taille du bloc img->data, mise à jour
+ * Renvoie : 0 si réussi, -1 si erreur (img->data reste à libérer dans les deux cas)
+ */
+int bmp8_decode(const unsigned char *file, size_t size, t_bmp8 *img, size_t *capacity);
+
+/*
+ * Crée une image vide en niveaux de gris (en-tête et palette remplis)
+ * Paramètres :
+ *   width  - Largeur en pixels
+ *   height - Hauteur en pixels
+ * Renvoie : la nouvelle image ou NULL si erreur
+ */
+t_bmp8 *bmp8_allocate(uint32_t width, uint32_t height);
+
+/*
+ * Donne les pointeurs de début de ligne dans l'ordre de rangement
+ * (padding compris)
+ * Paramètre :
+ *   img - Image concernée
+ * Renvoie : tableau de height pointeurs à libérer avec free(), NULL si erreur
+ */
+unsigned char **bmp8_getRows(t_bmp8 *img);
+
+/*
+ * Donne une ligne de l'image comptée depuis le haut, quel que soit l'ordre
+ * de rangement (de bas en haut par défaut, de haut en bas si topDown)
+ * Paramètres :
+ *   img - Image concernée
+ *   y   - Ligne (0 = ligne du haut)
+ * Renvoie : pointeur sur le premier pixel de la ligne
+ */
+unsigned char *bmp8_row(const t_bmp8 *img, uint32_t y);
+
+/*
+ * Donne les pointeurs de début de ligne dans l'ordre visuel (ligne 0 en haut)
+ * Paramètre :
+ *   img - Image concernée
+ * Renvoie : tableau de height pointeurs à libérer avec free(), NULL si erreur
+ */
+unsigned char **bmp8_getTopDownRows(t_bmp8 *img);
+
+/*
+ * Choisit l'ordre de rangement des lignes, repris tel quel par
+ * bmp8_saveImage (les lignes sont réordonnées sur place si besoin)
+ * Paramètres :
+ *   img     - Image concernée
+ *   topDown - 1 : de haut en bas (hauteur négative), 0 : de bas en haut
+ * Renvoie : 0 si réussi, -1 si erreur
+ */
+int bmp8_setTopDown(t_bmp8 *img, int topDown);
+
 /*
  * Enregistre une image dans un fichier
  * Paramètres :
@@ -54,6 +121,19 @@ t_bmp8 *bmp8_loadImage(const char *filename);
  */
 int bmp8_saveImage(const char *filename, t_bmp8 *img);
 
+/*
+ * Taille du fichier BMP d'une image (en-tête, palette et pixels)
+ */
+size_t bmp8_encodedSize(const t_bmp8 *img);
+
+/*
+ * Écrit une image au format BMP en mémoire, octet pour octet comme bmp8_saveImage
+ * Paramètres :
+ *   img  - Image à écrire
+ *   file - Destination de bmp8_encodedSize(img) octets
+ */
+void bmp8_encode(const t_bmp8 *img, unsigned char *file);
+
 /*
  * Libère la mémoire utilisée par une image
  * Paramètre :
@@ -0,0 +1,852 @@
+/**
+ * @file bmpbatch.c
+ *
+ * @brief
+ * Trois étages reliés par des files bornées :
+ *   lecteurs : fichier entier -> tampon d'entrée -> file de lecture
+ *   calcul   : décodage en mémoire, chaîne, encodage -> file d'écriture
+ *   écrivains : tampon de sortie -> fichier
+ * Le calcul n'a pas de threads à lui : le thread appelant prend chaque
+ * fichier lu, lui réserve un tampon de sortie et une mémoire de travail,
+ * puis le confie à l'ordonnanceur (bmp_taskSpawn). Les filtres appelés
+ * dans cette tâche découpent à leur tour l'image en bandes, que les
+ * threads inoccupés volent : une grande image en fin de lot occupe tous
+ * les cœurs, une petite reste sur un seul.
+ *
+ * Les tampons d'entrée et de sortie et les mémoires de travail sont en
+ * nombre fixe et reviennent dans leur réserve après usage ; ils
+ * grandissent jusqu'au plus gros fichier vu puis ne sont plus réalloués.
+ * Un lecteur attend un tampon libre, ce qui limite l'avance de la lecture
+ * sur le calcul. Seuls les lecteurs, les écrivains et le thread appelant
+ * attendent ; une tâche de calcul ne fait que rendre des tampons, dans des
+ * files assez grandes pour ne jamais bloquer.
+ *
+ * Le décodage et l'encodage sont ceux de bmp8_loadImage / bmp24_loadImage
+ * et bmp8_saveImage / bmp24_saveImage (bmp8_decode, bmp24_decodeHeaders...),
+ * appliqués aux tampons en mémoire au lieu de fichiers.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpbatch.h"
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmprle.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define BATCH_DEFAULT_READERS 2
+#define BATCH_DEFAULT_WRITERS 2
+#define BATCH_MAX_THREADS 64
+
+/*
+ * Tampon d'un fichier entier, réutilisé d'un fichier à l'autre
+ */
+typedef struct {
+    int index;          // Fichier concerné
+    uint8_t *data;
+    size_t size;        // Octets utiles
+    size_t capacity;    // Octets alloués
+} t_batch_buffer;
+
+/*
+ * File bornée (tampons ou calculs, sert aussi de réserve d'éléments libres)
+ */
+typedef struct {
+    void **items;
+    int capacity;
+    int head;
+    int count;
+    int closed;         // Plus aucun ajout : pop rend NULL une fois vide
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+} t_batch_queue;
+
+/*
+ * Mémoire de travail d'un calcul, agrandie au besoin
+ */
+typedef struct {
+    uint8_t *pixels8;       // Pixels d'une image 8 bits
+    size_t capacity8;
+    t_pixel **rows24;       // Lignes d'une image 24 bits
+    t_pixel *pixels24;
+    int height24;
+    size_t capacity24;      // Pixels alloués
+} t_batch_scratch;
+
+typedef struct {
+    const char *const *inputs;
+    const char *const *outputs;
+    int count;
+    const t_bmp_chain *chain;
+
+    atomic_int nextFile;        // Prochain fichier à lire
+    atomic_int readersLeft;     // Le dernier lecteur ferme la file de lecture
+    atomic_int files;
+    atomic_int failed;
+    atomic_ullong bytesRead;
+    atomic_ullong bytesWritten;
+
+    t_batch_queue freeInputs;
+    t_batch_queue readQueue;
+    t_batch_queue freeOutputs;
+    t_batch_queue writeQueue;
+    t_batch_queue freeJobs;
+    t_task_group group;         // Calculs en cours
+} t_batch_pass;
+
+/*
+ * Calcul d'un fichier, confié à l'ordonnanceur
+ */
+typedef struct {
+    t_batch_pass *pass;
+    t_batch_buffer *input;
+    t_batch_buffer *output;
+    t_batch_scratch scratch;
+} t_batch_job;
+
+
+static int batch_queueInit(t_batch_queue *queue, int capacity) {
+    queue->items = (void **)malloc((size_t)capacity * sizeof(void *));
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    return (queue->items != NULL) ? 0 : -1;
+}
+
+
+static void batch_queueDestroy(t_batch_queue *queue) {
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_cond_destroy(&queue->notFull);
+    free(queue->items);
+}
+
+
+static void batch_queuePush(t_batch_queue *queue, void *item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->capacity) {
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    }
+    queue->items[(queue->head + queue->count) % queue->capacity] = item;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+
+static void *batch_queuePop(t_batch_queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+
+    void *item = NULL;
+    if (queue->count > 0) {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return item;
+}
+
+
+static void batch_queueClose(t_batch_queue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+
+static int batch_reserve(t_batch_buffer *buffer, size_t size) {
+    if (size <= buffer->capacity) {
+        return 0;
+    }
+    uint8_t *data = (uint8_t *)realloc(buffer->data, size);
+    if (data == NULL) {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = size;
+    return 0;
+}
+
+
+static uint32_t batch_field(const uint8_t *data, int offset, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint32_t)data[offset + i] << (8 * i);
+    }
+    return value;
+}
+
+
+/*
+ * Lit un fichier entier dans un tampon
+ */
+static int batch_readFile(const char *filename, t_batch_buffer *buffer) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        printf("Erreur: Impossible d'ouvrir %s\n", filename);
+        return -1;
+    }
+
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0 || batch_reserve(buffer, (size_t)size) != 0 ||
+        fread(buffer->data, 1, (size_t)size, file) != (size_t)size) {
+        printf("Erreur: Impossible de lire %s\n", filename);
+        fclose(file);
+        return -1;
+    }
+
+    buffer->size = (size_t)size;
+    fclose(file);
+    return 0;
+}
+
+
+/*
+ * Décode un BMP 24 bits avec bmp24_decodeHeaders / bmp24_decodePixels
+ * (lignes dans scratch->rows24)
+ */
+static int batch_decode24(const t_batch_buffer *input, t_bmp24 *img, t_batch_scratch *scratch) {
+    if (bmp24_decodeHeaders(input->data, input->size, img) != 0) {
+        return -1;
+    }
+
+    size_t pixels = (size_t)img->width * img->height;
+    if (pixels > scratch->capacity24) {
+        t_pixel *block = (t_pixel *)realloc(scratch->pixels24, pixels * sizeof(t_pixel));
+        if (block == NULL) {
+            printf("Erreur: Impossible d'allouer de la mémoire pour les pixels de l'image\n");
+            return -1;
+        }
+        scratch->pixels24 = block;
+        scratch->capacity24 = pixels;
+    }
+    if (img->height > scratch->height24) {
+        t_pixel **rows = (t_pixel **)realloc(scratch->rows24, (size_t)img->height * sizeof(t_pixel *));
+        if (rows == NULL) {
+            printf("Erreur: Impossible d'allouer de la mémoire pour les pixels de l'image\n");
+            return -1;
+        }
+        scratch->rows24 = rows;
+        scratch->height24 = img->height;
+    }
+    for (int y = 0; y < img->height; y++) {
+        scratch->rows24[y] = scratch->pixels24 + (size_t)y * img->width;
+    }
+    img->data = scratch->rows24;
+
+    bmp24_decodePixels(input->data, img);
+    return 0;
+}
+
+
+/*
+ * Décode, applique la chaîne et encode un fichier
+ */
+static int batch_process(t_batch_pass *pass, t_batch_buffer *input, t_batch_buffer *output,
+                         t_batch_scratch *scratch) {
+    if (input->size < BMP_HEADER_SIZE || input->data[0] != 'B' || input->data[1] != 'M') {
+        printf("Erreur: %s n'est pas au format BMP\n", pass->inputs[input->index]);
+        return -1;
+    }
+
+    uint16_t depth = (uint16_t)batch_field(input->data, 28, 2);
+    if (depth == 8) {
+        t_bmp8 img;
+        img.data = scratch->pixels8;
+        int status = bmp8_decode(input->data, input->size, &img, &scratch->capacity8);
+        scratch->pixels8 = img.data;
+        if (status != 0) {
+            return -1;
+        }
+        status = bmp8_applyChain(&img, pass->chain);
+        // bmp8_applyFilter remplace le tableau de pixels par un bloc de
+        // dataSize octets, parfois à l'adresse de l'ancien : on reprend
+        // toujours le bloc courant et sa taille
+        scratch->pixels8 = img.data;
+        scratch->capacity8 = img.dataSize;
+        if (status != 0) {
+            return -1;
+        }
+        if (batch_reserve(output, bmp8_encodedSize(&img)) != 0) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            return -1;
+        }
+        bmp8_encode(&img, output->data);
+        output->size = bmp8_encodedSize(&img);
+        return 0;
+    }
+    if (depth == 24) {
+        t_bmp24 img;
+        if (batch_decode24(input, &img, scratch) != 0 || bmp24_applyChain(&img, pass->chain) != 0) {
+            return -1;
+        }
+        if (batch_reserve(output, bmp24_encodedSize(&img)) != 0) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            return -1;
+        }
+        bmp24_encode(&img, output->data);
+        output->size = bmp24_encodedSize(&img);
+        return 0;
+    }
+
+    printf("Erreur: %s : profondeur %u non gérée\n", pass->inputs[input->index], depth);
+    return -1;
+}
+
+
+/*
+ * Étage de lecture pour un fichier : NULL si le fichier est illisible
+ */
+static t_batch_buffer *batch_readOne(t_batch_pass *pass, int index) {
+    t_batch_buffer *buffer = batch_queuePop(&pass->freeInputs);
+    buffer->index = index;
+    if (batch_readFile(pass->inputs[index], buffer) != 0) {
+        atomic_fetch_add(&pass->failed, 1);
+        batch_queuePush(&pass->freeInputs, buffer);
+        return NULL;
+    }
+    atomic_fetch_add(&pass->bytesRead, buffer->size);
+    return buffer;
+}
+
+
+/*
+ * Étage de calcul pour un fichier : rend le tampon d'entrée, NULL si échec
+ */
+static t_batch_buffer *batch_processOne(t_batch_pass *pass, t_batch_buffer *input, t_batch_buffer *output,
+                                        t_batch_scratch *scratch) {
+    output->index = input->index;
+
+    int status = batch_process(pass, input, output, scratch);
+    batch_queuePush(&pass->freeInputs, input);
+
+    if (status != 0) {
+        atomic_fetch_add(&pass->failed, 1);
+        batch_queuePush(&pass->freeOutputs, output);
+        return NULL;
+    }
+    return output;
+}
+
+
+/*
+ * Étage d'écriture pour un fichier : rend le tampon de sortie
+ */
+static void batch_writeOne(t_batch_pass *pass, t_batch_buffer *output) {
+    const char *filename = pass->outputs[output->index];
+    FILE *file = fopen(filename, "wb");
+    int ok = (file != NULL && fwrite(output->data, 1, output->size, file) == output->size);
+    if (file != NULL && fclose(file) != 0) {
+        ok = 0;
+    }
+
+    if (ok) {
+        atomic_fetch_add(&pass->files, 1);
+        atomic_fetch_add(&pass->bytesWritten, output->size);
+    } else {
+        printf("Erreur: Impossible d'écrire %s\n", filename);
+        atomic_fetch_add(&pass->failed, 1);
+    }
+    batch_queuePush(&pass->freeOutputs, output);
+}
+
+
+static void batch_freeScratch(t_batch_scratch *scratch) {
+    free(scratch->pixels8);
+    free(scratch->pixels24);
+    free(scratch->rows24);
+}
+
+
+static void *batch_reader(void *param) {
+    t_batch_pass *pass = (t_batch_pass *)param;
+    int index;
+
+    while ((index = atomic_fetch_add(&pass->nextFile, 1)) < pass->count) {
+        t_batch_buffer *input = batch_readOne(pass, index);
+        if (input != NULL) {
+            batch_queuePush(&pass->readQueue, input);
+        }
+    }
+
+    if (atomic_fetch_sub(&pass->readersLeft, 1) == 1) {
+        batch_queueClose(&pass->readQueue);
+    }
+    return NULL;
+}
+
+
+/*
+ * Tâche de calcul d'un fichier (exécutée par l'un des threads de l'ordonnanceur)
+ */
+static void batch_fileTask(void *arg) {
+    t_batch_job *job = (t_batch_job *)arg;
+    t_batch_pass *pass = job->pass;
+
+    t_batch_buffer *output = batch_processOne(pass, job->input, job->output, &job->scratch);
+    if (output != NULL) {
+        batch_queuePush(&pass->writeQueue, output);
+    }
+    batch_queuePush(&pass->freeJobs, job);
+}
+
+
+/*
+ * Étage de calcul, tenu par le thread appelant : chaque fichier lu devient
+ * une tâche dès qu'un calcul et un tampon de sortie sont libres
+ */
+static void batch_dispatch(t_batch_pass *pass) {
+    t_batch_buffer *input;
+
+    while ((input = batch_queuePop(&pass->readQueue)) != NULL) {
+        t_batch_job *job = batch_queuePop(&pass->freeJobs);
+        job->input = input;
+        job->output = batch_queuePop(&pass->freeOutputs);
+        bmp_taskSpawn(&pass->group, batch_fileTask, job);
+    }
+    bmp_taskWait(&pass->group);
+    batch_queueClose(&pass->writeQueue);
+}
+
+
+static void *batch_writer(void *param) {
+    t_batch_pass *pass = (t_batch_pass *)param;
+    t_batch_buffer *output;
+
+    while ((output = batch_queuePop(&pass->writeQueue)) != NULL) {
+        batch_writeOne(pass, output);
+    }
+    return NULL;
+}
+
+
+/*
+ * Sans écrivain ou sans lecteur, le thread appelant traite les fichiers un
+ * par un ; les écrivains déjà lancés continuent d'écrire
+ */
+static void batch_inline(t_batch_pass *pass, int write) {
+    t_batch_job *job = batch_queuePop(&pass->freeJobs);
+    int index;
+
+    while ((index = atomic_fetch_add(&pass->nextFile, 1)) < pass->count) {
+        t_batch_buffer *buffer = batch_readOne(pass, index);
+        if (buffer != NULL) {
+            buffer = batch_processOne(pass, buffer, batch_queuePop(&pass->freeOutputs), &job->scratch);
+        }
+        if (buffer == NULL) {
+            continue;
+        }
+        if (write) {
+            batch_writeOne(pass, buffer);
+        } else {
+            batch_queuePush(&pass->writeQueue, buffer);
+        }
+    }
+    batch_queuePush(&pass->freeJobs, job);
+
+    if (!write) {
+        batch_queueClose(&pass->writeQueue);
+    }
+}
+
+
+/*
+ * Lance count threads d'un étage, rend le nombre de threads obtenus
+ */
+static int batch_start(pthread_t *ids, int count, void *(*stage)(void *), t_batch_pass *pass) {
+    int started = 0;
+    while (started < count && pthread_create(&ids[started], NULL, stage, pass) == 0) {
+        started++;
+    }
+    return started;
+}
+
+
+static double batch_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+static int batch_clamp(int value, int fallback) {
+    if (value <= 0) {
+        value = fallback;
+    }
+    return (value > BATCH_MAX_THREADS) ? BATCH_MAX_THREADS : value;
+}
+
+
+int bmp_batchRun(const char *const *inputs, const char *const *outputs, int count,
+                 const t_bmp_chain *chain, const t_batch_config *config, t_batch_report *report) {
+    if (inputs == NULL || outputs == NULL || count < 0 || chain == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    t_batch_config defaults = {0, 0, 0, 0};
+    if (config == NULL) {
+        config = &defaults;
+    }
+    int threads = bmp_threadCount();
+    int readers = batch_clamp(config->readers, BATCH_DEFAULT_READERS);
+    int writers = batch_clamp(config->writers, BATCH_DEFAULT_WRITERS);
+    int jobs = (config->jobs > 0) ? config->jobs : threads;
+    int depth = (config->queueDepth > 0) ? config->queueDepth : threads;
+
+    // Un tampon par lecteur, par calcul et par écrivain, plus depth en
+    // attente dans chaque file
+    int inputCount = readers + jobs + depth;
+    int outputCount = jobs + writers + depth;
+    t_batch_buffer *buffers = (t_batch_buffer *)calloc((size_t)(inputCount + outputCount), sizeof(t_batch_buffer));
+    t_batch_job *jobList = (t_batch_job *)calloc((size_t)jobs, sizeof(t_batch_job));
+    if (buffers == NULL || jobList == NULL) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        free(buffers);
+        free(jobList);
+        return -1;
+    }
+
+    t_batch_pass pass;
+    pass.inputs = inputs;
+    pass.outputs = outputs;
+    pass.count = count;
+    pass.chain = chain;
+    atomic_init(&pass.nextFile, 0);
+    atomic_init(&pass.readersLeft, readers);
+    atomic_init(&pass.files, 0);
+    atomic_init(&pass.failed, 0);
+    atomic_init(&pass.bytesRead, 0);
+    atomic_init(&pass.bytesWritten, 0);
+    bmp_taskGroupInit(&pass.group);
+
+    int status = batch_queueInit(&pass.freeInputs, inputCount);
+    status |= batch_queueInit(&pass.readQueue, inputCount);
+    status |= batch_queueInit(&pass.freeOutputs, outputCount);
+    status |= batch_queueInit(&pass.writeQueue, outputCount);
+    status |= batch_queueInit(&pass.freeJobs, jobs);
+    if (status != 0) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        batch_queueDestroy(&pass.freeInputs);
+        batch_queueDestroy(&pass.readQueue);
+        batch_queueDestroy(&pass.freeOutputs);
+        batch_queueDestroy(&pass.writeQueue);
+        batch_queueDestroy(&pass.freeJobs);
+        free(buffers);
+        free(jobList);
+        return -1;
+    }
+    for (int i = 0; i < inputCount; i++) {
+        batch_queuePush(&pass.freeInputs, &buffers[i]);
+    }
+    for (int i = 0; i < outputCount; i++) {
+        batch_queuePush(&pass.freeOutputs, &buffers[inputCount + i]);
+    }
+    for (int i = 0; i < jobs; i++) {
+        jobList[i].pass = &pass;
+        batch_queuePush(&pass.freeJobs, &jobList[i]);
+    }
+
+    double start = batch_now();
+
+    // Les écrivains sont lancés avant les lecteurs : s'il manque des
+    // threads, le thread appelant lit et calcule lui-même
+    pthread_t writerIds[BATCH_MAX_THREADS];
+    pthread_t readerIds[BATCH_MAX_THREADS];
+    int startedWriters = batch_start(writerIds, writers, batch_writer, &pass);
+    int startedReaders = 0;
+
+    if (startedWriters > 0) {
+        startedReaders = batch_start(readerIds, readers, batch_reader, &pass);
+        if (startedReaders > 0 && atomic_fetch_sub(&pass.readersLeft, readers - startedReaders) == readers - startedReaders) {
+            batch_queueClose(&pass.readQueue);
+        }
+    }
+    if (startedReaders > 0) {
+        batch_dispatch(&pass);
+    } else {
+        batch_inline(&pass, startedWriters == 0);
+    }
+
+    for (int i = 0; i < startedReaders; i++) {
+        pthread_join(readerIds[i], NULL);
+    }
+    for (int i = 0; i < startedWriters; i++) {
+        pthread_join(writerIds[i], NULL);
+    }
+
+    t_batch_report result;
+    result.files = atomic_load(&pass.files);
+    result.failed = atomic_load(&pass.failed);
+    result.bytesRead = atomic_load(&pass.bytesRead);
+    result.bytesWritten = atomic_load(&pass.bytesWritten);
+    result.seconds = batch_now() - start;
+    if (report != NULL) {
+        *report = result;
+    }
+
+    for (int i = 0; i < inputCount + outputCount; i++) {
+        free(buffers[i].data);
+    }
+    for (int i = 0; i < jobs; i++) {
+        batch_freeScratch(&jobList[i].scratch);
+    }
+    free(buffers);
+    free(jobList);
+    batch_queueDestroy(&pass.freeInputs);
+    batch_queueDestroy(&pass.readQueue);
+    batch_queueDestroy(&pass.freeOutputs);
+    batch_queueDestroy(&pass.writeQueue);
+    batch_queueDestroy(&pass.freeJobs);
+
+    return (result.files == count) ? 0 : -1;
+}
+
+
+void bmp_batchPrintReport(const t_batch_report *report) {
+    if (report == NULL) {
+        return;
+    }
+
+    double seconds = (report->seconds > 0.0) ? report->seconds : 1e-9;
+    printf("Fichiers traités : %d (%d en échec) en %.3f s\n", report->files, report->failed, report->seconds);
+    printf("Débit : %.1f fichiers/s, lecture %.1f Mo/s, écriture %.1f Mo/s\n",
+           report->files / seconds,
+           report->bytesRead / (1024.0 * 1024.0) / seconds,
+           report->bytesWritten / (1024.0 * 1024.0) / seconds);
+}
+
+
+/*
+ * Vrai si le nom se termine par .bmp (majuscules ou minuscules)
+ */
+static int batch_isBmp(const char *name) {
+    size_t length = strlen(name);
+    if (length <= 4 || name[length - 4] != '.') {
+        return 0;
+    }
+    return tolower((unsigned char)name[length - 3]) == 'b' &&
+           tolower((unsigned char)name[length - 2]) == 'm' &&
+           tolower((unsigned char)name[length - 1]) == 'p';
+}
+
+
+static int batch_compareNames(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+
+/*
+ * Liste les fichiers .bmp d'un dossier, triés par nom (count vaut -1 si erreur)
+ */
+static char **batch_listDirectory(const char *directory, int *count) {
+    DIR *dir = opendir(directory);
+    if (dir == NULL) {
+        printf("Erreur: Impossible d'ouvrir le dossier %s\n", directory);
+        *count = -1;
+        return NULL;
+    }
+
+    char **names = NULL;
+    int capacity = 0;
+    *count = 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!batch_isBmp(entry->d_name)) {
+            continue;
+        }
+        if (*count == capacity) {
+            capacity = (capacity == 0) ? 64 : capacity * 2;
+            char **grown = (char **)realloc(names, (size_t)capacity * sizeof(char *));
+            if (grown == NULL) {
+                break;
+            }
+            names = grown;
+        }
+        names[*count] = (char *)malloc(strlen(entry->d_name) + 1);
+        if (names[*count] == NULL) {
+            break;
+        }
+        strcpy(names[*count], entry->d_name);
+        (*count)++;
+    }
+    closedir(dir);
+
+    if (entry != NULL) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        for (int i = 0; i < *count; i++) {
+            free(names[i]);
+        }
+        free(names);
+        *count = -1;
+        return NULL;
+    }
+
+    if (*count > 0) {
+        qsort(names, (size_t)*count, sizeof(char *), batch_compareNames);
+    }
+    return names;
+}
+
+
+/*
+ * Chemin dossier/nom dans un nouveau bloc
+ */
+static char *batch_joinPath(const char *directory, const char *name) {
+    size_t size = strlen(directory) + strlen(name) + 2;
+    char *path = (char *)malloc(size);
+    if (path != NULL) {
+        snprintf(path, size, "%s/%s", directory, name);
+    }
+    return path;
+}
+
+
+/*
+ * Lit la valeur d'une option numérique : entier strictement positif
+ */
+static int batch_value(const char *option, const char *text, int *value) {
+    char *end = NULL;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || parsed <= 0 || parsed > INT_MAX) {
+        printf("Erreur: %s attend un entier strictement positif (reçu : %s)\n", option, text);
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
+
+int bmp_batchMain(int argc, char **argv) {
+    const char *inputDir = NULL;
+    const char *outputDir = NULL;
+    t_batch_config config = {0, 0, 0, 0};
+    int threads = 0;
+
+    t_bmp_chain *chain = bmp_chainCreate();
+    if (chain == NULL) {
+        return 1;
+    }
+
+    int i = 1;
+    while (i < argc) {
+        int parsed = bmp_chainParse(chain, argc, argv, &i);
+        if (parsed < 0) {
+            bmp_chainFree(chain);
+            return 1;
+        }
+        if (parsed > 0) {
+            continue;
+        }
+
+        int *option = NULL;
+        if (strcmp(argv[i], "--readers") == 0) {
+            option = &config.readers;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            option = &threads;
+        } else if (strcmp(argv[i], "--jobs") == 0) {
+            option = &config.jobs;
+        } else if (strcmp(argv[i], "--writers") == 0) {
+            option = &config.writers;
+        } else if (strcmp(argv[i], "--depth") == 0) {
+            option = &config.queueDepth;
+        }
+
+        if (option != NULL && i + 1 < argc) {
+            if (batch_value(argv[i], argv[i + 1], option) != 0) {
+                inputDir = NULL;
+                break;
+            }
+            i += 2;
+        } else if (option == NULL && argv[i][0] != '-' && inputDir == NULL) {
+            inputDir = argv[i++];
+        } else if (option == NULL && argv[i][0] != '-' && outputDir == NULL) {
+            outputDir = argv[i++];
+        } else {
+            printf("Erreur: Argument invalide : %s\n", argv[i]);
+            inputDir = NULL;
+            break;
+        }
+    }
+
+    if (inputDir == NULL || outputDir == NULL) {
+        printf("Usage : %s <dossier source> <dossier destination> [--threads N] [--readers N] "
+               "[--writers N] [--jobs N] [--depth N] [--negative] [--brightness N] [--threshold N] [--grayscale] "
+               "[--box-blur] [--gaussian] [--outline] [--emboss] [--sharpen]\n", (argc > 0) ? argv[0] : "batch");
+        bmp_chainFree(chain);
+        return 1;
+    }
+
+    if (threads > 0) {
+        bmp_setThreadCount(threads);
+    }
+
+    int count = 0;
+    char **names = batch_listDirectory(inputDir, &count);
+    if (count < 0) {
+        bmp_chainFree(chain);
+        return 1;
+    }
+
+    char **inputs = (char **)calloc((size_t)count + 1, sizeof(char *));
+    char **outputs = (char **)calloc((size_t)count + 1, sizeof(char *));
+    int status = (inputs != NULL && outputs != NULL) ? 0 : -1;
+    for (int n = 0; n < count && status == 0; n++) {
+        inputs[n] = batch_joinPath(inputDir, names[n]);
+        outputs[n] = batch_joinPath(outputDir, names[n]);
+        if (inputs[n] == NULL || outputs[n] == NULL) {
+            status = -1;
+        }
+    }
+
+    t_batch_report report;
+    if (status == 0) {
+        status = bmp_batchRun((const char *const *)inputs, (const char *const *)outputs, count,
+                              chain, &config, &report);
+        bmp_batchPrintReport(&report);
+    } else {
+        printf("Erreur: Allocation mémoire échouée\n");
+    }
+
+    for (int n = 0; n < count; n++) {
+        free(names[n]);
+        if (inputs != NULL) {
+            free(inputs[n]);
+        }
+        if (outputs != NULL) {
+            free(outputs[n]);
+        }
+    }
+    free(names);
+    free(inputs);
+    free(outputs);
+    bmp_chainFree(chain);
+    return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file bmpbatch.h
+ *
+ * @brief
+ * Traitement par lots : la même chaîne d'opérations (bmpchain.h) appliquée
+ * à des milliers de fichiers dans un seul processus. Le travail passe par
+ * trois étages qui tournent en même temps : des lecteurs qui chargent les
+ * fichiers suivants à l'avance, le calcul qui applique la chaîne sur les
+ * threads de l'ordonnanceur (bmpthread.h), et des écrivains qui
+ * enregistrent les résultats. Les files entre étages sont bornées et les
+ * tampons sont recyclés d'un fichier à l'autre : la mémoire reste stable
+ * quel que soit le nombre de fichiers.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPBATCH_H
+#define BMPBATCH_H
+
+#include <stdint.h>
+#include "bmpchain.h"
+
+/*
+ * Réglage des étages (0 : valeur par défaut). Le calcul utilise les
+ * bmp_threadCount() threads de l'ordonnanceur.
+ */
+typedef struct {
+    int readers;     // Threads de lecture (2 par défaut)
+    int writers;     // Threads d'écriture (2 par défaut)
+    int jobs;        // Fichiers en cours de calcul à la fois (bmp_threadCount() par défaut)
+    int queueDepth;  // Fichiers en attente entre deux étages (bmp_threadCount() par défaut)
+} t_batch_config;
+
+/*
+ * Bilan d'un lot
+ */
+typedef struct {
+    int files;              // Fichiers traités et enregistrés
+    int failed;             // Fichiers illisibles, non gérés ou impossibles à écrire
+    uint64_t bytesRead;     // Octets lus (fichiers traités ou non)
+    uint64_t bytesWritten;  // Octets écrits
+    double seconds;         // Durée totale
+} t_batch_report;
+
+/* bmp_batchRun
+ * Rôle : Applique une chaîne à une liste de fichiers BMP 8 ou 24 bits
+ * Paramètres :
+ *   inputs  - Fichiers à lire
+ *   outputs - Fichiers à écrire (outputs[i] reçoit le résultat de inputs[i])
+ *   count   - Nombre de fichiers
+ *   chain   - Étapes à appliquer
+ *   config  - Nombre de threads par étage (NULL : valeurs par défaut)
+ *   report  - Reçoit le bilan (peut être NULL)
+ * Retour : 0 si tous les fichiers ont été traités, -1 sinon
+ * Note : Chaque fichier enregistré est identique à celui de
+ *        bmp8_loadImage / bmp24_loadImage, bmp8_applyChain / bmp24_applyChain
+ *        puis bmp8_saveImage / bmp24_saveImage. Un fichier est traité par un
+ *        seul thread : le parallélisme vient du nombre de fichiers.
+ */
+int bmp_batchRun(const char *const *inputs, const char *const *outputs, int count,
+                 const t_bmp_chain *chain, const t_batch_config *config, t_batch_report *report);
+
+/* bmp_batchPrintReport
+ * Rôle : Affiche le bilan d'un lot (fichiers/s, Mo/s lus et écrits)
+ */
+void bmp_batchPrintReport(const t_batch_report *report);
+
+/* bmp_batchMain
+ * Rôle : Mode lot de l'exécutable :
+ *        <dossier source> <dossier destination> [--threads N] [--readers N]
+ *        [--writers N] [--jobs N] [--depth N] [étapes de bmp_chainParse...]
+ *        Tous les fichiers .bmp du dossier source sont traités et enregistrés
+ *        sous le même nom dans le dossier destination (qui doit exister)
+ * Paramètres :
+ *   argc, argv - Arguments de la commande, argv[0] (nom du mode) ignoré
+ * Retour : 0 si tous les fichiers ont été traités, 1 sinon
+ */
+int bmp_batchMain(int argc, char **argv);
+
+#endif
@@ -0,0 +1,313 @@
+/**
+ * @file bmpblend.c
+ *
+ * @brief
+ * Toutes les opérations travaillent sur des lignes d'octets : la couleur
+ * fusionnée est d'abord calculée dans un tampon de ligne, puis interpolée
+ * avec la base par (f * a + b * (255 - a)) / 255, la transparence du pixel
+ * étant répétée sur chacune de ses composantes. La division par 255 est exacte
+ * et sans division : (x + 128 + ((x + 128) >> 8)) >> 8 pour x <= 65280.
+ * Les boucles ont une version SSE2 (8 octets par registre sur 16 bits) et
+ * une version scalaire. Base, calque et masque sont des vues (bmpview) :
+ * une image entière ou une zone se traitent de la même façon, sans copie.
+ * Les lignes sont réparties entre les threads.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpblend.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define BLEND_GRAIN 32
+
+typedef struct {
+    t_bmp_view base;            // Zone couverte dans la base
+    t_bmp_view overlay;         // Zone correspondante du calque (base NULL : couleur unie)
+    const uint8_t *colorRow;    // Ligne remplie de la couleur unie
+    t_bmp_view mask;            // Zone correspondante du masque (base NULL : opacité seule)
+    t_blend_mode mode;
+    int opacity;
+    atomic_int failed;          // Une bande n'a pas pu allouer ses tampons
+} t_blend_pass;
+
+
+static inline uint32_t blend_div255(uint32_t x) {
+    return (x + 128 + ((x + 128) >> 8)) >> 8;
+}
+
+
+#ifdef __SSE2__
+static inline __m128i blend_div255x8(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+
+/* a * b / 255 sur 16 octets */
+static inline __m128i blend_mul16(__m128i a, __m128i b) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = blend_div255x8(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+    __m128i hi = blend_div255x8(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+    return _mm_packus_epi16(lo, hi);
+}
+#endif
+
+
+/* out = fusion(base, over) */
+static void blend_modeRow(const uint8_t *base, const uint8_t *over, uint8_t *out, int n, t_blend_mode mode) {
+    int i = 0;
+
+    if (mode == BMP_BLEND_NORMAL) {
+        memcpy(out, over, n);
+        return;
+    }
+
+#ifdef __SSE2__
+    __m128i ones = _mm_set1_epi8((char)0xFF);
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)(base + i));
+        __m128i o = _mm_loadu_si128((const __m128i *)(over + i));
+        __m128i r;
+        if (mode == BMP_BLEND_MULTIPLY) {
+            r = blend_mul16(b, o);
+        } else if (mode == BMP_BLEND_SCREEN) {
+            r = _mm_xor_si128(blend_mul16(_mm_xor_si128(b, ones), _mm_xor_si128(o, ones)), ones);
+        } else {
+            r = _mm_adds_epu8(b, o);
+        }
+        _mm_storeu_si128((__m128i *)(out + i), r);
+    }
+#endif
+
+    for (; i < n; i++) {
+        uint32_t b = base[i], o = over[i];
+        if (mode == BMP_BLEND_MULTIPLY) {
+            out[i] = (uint8_t)blend_div255(b * o);
+        } else if (mode == BMP_BLEND_SCREEN) {
+            out[i] = (uint8_t)(255 - blend_div255((255 - b) * (255 - o)));
+        } else {
+            out[i] = (uint8_t)((b + o > 255) ? 255 : b + o);
+        }
+    }
+}
+
+
+/* base = (src * alpha + base * (255 - alpha)) / 255 */
+static void blend_lerpRow(uint8_t *base, const uint8_t *src, const uint8_t *alpha, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i full = _mm_set1_epi16(255);
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)(base + i));
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i a = _mm_loadu_si128((const __m128i *)(alpha + i));
+
+        __m128i aLo = _mm_unpacklo_epi8(a, zero);
+        __m128i aHi = _mm_unpackhi_epi8(a, zero);
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), aLo),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), _mm_sub_epi16(full, aLo)));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), aHi),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), _mm_sub_epi16(full, aHi)));
+        _mm_storeu_si128((__m128i *)(base + i), _mm_packus_epi16(blend_div255x8(lo), blend_div255x8(hi)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        base[i] = (uint8_t)blend_div255(src[i] * alpha[i] + base[i] * (255u - alpha[i]));
+    }
+}
+
+
+static void blend_band(void *arg, int begin, int end) {
+    t_blend_pass *pass = (t_blend_pass *)arg;
+    int channels = pass->base.channels;
+    int n = pass->base.width * channels;
+    uint8_t *mixed = (uint8_t *)malloc(n);
+    uint8_t *alpha = (uint8_t *)malloc(n);
+
+    if (mixed == NULL || alpha == NULL) {
+        printf("Erreur: Impossible d'allouer les tampons de fusion\n");
+        free(mixed);
+        free(alpha);
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int row = begin; row < end; row++) {
+        uint8_t *base = bmp_viewRow(&pass->base, row);
+        const uint8_t *over = (pass->overlay.base != NULL) ? bmp_viewRow(&pass->overlay, row) : pass->colorRow;
+
+        // Transparence de chaque pixel, répétée sur toutes ses composantes
+        if (pass->mask.base != NULL) {
+            const uint8_t *m = bmp_viewRow(&pass->mask, row);
+            for (int x = 0; x < pass->base.width; x++) {
+                uint8_t a = (uint8_t)blend_div255((uint32_t)m[x] * pass->opacity);
+                for (int c = 0; c < channels; c++) {
+                    alpha[x * channels + c] = a;
+                }
+            }
+        } else {
+            memset(alpha, pass->opacity, n);
+        }
+
+        blend_modeRow(base, over, mixed, n, pass->mode);
+        blend_lerpRow(base, mixed, alpha, n);
+    }
+
+    free(mixed);
+    free(alpha);
+}
+
+
+/*
+ * Rogne le calque (w x h placé en x, y) à la base, réduit les vues de la
+ * pass à la zone couverte puis lance les bandes.
+ * Renvoie 0 même si rien n'est couvert, -1 si une bande a manqué de mémoire.
+ */
+static int blend_run(t_blend_pass *pass, int w, int h, int x, int y) {
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = (x + w > pass->base.width) ? pass->base.width : x + w;
+    int y1 = (y + h > pass->base.height) ? pass->base.height : y + h;
+
+    if (x1 <= x0 || y1 <= y0 || pass->opacity == 0) {
+        return 0;
+    }
+
+    bmp_subView(&pass->base, x0, y0, x1 - x0, y1 - y0, &pass->base);
+    if (pass->overlay.base != NULL) {
+        bmp_subView(&pass->overlay, x0 - x, y0 - y, x1 - x0, y1 - y0, &pass->overlay);
+    }
+    if (pass->mask.base != NULL) {
+        bmp_subView(&pass->mask, x0 - x, y0 - y, x1 - x0, y1 - y0, &pass->mask);
+    }
+    atomic_init(&pass->failed, 0);
+    bmp_parallelFor(y1 - y0, BLEND_GRAIN, blend_band, pass);
+    return (atomic_load(&pass->failed) == 0) ? 0 : -1;
+}
+
+
+static int blend_checkArgs(t_bmp24 *base, t_blend_mode mode, int opacity) {
+    if (base == NULL || base->data == NULL) {
+        printf("Erreur: Image de base invalide\n");
+        return -1;
+    }
+    if (mode < BMP_BLEND_NORMAL || mode > BMP_BLEND_ADD || opacity < 0 || opacity > 255) {
+        printf("Erreur: Mode ou opacité invalide\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+int bmp24_blend(t_bmp24 *base, const t_bmp24 *overlay, const t_bmp8 *mask, int x, int y,
+                t_blend_mode mode, int opacity) {
+    if (blend_checkArgs(base, mode, opacity) != 0) {
+        return -1;
+    }
+    if (overlay == NULL || overlay->data == NULL) {
+        printf("Erreur: Calque invalide\n");
+        return -1;
+    }
+    if (mask != NULL && (mask->data == NULL || (int)mask->width != overlay->width ||
+                         (int)mask->height != overlay->height)) {
+        printf("Erreur: Le masque doit avoir les dimensions du calque\n");
+        return -1;
+    }
+
+    t_blend_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    bmp24_view(base, &pass.base);
+    bmp24_view((t_bmp24 *)overlay, &pass.overlay);
+    if (mask != NULL) {
+        bmp8_view((t_bmp8 *)mask, &pass.mask);
+    }
+    pass.mode = mode;
+    pass.opacity = opacity;
+    return blend_run(&pass, overlay->width, overlay->height, x, y);
+}
+
+
+int bmp24_blendColor(t_bmp24 *base, t_pixel color, const t_bmp8 *mask, int x, int y,
+                     t_blend_mode mode, int opacity) {
+    if (blend_checkArgs(base, mode, opacity) != 0) {
+        return -1;
+    }
+    if (mask != NULL && mask->data == NULL) {
+        printf("Erreur: Masque invalide\n");
+        return -1;
+    }
+
+    int w = (mask != NULL) ? (int)mask->width : base->width;
+    int h = (mask != NULL) ? (int)mask->height : base->height;
+    if (mask == NULL) {
+        x = 0;
+        y = 0;
+    }
+
+    t_pixel *colorRow = (t_pixel *)malloc((size_t)w * sizeof(t_pixel));
+    if (colorRow == NULL) {
+        printf("Erreur: Impossible d'allouer la ligne de couleur\n");
+        return -1;
+    }
+    for (int i = 0; i < w; i++) {
+        colorRow[i] = color;
+    }
+
+    t_blend_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    bmp24_view(base, &pass.base);
+    pass.colorRow = (const uint8_t *)colorRow;
+    if (mask != NULL) {
+        bmp8_view((t_bmp8 *)mask, &pass.mask);
+    }
+    pass.mode = mode;
+    pass.opacity = opacity;
+
+    // Le calque uni commence toujours au début de la ligne de couleur
+    int status = blend_run(&pass, w, h, x, y);
+    free(colorRow);
+    return status;
+}
+
+
+int bmp_viewBlend(const t_bmp_view *base, const t_bmp_view *overlay, const t_bmp_view *mask,
+                  t_blend_mode mode, int opacity) {
+    if (base == NULL || base->base == NULL || overlay == NULL || overlay->base == NULL) {
+        printf("Erreur: Zone de base ou calque invalide\n");
+        return -1;
+    }
+    if (mode < BMP_BLEND_NORMAL || mode > BMP_BLEND_ADD || opacity < 0 || opacity > 255) {
+        printf("Erreur: Mode ou opacité invalide\n");
+        return -1;
+    }
+    if (overlay->width != base->width || overlay->height != base->height ||
+        overlay->channels != base->channels ||
+        (mask != NULL && (mask->base == NULL || mask->channels != 1 ||
+                          mask->width != base->width || mask->height != base->height))) {
+        printf("Erreur: Le calque et le masque doivent avoir les dimensions de la zone\n");
+        return -1;
+    }
+
+    t_blend_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.base = *base;
+    pass.overlay = *overlay;
+    if (mask != NULL) {
+        pass.mask = *mask;
+    }
+    pass.mode = mode;
+    pass.opacity = opacity;
+    return blend_run(&pass, base->width, base->height, 0, 0);
+}
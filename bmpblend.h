@@ -0,0 +1,78 @@
+/**
+ * @file bmpblend.h
+ *
+ * @brief
+ * Mélange et composition d'images couleur : incrustation d'une image (logo,
+ * filigrane) ou d'une couleur unie sur une image de base, avec un masque
+ * 8 bits comme transparence et une position dans l'image de base.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPBLEND_H
+#define BMPBLEND_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/*
+ * Modes de fusion (b = base, o = calque, valeurs ramenées à 0..1)
+ */
+typedef enum {
+    BMP_BLEND_NORMAL,       // o
+    BMP_BLEND_MULTIPLY,     // b * o (assombrit)
+    BMP_BLEND_SCREEN,       // 1 - (1 - b) * (1 - o) (éclaircit)
+    BMP_BLEND_ADD           // min(b + o, 1)
+} t_blend_mode;
+
+/* bmp24_blend
+ * Rôle : Incruste un calque dans l'image de base :
+ *        base = fusion(base, calque) * alpha + base * (1 - alpha)
+ * Paramètres :
+ *   base    - Image modifiée
+ *   overlay - Calque (peut être plus petit que la base ; il n'est pas copié)
+ *   mask    - Transparence du calque, de mêmes dimensions (255 = opaque),
+ *             ou NULL pour un calque entièrement opaque
+ *   x, y    - Position du coin haut gauche du calque dans la base (peut
+ *             être négative : la partie qui dépasse est ignorée)
+ *   mode    - Mode de fusion
+ *   opacity - Opacité globale (0 à 255), multipliée par le masque
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_blend(t_bmp24 *base, const t_bmp24 *overlay, const t_bmp8 *mask, int x, int y,
+                t_blend_mode mode, int opacity);
+
+/* bmp24_blendColor
+ * Rôle : Incruste une couleur unie à travers un masque
+ * Paramètres :
+ *   base    - Image modifiée
+ *   color   - Couleur du calque
+ *   mask    - Forme et transparence du calque, ou NULL pour couvrir toute
+ *             l'image (x et y sont alors ignorés)
+ *   x, y    - Position du coin haut gauche du masque dans la base
+ *   mode    - Mode de fusion
+ *   opacity - Opacité globale (0 à 255)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_blendColor(t_bmp24 *base, t_pixel color, const t_bmp8 *mask, int x, int y,
+                     t_blend_mode mode, int opacity);
+
+/* bmp_viewBlend
+ * Rôle : Incruste un calque dans une zone de la base, sans copier ni l'une
+ *        ni l'autre (même formule que bmp24_blend)
+ * Paramètres :
+ *   base    - Zone modifiée (1, 3 ou 4 composantes)
+ *   overlay - Calque, de mêmes dimensions et composantes que base
+ *   mask    - Transparence (vue à 1 composante de mêmes dimensions), ou NULL
+ *   mode    - Mode de fusion
+ *   opacity - Opacité globale (0 à 255)
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : Toutes les composantes sont fusionnées, alpha compris pour les
+ *        zones d'images 32 bits
+ */
+int bmp_viewBlend(const t_bmp_view *base, const t_bmp_view *overlay, const t_bmp_view *mask,
+                  t_blend_mode mode, int opacity);
+
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file bmpcanny.c
+ *
+ * @brief
+ * Canny en flux. Chaque bande de lignes fait avancer quatre étapes en même
+ * temps : la ligne y de sortie demande les normes des lignes y-1..y+1, qui
+ * demandent les lignes lissées correspondantes, qui demandent les lignes
+ * source y-4..y+4. Chaque étape garde ses dernières lignes dans un petit
+ * anneau, si bien que les intermédiaires tiennent en cache. Les bandes
+ * recalculent simplement leurs quelques lignes de bord (halo).
+ *
+ * L'hystérésis part des pixels forts et propage par une pile explicite
+ * aux pixels faibles voisins (8-connexité).
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpcanny.h"
+#include "bmpedge.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#define CANNY_GRAIN 32
+#define CANNY_STRONG 255
+#define CANNY_WEAK 128
+
+/* Secteurs d'orientation du gradient pour la suppression des non-maxima */
+#define CANNY_DIR_HORIZONTAL 0  // Gradient horizontal : voisins gauche / droite
+#define CANNY_DIR_DIAGONAL   1  // Voisins haut-gauche / bas-droite
+#define CANNY_DIR_VERTICAL   2  // Voisins haut / bas
+#define CANNY_DIR_ANTI       3  // Voisins haut-droite / bas-gauche
+
+typedef struct {
+    const uint8_t *const *src; // Lignes source de haut en bas
+    int channels;              // 1 (gris) ou 3 (t_pixel)
+    int width;
+    int height;
+    int low;                   // Seuils à l'échelle de la norme brute (x4)
+    int high;
+    uint8_t *const *dst;       // Lignes de sortie de haut en bas
+    atomic_int failed;         // Une bande n'a pas pu allouer ses tampons
+} t_canny_pass;
+
+/*
+ * Anneau de lignes : la ligne r est rangée dans le slot r % size
+ */
+typedef struct {
+    int size;
+    int tags[5];
+    uint8_t *rows[5];
+} t_canny_ring;
+
+/* État d'une bande : un anneau par étape et des tampons de travail */
+typedef struct {
+    const t_canny_pass *pass;
+    t_canny_ring luma;     // 5 lignes de luminance (images couleur)
+    t_canny_ring smooth;   // 3 lignes lissées
+    int magTags[3];
+    uint16_t *mag[3];      // 3 lignes de norme
+    uint8_t *dir[3];       // et leurs orientations
+    uint16_t *vsum;        // Somme verticale du flou
+    int16_t *gx;
+    int16_t *gy;
+    void *block;
+} t_canny_state;
+
+
+static inline int canny_clampRow(int r, int height) {
+    return (r < 0) ? 0 : ((r >= height) ? height - 1 : r);
+}
+
+
+/*
+ * Flou gaussien 5x5 séparable [1 4 6 4 1] / 16 sur une ligne,
+ * bords répliqués
+ */
+static void canny_smoothRow(const uint8_t *const rows[5], uint8_t *out, uint16_t *vsum, int width) {
+    for (int x = 0; x < width; x++) {
+        vsum[x] = (uint16_t)(rows[0][x] + 4 * rows[1][x] + 6 * rows[2][x] + 4 * rows[3][x] + rows[4][x]);
+    }
+
+    for (int x = 0; x < width; x++) {
+        int x0 = (x >= 2) ? x - 2 : 0;
+        int x1 = (x >= 1) ? x - 1 : 0;
+        int x3 = (x + 1 < width) ? x + 1 : width - 1;
+        int x4 = (x + 2 < width) ? x + 2 : width - 1;
+        int sum = vsum[x0] + 4 * vsum[x1] + 6 * vsum[x] + 4 * vsum[x3] + vsum[x4];
+        out[x] = (uint8_t)((sum + 128) >> 8);
+    }
+}
+
+
+/*
+ * Norme (L2, non normalisée) et secteur d'orientation d'une ligne
+ */
+static void canny_gradientRow(const uint8_t *above, const uint8_t *row, const uint8_t *below, int width,
+                              int16_t *gx, int16_t *gy, uint16_t *mag, uint8_t *dir) {
+    bmp_gradientRow(above, row, below, width, BMP_GRADIENT_SOBEL, gx, gy);
+
+    for (int x = 0; x < width; x++) {
+        int ax = abs(gx[x]);
+        int ay = abs(gy[x]);
+        mag[x] = (uint16_t)(sqrtf((float)(ax * ax + ay * ay)) + 0.5f);
+
+        // tan(22.5°) ~ 13573 / 32768 et tan(67.5°) ~ 79109 / 32768
+        if (ay * 32768 < ax * 13573) {
+            dir[x] = CANNY_DIR_HORIZONTAL;
+        } else if (ay * 32768 > ax * 79109) {
+            dir[x] = CANNY_DIR_VERTICAL;
+        } else {
+            dir[x] = ((gx[x] > 0) == (gy[x] > 0)) ? CANNY_DIR_DIAGONAL : CANNY_DIR_ANTI;
+        }
+    }
+}
+
+
+/*
+ * Suppression des non-maxima et double seuil sur une ligne :
+ * 255 = contour fort, 128 = contour faible, 0 = rien
+ */
+static void canny_suppressRow(const uint16_t *above, const uint16_t *row, const uint16_t *below,
+                              const uint8_t *dir, int width, int low, int high, uint8_t *out) {
+    for (int x = 0; x < width; x++) {
+        int m = row[x];
+        if (m < low) {
+            out[x] = 0;
+            continue;
+        }
+
+        int left = (x > 0) ? x - 1 : -1;
+        int right = (x + 1 < width) ? x + 1 : -1;
+        int n1, n2;
+
+        switch (dir[x]) {
+            case CANNY_DIR_HORIZONTAL:
+                n1 = (left >= 0) ? row[left] : 0;
+                n2 = (right >= 0) ? row[right] : 0;
+                break;
+            case CANNY_DIR_VERTICAL:
+                n1 = above[x];
+                n2 = below[x];
+                break;
+            case CANNY_DIR_DIAGONAL:
+                n1 = (left >= 0) ? above[left] : 0;
+                n2 = (right >= 0) ? below[right] : 0;
+                break;
+            default:
+                n1 = (right >= 0) ? above[right] : 0;
+                n2 = (left >= 0) ? below[left] : 0;
+                break;
+        }
+
+        if (m > n1 && m >= n2) {
+            out[x] = (m >= high) ? CANNY_STRONG : CANNY_WEAK;
+        } else {
+            out[x] = 0;
+        }
+    }
+}
+
+
+static const uint8_t *canny_sourceRow(t_canny_state *s, int r) {
+    const t_canny_pass *pass = s->pass;
+    r = canny_clampRow(r, pass->height);
+    if (pass->channels == 1) {
+        return pass->src[r];
+    }
+
+    int slot = r % s->luma.size;
+    if (s->luma.tags[slot] != r) {
+        bmp24_lumaRow((const t_pixel *)pass->src[r], s->luma.rows[slot], pass->width);
+        s->luma.tags[slot] = r;
+    }
+    return s->luma.rows[slot];
+}
+
+
+static const uint8_t *canny_smoothedRow(t_canny_state *s, int r) {
+    r = canny_clampRow(r, s->pass->height);
+
+    int slot = r % s->smooth.size;
+    if (s->smooth.tags[slot] != r) {
+        const uint8_t *rows[5];
+        for (int k = 0; k < 5; k++) {
+            rows[k] = canny_sourceRow(s, r + k - 2);
+        }
+        canny_smoothRow(rows, s->smooth.rows[slot], s->vsum, s->pass->width);
+        s->smooth.tags[slot] = r;
+    }
+    return s->smooth.rows[slot];
+}
+
+
+static int canny_magnitudeRow(t_canny_state *s, int r) {
+    r = canny_clampRow(r, s->pass->height);
+
+    int slot = r % 3;
+    if (s->magTags[slot] != r) {
+        const uint8_t *above = canny_smoothedRow(s, r - 1);
+        const uint8_t *row = canny_smoothedRow(s, r);
+        const uint8_t *below = canny_smoothedRow(s, r + 1);
+        canny_gradientRow(above, row, below, s->pass->width, s->gx, s->gy, s->mag[slot], s->dir[slot]);
+        s->magTags[slot] = r;
+    }
+    return slot;
+}
+
+
+static int canny_initState(t_canny_state *s, const t_canny_pass *pass) {
+    int w = pass->width;
+    size_t bytes = (size_t)w * (5 + 3 + 3) + (size_t)w * sizeof(uint16_t) * 4 + (size_t)w * sizeof(int16_t) * 2;
+
+    memset(s, 0, sizeof(*s));
+    s->pass = pass;
+    s->block = malloc(bytes);
+    if (s->block == NULL) {
+        printf("Erreur: Impossible d'allouer les tampons de Canny\n");
+        return -1;
+    }
+
+    // Les tableaux 16 bits d'abord pour garder leur alignement
+    uint16_t *p16 = (uint16_t *)s->block;
+    for (int k = 0; k < 3; k++) {
+        s->mag[k] = p16;
+        p16 += w;
+        s->magTags[k] = -1;
+    }
+    s->vsum = p16;
+    p16 += w;
+    s->gx = (int16_t *)p16;
+    s->gy = s->gx + w;
+
+    uint8_t *p8 = (uint8_t *)(s->gy + w);
+    s->luma.size = 5;
+    s->smooth.size = 3;
+    for (int k = 0; k < 5; k++) {
+        s->luma.rows[k] = p8;
+        s->luma.tags[k] = -1;
+        p8 += w;
+    }
+    for (int k = 0; k < 3; k++) {
+        s->smooth.rows[k] = p8;
+        s->smooth.tags[k] = -1;
+        p8 += w;
+        s->dir[k] = p8;
+        p8 += w;
+    }
+    return 0;
+}
+
+
+static void canny_band(void *arg, int begin, int end) {
+    t_canny_pass *pass = (t_canny_pass *)arg;
+    t_canny_state s;
+
+    if (canny_initState(&s, pass) != 0) {
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int y = begin; y < end; y++) {
+        int above = canny_magnitudeRow(&s, y - 1);
+        int row = canny_magnitudeRow(&s, y);
+        int below = canny_magnitudeRow(&s, y + 1);
+        canny_suppressRow(s.mag[above], s.mag[row], s.mag[below], s.dir[row],
+                          pass->width, pass->low, pass->high, pass->dst[y]);
+    }
+
+    free(s.block);
+}
+
+
+/*
+ * Hystérésis : tout pixel faible relié (8-connexité) à un pixel fort
+ * devient fort, les autres pixels faibles disparaissent
+ */
+static int canny_hysteresis(uint8_t *const *rows, int width, int height) {
+    size_t capacity = 4096, top = 0;
+    int32_t *stack = (int32_t *)malloc(capacity * 2 * sizeof(int32_t));
+    if (stack == NULL) {
+        printf("Erreur: Impossible d'allouer la pile d'hystérésis\n");
+        return -1;
+    }
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (rows[y][x] != CANNY_STRONG) {
+                continue;
+            }
+
+            stack[0] = x;
+            stack[1] = y;
+            top = 1;
+            while (top > 0) {
+                top--;
+                int cx = stack[top * 2];
+                int cy = stack[top * 2 + 1];
+
+                for (int j = -1; j <= 1; j++) {
+                    int ny = cy + j;
+                    if (ny < 0 || ny >= height) {
+                        continue;
+                    }
+                    for (int i = -1; i <= 1; i++) {
+                        int nx = cx + i;
+                        if (nx < 0 || nx >= width || rows[ny][nx] != CANNY_WEAK) {
+                            continue;
+                        }
+
+                        rows[ny][nx] = CANNY_STRONG;
+                        if (top == capacity) {
+                            int32_t *bigger = (int32_t *)realloc(stack, capacity * 4 * sizeof(int32_t));
+                            if (bigger == NULL) {
+                                printf("Erreur: Impossible d'agrandir la pile d'hystérésis\n");
+                                free(stack);
+                                return -1;
+                            }
+                            stack = bigger;
+                            capacity *= 2;
+                        }
+                        stack[top * 2] = nx;
+                        stack[top * 2 + 1] = ny;
+                        top++;
+                    }
+                }
+            }
+        }
+    }
+
+    free(stack);
+    return 0;
+}
+
+
+typedef struct {
+    uint8_t *const *rows;
+    int width;
+} t_canny_cleanup;
+
+
+static void canny_cleanupBand(void *arg, int begin, int end) {
+    const t_canny_cleanup *c = (const t_canny_cleanup *)arg;
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *row = c->rows[y];
+        for (int x = 0; x < c->width; x++) {
+            row[x] = (row[x] == CANNY_STRONG) ? 255 : 0;
+        }
+    }
+}
+
+
+static int canny_checkThresholds(int low, int high) {
+    if (low < 0 || high > 255 || low > high) {
+        fprintf(stderr, "Erreur: Seuils invalides (0 <= bas <= haut <= 255)\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+static t_bmp8 *canny_run(const uint8_t *const *src, int channels, int width, int height, int low, int high) {
+    t_bmp8 *result = bmp8_allocate(width, height);
+    uint8_t **dst = (result != NULL) ? bmp8_getTopDownRows(result) : NULL;
+    if (dst == NULL) {
+        bmp8_free(result);
+        return NULL;
+    }
+
+    // La norme brute de Sobel vaut 4 fois la norme ramenée sur 0-255
+    t_canny_pass pass = {src, channels, width, height, low * 4, high * 4, dst};
+    atomic_init(&pass.failed, 0);
+    bmp_parallelFor(height, CANNY_GRAIN, canny_band, &pass);
+    if (atomic_load(&pass.failed) != 0) {
+        free(dst);
+        bmp8_free(result);
+        return NULL;
+    }
+
+    int status = canny_hysteresis(dst, width, height);
+    if (status == 0) {
+        t_canny_cleanup cleanup = {dst, width};
+        bmp_parallelFor(height, CANNY_GRAIN, canny_cleanupBand, &cleanup);
+    }
+
+    free(dst);
+    if (status != 0) {
+        bmp8_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+
+t_bmp8 *bmp8_canny(t_bmp8 *img, int lowThreshold, int highThreshold) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+    if (canny_checkThresholds(lowThreshold, highThreshold) != 0) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp8_getTopDownRows(img);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp8 *result = canny_run((const uint8_t *const *)src, 1, img->width, img->height,
+                               lowThreshold, highThreshold);
+    free(src);
+    return result;
+}
+
+
+t_bmp8 *bmp24_canny(t_bmp24 *img, int lowThreshold, int highThreshold) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+    if (canny_checkThresholds(lowThreshold, highThreshold) != 0) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp24_getRows(img);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp8 *result = canny_run((const uint8_t *const *)src, 3, img->width, img->height,
+                               lowThreshold, highThreshold);
+    free(src);
+    return result;
+}
+
+
+t_bmp8 *bmp8_cannyReference(t_bmp8 *img, int lowThreshold, int highThreshold) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+    if (canny_checkThresholds(lowThreshold, highThreshold) != 0) {
+        return NULL;
+    }
+
+    int w = img->width, h = img->height;
+    uint8_t **src = bmp8_getTopDownRows(img);
+    t_bmp8 *result = bmp8_allocate(w, h);
+    uint8_t **dst = (result != NULL) ? bmp8_getTopDownRows(result) : NULL;
+
+    // Images intermédiaires complètes : lissage, norme, orientation
+    uint8_t *smooth = (uint8_t *)malloc((size_t)w * h);
+    uint16_t *mag = (uint16_t *)malloc((size_t)w * h * sizeof(uint16_t));
+    uint8_t *dir = (uint8_t *)malloc((size_t)w * h);
+    uint16_t *vsum = (uint16_t *)malloc(w * sizeof(uint16_t));
+    int16_t *gx = (int16_t *)malloc(w * 2 * sizeof(int16_t));
+
+    int status = -1;
+    if (src != NULL && dst != NULL && smooth != NULL && mag != NULL && dir != NULL && vsum != NULL && gx != NULL) {
+        for (int y = 0; y < h; y++) {
+            const uint8_t *rows[5];
+            for (int k = 0; k < 5; k++) {
+                rows[k] = src[canny_clampRow(y + k - 2, h)];
+            }
+            canny_smoothRow(rows, smooth + (size_t)y * w, vsum, w);
+        }
+
+        for (int y = 0; y < h; y++) {
+            canny_gradientRow(smooth + (size_t)canny_clampRow(y - 1, h) * w, smooth + (size_t)y * w,
+                              smooth + (size_t)canny_clampRow(y + 1, h) * w, w,
+                              gx, gx + w, mag + (size_t)y * w, dir + (size_t)y * w);
+        }
+
+        for (int y = 0; y < h; y++) {
+            canny_suppressRow(mag + (size_t)canny_clampRow(y - 1, h) * w, mag + (size_t)y * w,
+                              mag + (size_t)canny_clampRow(y + 1, h) * w, dir + (size_t)y * w, w,
+                              lowThreshold * 4, highThreshold * 4, dst[y]);
+        }
+
+        status = canny_hysteresis(dst, w, h);
+        if (status == 0) {
+            t_canny_cleanup cleanup = {dst, w};
+            canny_cleanupBand(&cleanup, 0, h);
+        }
+    } else {
+        printf("Erreur: Impossible d'allouer les images intermédiaires\n");
+    }
+
+    free(src);
+    free(dst);
+    free(smooth);
+    free(mag);
+    free(dir);
+    free(vsum);
+    free(gx);
+    if (status != 0) {
+        bmp8_free(result);
+        return NULL;
+    }
+    return result;
+}
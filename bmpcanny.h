@@ -0,0 +1,45 @@
+/**
+ * @file bmpcanny.h
+ *
+ * @brief
+ * Détecteur de contours de Canny : lissage gaussien, gradient de Sobel,
+ * suppression des non-maxima, double seuil puis hystérésis. Le résultat
+ * est une image 8 bits où les contours valent 255 et le reste 0.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPCANNY_H
+#define BMPCANNY_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+/* bmp8_canny
+ * Rôle : Détecte les contours d'une image en niveaux de gris
+ * Paramètres :
+ *   img           - Image source (non modifiée)
+ *   lowThreshold  - Seuil bas de la norme du gradient (0-255)
+ *   highThreshold - Seuil haut (0-255), doit être >= lowThreshold
+ * Retour : Carte des contours (0 ou 255) ou NULL si erreur
+ * Méthode : Les étapes sont enchaînées ligne par ligne dans chaque bande
+ *           de lignes (une bande par thread) : seules quelques lignes
+ *           intermédiaires existent en mémoire à un instant donné
+ */
+t_bmp8 *bmp8_canny(t_bmp8 *img, int lowThreshold, int highThreshold);
+
+/* bmp24_canny
+ * Rôle : Identique à bmp8_canny, sur la luminance d'une image couleur
+ */
+t_bmp8 *bmp24_canny(t_bmp24 *img, int lowThreshold, int highThreshold);
+
+/* bmp8_cannyReference
+ * Rôle : Même calcul que bmp8_canny, étape par étape avec des images
+ *        intermédiaires complètes et sur un seul thread
+ * Note : Sert de référence pour vérifier et mesurer la version en flux ;
+ *        les deux fonctions donnent exactement le même résultat
+ */
+t_bmp8 *bmp8_cannyReference(t_bmp8 *img, int lowThreshold, int highThreshold);
+
+#endif
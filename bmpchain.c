@@ -0,0 +1,255 @@
+/**
+ * @file bmpchain.c
+ *
+ * @brief
+ * L'exécution en mémoire appelle simplement les fonctions existantes
+ * (bmp8_negative, bmp24_boxBlur...) : c'est la référence que le mode flux
+ * doit reproduire à l'octet près. Les coefficients des filtres sont donc
+ * ceux de bmp24.c, calculés de la même façon en float.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpchain.h"
+#include "bmphistogram.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHAIN_INITIAL_CAPACITY 8
+
+/*
+ * Nom de chaque étape en ligne de commande
+ */
+typedef struct {
+    const char *name;
+    t_chain_step step;
+    int hasValue;
+} t_chain_name;
+
+static const t_chain_name chain_names[] = {
+    {"--negative", BMP_STEP_NEGATIVE, 0},
+    {"--brightness", BMP_STEP_BRIGHTNESS, 1},
+    {"--threshold", BMP_STEP_THRESHOLD, 1},
+    {"--grayscale", BMP_STEP_GRAYSCALE, 0},
+    {"--box-blur", BMP_STEP_BOX_BLUR, 0},
+    {"--gaussian", BMP_STEP_GAUSSIAN_BLUR, 0},
+    {"--outline", BMP_STEP_OUTLINE, 0},
+    {"--emboss", BMP_STEP_EMBOSS, 0},
+    {"--sharpen", BMP_STEP_SHARPEN, 0}
+};
+
+static const float chain_kernels[5][3][3] = {
+    // BMP_STEP_BOX_BLUR
+    {{1.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f},
+     {1.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f},
+     {1.0f / 9.0f, 1.0f / 9.0f, 1.0f / 9.0f}},
+    // BMP_STEP_GAUSSIAN_BLUR
+    {{1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f},
+     {2.0f / 16.0f, 4.0f / 16.0f, 2.0f / 16.0f},
+     {1.0f / 16.0f, 2.0f / 16.0f, 1.0f / 16.0f}},
+    // BMP_STEP_OUTLINE
+    {{-1.0f, -1.0f, -1.0f},
+     {-1.0f,  8.0f, -1.0f},
+     {-1.0f, -1.0f, -1.0f}},
+    // BMP_STEP_EMBOSS
+    {{-2.0f, -1.0f, 0.0f},
+     {-1.0f,  1.0f, 1.0f},
+     { 0.0f,  1.0f, 2.0f}},
+    // BMP_STEP_SHARPEN
+    {{ 0.0f, -1.0f,  0.0f},
+     {-1.0f,  5.0f, -1.0f},
+     { 0.0f, -1.0f,  0.0f}}
+};
+
+
+t_bmp_chain *bmp_chainCreate(void) {
+    t_bmp_chain *chain = (t_bmp_chain *)calloc(1, sizeof(t_bmp_chain));
+    if (chain == NULL) {
+        printf("Erreur: Impossible d'allouer la chaîne d'opérations\n");
+    }
+    return chain;
+}
+
+
+void bmp_chainFree(t_bmp_chain *chain) {
+    if (chain == NULL) {
+        return;
+    }
+    free(chain->ops);
+    free(chain);
+}
+
+
+int bmp_chainAdd(t_bmp_chain *chain, t_chain_step step, int value) {
+    if (chain == NULL || step < BMP_STEP_NEGATIVE || step > BMP_STEP_SHARPEN) {
+        printf("Erreur: Étape invalide\n");
+        return -1;
+    }
+
+    if (chain->count == chain->capacity) {
+        int capacity = (chain->capacity == 0) ? CHAIN_INITIAL_CAPACITY : chain->capacity * 2;
+        t_chain_op *ops = (t_chain_op *)realloc(chain->ops, (size_t)capacity * sizeof(t_chain_op));
+        if (ops == NULL) {
+            printf("Erreur: Impossible d'agrandir la chaîne d'opérations\n");
+            return -1;
+        }
+        chain->ops = ops;
+        chain->capacity = capacity;
+    }
+
+    chain->ops[chain->count].step = step;
+    chain->ops[chain->count].value = value;
+    chain->count++;
+    return 0;
+}
+
+
+int bmp_chainParse(t_bmp_chain *chain, int argc, char **argv, int *index) {
+    if (chain == NULL || argv == NULL || index == NULL || *index >= argc) {
+        return 0;
+    }
+
+    for (size_t n = 0; n < sizeof(chain_names) / sizeof(chain_names[0]); n++) {
+        const t_chain_name *entry = &chain_names[n];
+        if (strcmp(argv[*index], entry->name) != 0) {
+            continue;
+        }
+
+        int value = 0;
+        if (entry->hasValue) {
+            char *end = NULL;
+            if (*index + 1 >= argc ||
+                (value = (int)strtol(argv[*index + 1], &end, 10), end == argv[*index + 1] || *end != '\0')) {
+                fprintf(stderr, "Erreur: %s attend une valeur entière\n", entry->name);
+                return -1;
+            }
+        }
+        if (bmp_chainAdd(chain, entry->step, value) != 0) {
+            return -1;
+        }
+        *index += entry->hasValue ? 2 : 1;
+        return 1;
+    }
+    return 0;
+}
+
+
+int bmp_chainIsStencil(t_chain_step step) {
+    return step >= BMP_STEP_BOX_BLUR && step <= BMP_STEP_SHARPEN;
+}
+
+
+int bmp_chainLut(const t_chain_op *op, uint8_t lut[256]) {
+    for (int v = 0; v < 256; v++) {
+        switch (op->step) {
+            case BMP_STEP_NEGATIVE:
+                lut[v] = (uint8_t)(255 - v);
+                break;
+            case BMP_STEP_BRIGHTNESS: {
+                int shifted = v + op->value;
+                lut[v] = (uint8_t)((shifted > 255) ? 255 : ((shifted < 0) ? 0 : shifted));
+                break;
+            }
+            case BMP_STEP_THRESHOLD:
+                lut[v] = (v >= op->value) ? 255 : 0;
+                break;
+            default:
+                return -1;
+        }
+    }
+    return 0;
+}
+
+
+int bmp_chainKernel(t_chain_step step, float kernel[3][3]) {
+    if (!bmp_chainIsStencil(step)) {
+        return -1;
+    }
+    memcpy(kernel, chain_kernels[step - BMP_STEP_BOX_BLUR], sizeof(chain_kernels[0]));
+    return 0;
+}
+
+
+int bmp8_applyChain(t_bmp8 *img, const t_bmp_chain *chain) {
+    if (img == NULL || img->data == NULL || chain == NULL) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    for (int i = 0; i < chain->count; i++) {
+        const t_chain_op *op = &chain->ops[i];
+        float kernel[3][3];
+        float *rows[3] = {kernel[0], kernel[1], kernel[2]};
+
+        switch (op->step) {
+            case BMP_STEP_NEGATIVE:
+                bmp8_negative(img);
+                break;
+            case BMP_STEP_BRIGHTNESS:
+                bmp8_brightness(img, op->value);
+                break;
+            case BMP_STEP_THRESHOLD:
+                bmp8_threshold(img, op->value);
+                break;
+            case BMP_STEP_GRAYSCALE:
+                // Déjà en niveaux de gris
+                break;
+            default:
+                bmp_chainKernel(op->step, kernel);
+                bmp8_applyFilter(img, rows, 3);
+                break;
+        }
+    }
+    return 0;
+}
+
+
+int bmp24_applyChain(t_bmp24 *img, const t_bmp_chain *chain) {
+    if (img == NULL || img->data == NULL || chain == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    for (int i = 0; i < chain->count; i++) {
+        const t_chain_op *op = &chain->ops[i];
+        uint8_t luts[3][256];
+
+        switch (op->step) {
+            case BMP_STEP_NEGATIVE:
+                bmp24_negative(img);
+                break;
+            case BMP_STEP_BRIGHTNESS:
+                bmp24_brightness(img, op->value);
+                break;
+            case BMP_STEP_THRESHOLD:
+                bmp_chainLut(op, luts[0]);
+                memcpy(luts[1], luts[0], 256);
+                memcpy(luts[2], luts[0], 256);
+                if (bmp24_applyLut(img, luts) != 0) {
+                    return -1;
+                }
+                break;
+            case BMP_STEP_GRAYSCALE:
+                bmp24_grayscale(img);
+                break;
+            case BMP_STEP_BOX_BLUR:
+                bmp24_boxBlur(img);
+                break;
+            case BMP_STEP_GAUSSIAN_BLUR:
+                bmp24_gaussianBlur(img);
+                break;
+            case BMP_STEP_OUTLINE:
+                bmp24_outline(img);
+                break;
+            case BMP_STEP_EMBOSS:
+                bmp24_emboss(img);
+                break;
+            case BMP_STEP_SHARPEN:
+                bmp24_sharpen(img);
+                break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file bmpchain.h
+ *
+ * @brief
+ * Chaîne d'opérations à appliquer à une image : une liste d'étapes
+ * (opérations ponctuelles ou filtres 3x3) décrite une fois puis exécutée
+ * soit sur une image en mémoire, soit en flux sur un fichier trop grand
+ * pour la mémoire (voir bmpstream.h). Les deux exécutions donnent
+ * exactement les mêmes pixels.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPCHAIN_H
+#define BMPCHAIN_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+/*
+ * Étapes disponibles (mêmes calculs que les fonctions bmp8_ / bmp24_ correspondantes)
+ */
+typedef enum {
+    BMP_STEP_NEGATIVE,      // Opérations ponctuelles
+    BMP_STEP_BRIGHTNESS,    // value : décalage ajouté à chaque composante
+    BMP_STEP_THRESHOLD,     // value : seuil (>= seuil -> 255, sinon 0), par composante
+    BMP_STEP_GRAYSCALE,     // Moyenne des trois composantes (sans effet en 8 bits)
+    BMP_STEP_BOX_BLUR,      // Filtres 3x3
+    BMP_STEP_GAUSSIAN_BLUR,
+    BMP_STEP_OUTLINE,
+    BMP_STEP_EMBOSS,
+    BMP_STEP_SHARPEN
+} t_chain_step;
+
+typedef struct {
+    t_chain_step step;
+    int value;              // Paramètre de l'étape (ignoré si elle n'en a pas)
+} t_chain_op;
+
+typedef struct {
+    t_chain_op *ops;
+    int count;
+    int capacity;
+} t_bmp_chain;
+
+/* Gestion de la mémoire */
+t_bmp_chain *bmp_chainCreate(void);     // Chaîne vide, NULL si erreur
+void bmp_chainFree(t_bmp_chain *chain);
+
+/* bmp_chainAdd
+ * Rôle : Ajoute une étape à la fin de la chaîne
+ * Paramètres :
+ *   chain - Chaîne à compléter
+ *   step  - Étape
+ *   value - Paramètre de l'étape (0 si elle n'en a pas)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_chainAdd(t_bmp_chain *chain, t_chain_step step, int value);
+
+/* bmp_chainParse
+ * Rôle : Reconnaît une étape écrite en ligne de commande et l'ajoute à la
+ *        chaîne : --negative, --brightness N, --threshold N, --grayscale,
+ *        --box-blur, --gaussian, --outline, --emboss, --sharpen
+ * Paramètres :
+ *   chain      - Chaîne à compléter
+ *   argc, argv - Arguments
+ *   index      - Position de l'étape dans argv, avancée après ses arguments
+ * Retour : 1 si une étape a été ajoutée, 0 si argv[*index] n'est pas une
+ *          étape (index inchangé), -1 si sa valeur manque ou est invalide
+ */
+int bmp_chainParse(t_bmp_chain *chain, int argc, char **argv, int *index);
+
+/* bmp_chainIsStencil
+ * Rôle : Indique si l'étape lit les pixels voisins (filtre 3x3)
+ * Retour : 1 pour un filtre, 0 pour une opération ponctuelle
+ */
+int bmp_chainIsStencil(t_chain_step step);
+
+/* bmp_chainLut
+ * Rôle : Donne la table de correspondance d'une étape ponctuelle appliquée
+ *        à chaque composante (négatif, luminosité, seuil)
+ * Retour : 0 si réussi, -1 si l'étape n'est pas une table (grayscale, filtres)
+ */
+int bmp_chainLut(const t_chain_op *op, uint8_t lut[256]);
+
+/* bmp_chainKernel
+ * Rôle : Donne les coefficients d'un filtre 3x3 (kernel[ligne][colonne],
+ *        ligne 0 = voisins du haut)
+ * Retour : 0 si réussi, -1 si l'étape n'est pas un filtre
+ */
+int bmp_chainKernel(t_chain_step step, float kernel[3][3]);
+
+/* bmp8_applyChain / bmp24_applyChain
+ * Rôle : Exécute la chaîne sur une image en mémoire, étape par étape
+ * Paramètres :
+ *   img   - Image à modifier
+ *   chain - Étapes à appliquer
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : En 8 bits les filtres suivent bmp8_applyFilter : lignes prises dans
+ *        l'ordre de la mémoire et pixels du bord inchangés. En 24 bits ils
+ *        suivent bmp24_boxBlur... : voisins hors de l'image ignorés.
+ */
+int bmp8_applyChain(t_bmp8 *img, const t_bmp_chain *chain);
+int bmp24_applyChain(t_bmp24 *img, const t_bmp_chain *chain);
+
+#endif
@@ -0,0 +1,448 @@
+/**
+ * @file bmpclahe.c
+ *
+ * @brief
+ * CLAHE en deux passes :
+ * 1. histogramme plafonné de chaque tuile, puis table de correspondance
+ *    (les rangées de tuiles sont traitées en parallèle),
+ * 2. une seule passe de remplacement où chaque pixel mélange, par
+ *    interpolation bilinéaire en virgule fixe, les tables des quatre
+ *    tuiles dont les centres l'entourent. Les tables d'une rangée de
+ *    tuiles sont d'abord mélangées verticalement pour la ligne (tables
+ *    contiguës, SSE2), ce qui laisse deux lectures de table par pixel au
+ *    lieu de quatre ; le mélange horizontal et, en couleur, l'ajout de la
+ *    variation de luminance se font aussi en SSE2.
+ * Pour la couleur, seule la luminance change : on ajoute à R, G et B la
+ * variation de Y, ce qui laisse U et V intacts.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpclahe.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define CLAHE_GRAIN 32
+
+typedef struct {
+    uint8_t *const *rows;   // Lignes de l'image (ordre mémoire)
+    int channels;           // 1 (gris) ou 3 (t_pixel)
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    int tileWidth;
+    int tileHeight;
+    double clipLimit;
+    uint8_t *luts;          // tilesY * tilesX tables de 256 valeurs
+    const int *colTile0;    // Pour chaque colonne : tuile de gauche,
+    const int *colTile1;    // tuile de droite
+    const int *colWeight;   // et poids de la tuile de droite (0 à 256)
+    int mixLuts;            // 1 : passe 2 par tables mélangées verticalement (clahe_mixLuts)
+    uint8_t *scratch;       // Mémoire de travail de la passe 2, scratchSize octets par paquet
+    size_t scratchSize;     // de CLAHE_GRAIN lignes
+    atomic_int failed;      // Une bande de la passe 1 n'a pas pu allouer sa mémoire
+} t_clahe_pass;
+
+
+static inline uint8_t clahe_clamp(int v) {
+    return (uint8_t)((v < 0) ? 0 : ((v > 255) ? 255 : v));
+}
+
+
+/*
+ * Plafonne l'histogramme d'une tuile, répartit l'excédent sur toutes les
+ * cases puis construit la table d'égalisation
+ */
+static void clahe_buildLut(uint32_t hist[256], uint32_t count, double clipLimit, uint8_t *lut) {
+    if (count == 0) {
+        for (int v = 0; v < 256; v++) {
+            lut[v] = (uint8_t)v;
+        }
+        return;
+    }
+
+    if (clipLimit > 1.0) {
+        uint32_t limit = (uint32_t)(clipLimit * count / 256.0);
+        if (limit < 1) {
+            limit = 1;
+        }
+
+        uint32_t excess = 0;
+        for (int v = 0; v < 256; v++) {
+            if (hist[v] > limit) {
+                excess += hist[v] - limit;
+                hist[v] = limit;
+            }
+        }
+
+        uint32_t add = excess / 256;
+        uint32_t residual = excess % 256;
+        for (int v = 0; v < 256; v++) {
+            hist[v] += add;
+        }
+        for (uint32_t i = 0; i < residual; i++) {
+            hist[i * 256 / residual]++;
+        }
+    }
+
+    uint64_t cdf = 0;
+    for (int v = 0; v < 256; v++) {
+        cdf += hist[v];
+        lut[v] = (uint8_t)((cdf * 255 + count / 2) / count);
+    }
+}
+
+
+/* Passe 1 : une bande = une rangée de tuiles */
+static void clahe_tileBand(void *arg, int begin, int end) {
+    t_clahe_pass *pass = (t_clahe_pass *)arg;
+    uint32_t *hists = (uint32_t *)malloc((size_t)pass->tilesX * 256 * sizeof(uint32_t));
+    uint8_t *luma = (pass->channels == 3) ? (uint8_t *)malloc(pass->width) : NULL;
+
+    if (hists == NULL || (pass->channels == 3 && luma == NULL)) {
+        printf("Erreur: Impossible d'allouer les histogrammes CLAHE\n");
+        free(hists);
+        free(luma);
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int ty = begin; ty < end; ty++) {
+        int y0 = ty * pass->tileHeight;
+        int y1 = (y0 + pass->tileHeight < pass->height) ? y0 + pass->tileHeight : pass->height;
+
+        memset(hists, 0, (size_t)pass->tilesX * 256 * sizeof(uint32_t));
+        for (int y = y0; y < y1; y++) {
+            const uint8_t *row = pass->rows[y];
+            if (pass->channels == 3) {
+                bmp24_lumaRow((const t_pixel *)row, luma, pass->width);
+                row = luma;
+            }
+            for (int x = 0; x < pass->width; x++) {
+                hists[(x / pass->tileWidth) * 256 + row[x]]++;
+            }
+        }
+
+        for (int tx = 0; tx < pass->tilesX; tx++) {
+            int x0 = tx * pass->tileWidth;
+            int x1 = (x0 + pass->tileWidth < pass->width) ? x0 + pass->tileWidth : pass->width;
+            uint32_t count = (x1 > x0 && y1 > y0) ? (uint32_t)(x1 - x0) * (y1 - y0) : 0;
+            clahe_buildLut(hists + tx * 256, count, pass->clipLimit,
+                           pass->luts + ((size_t)ty * pass->tilesX + tx) * 256);
+        }
+    }
+
+    free(hists);
+    free(luma);
+}
+
+
+/* Position d'une coordonnée par rapport aux centres des tuiles */
+static void clahe_locate(int pos, int tileSize, int tiles, int *t0, int *t1, int *weight) {
+    double f = (pos + 0.5) / tileSize - 0.5;
+    int base = (int)floor(f);
+
+    if (base < 0) {
+        *t0 = *t1 = 0;
+        *weight = 0;
+    } else if (base >= tiles - 1) {
+        *t0 = *t1 = tiles - 1;
+        *weight = 0;
+    } else {
+        *t0 = base;
+        *t1 = base + 1;
+        *weight = (int)((f - base) * 256.0 + 0.5);
+    }
+}
+
+
+/*
+ * Passe 2, interpolation verticale d'une rangée de tuiles : pour chaque
+ * tuile t et chaque valeur v, mixed[t * 256 + v] = haut * (256 - wy) + bas * wy
+ * (255 * 256 au plus, tient sur 16 bits). Les tables sont contiguës : SSE2,
+ * 16 entrées à la fois.
+ */
+static void clahe_mixLuts(const uint8_t *lutTop, const uint8_t *lutBottom, int wy, uint16_t *mixed, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i wTop = _mm_set1_epi16((short)(256 - wy));
+    __m128i wBottom = _mm_set1_epi16((short)wy);
+    for (; i + 16 <= n; i += 16) {
+        __m128i t = _mm_loadu_si128((const __m128i *)(lutTop + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(lutBottom + i));
+        _mm_storeu_si128((__m128i *)(mixed + i),
+                         _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(t, zero), wTop),
+                                       _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wBottom)));
+        _mm_storeu_si128((__m128i *)(mixed + i + 8),
+                         _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(t, zero), wTop),
+                                       _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wBottom)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        mixed[i] = (uint16_t)(lutTop[i] * (256 - wy) + lutBottom[i] * wy);
+    }
+}
+
+
+/*
+ * Passe 2, interpolation horizontale : out[x] = (mixed[gauche][v] * (256 - wx)
+ * + mixed[droite][v] * wx + 32768) >> 16, soit exactement l'interpolation
+ * bilinéaire des quatre tables. Deux lectures de table par pixel, restées
+ * scalaires ; le calcul sur 32 bits se fait 8 pixels à la fois en SSE2.
+ * out peut être gray.
+ */
+static void clahe_blendRow(const t_clahe_pass *pass, const uint8_t *gray, const uint16_t *mixed, uint8_t *out) {
+    const int *tile0 = pass->colTile0;
+    const int *tile1 = pass->colTile1;
+    const int *weight = pass->colWeight;
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i full = _mm_set1_epi16(256);
+    __m128i round = _mm_set1_epi32(32768);
+    for (; x + 8 <= pass->width; x += 8) {
+        const int *t0 = tile0 + x, *t1 = tile1 + x;
+        const uint8_t *v = gray + x;
+        __m128i left = _mm_setr_epi16(mixed[t0[0] * 256 + v[0]], mixed[t0[1] * 256 + v[1]],
+                                      mixed[t0[2] * 256 + v[2]], mixed[t0[3] * 256 + v[3]],
+                                      mixed[t0[4] * 256 + v[4]], mixed[t0[5] * 256 + v[5]],
+                                      mixed[t0[6] * 256 + v[6]], mixed[t0[7] * 256 + v[7]]);
+        __m128i right = _mm_setr_epi16(mixed[t1[0] * 256 + v[0]], mixed[t1[1] * 256 + v[1]],
+                                       mixed[t1[2] * 256 + v[2]], mixed[t1[3] * 256 + v[3]],
+                                       mixed[t1[4] * 256 + v[4]], mixed[t1[5] * 256 + v[5]],
+                                       mixed[t1[6] * 256 + v[6]], mixed[t1[7] * 256 + v[7]]);
+        __m128i w = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)(weight + x)),
+                                    _mm_loadu_si128((const __m128i *)(weight + x + 4)));
+        __m128i iw = _mm_sub_epi16(full, w);
+        // Produits 16 x 16 bits non signés complets (mots bas et hauts), sommés sur 32 bits
+        __m128i leftLo = _mm_mullo_epi16(left, iw), leftHi = _mm_mulhi_epu16(left, iw);
+        __m128i rightLo = _mm_mullo_epi16(right, w), rightHi = _mm_mulhi_epu16(right, w);
+        __m128i sum0 = _mm_add_epi32(_mm_unpacklo_epi16(leftLo, leftHi), _mm_unpacklo_epi16(rightLo, rightHi));
+        __m128i sum1 = _mm_add_epi32(_mm_unpackhi_epi16(leftLo, leftHi), _mm_unpackhi_epi16(rightLo, rightHi));
+        sum0 = _mm_srli_epi32(_mm_add_epi32(sum0, round), 16);
+        sum1 = _mm_srli_epi32(_mm_add_epi32(sum1, round), 16);
+        __m128i value = _mm_packs_epi32(sum0, sum1);
+        _mm_storel_epi64((__m128i *)(out + x), _mm_packus_epi16(value, value));
+    }
+#endif
+
+    for (; x < pass->width; x++) {
+        int v = gray[x];
+        int wx = weight[x];
+        uint32_t sum = mixed[tile0[x] * 256 + v] * (uint32_t)(256 - wx) + mixed[tile1[x] * 256 + v] * (uint32_t)wx;
+        out[x] = (uint8_t)((sum + 32768) >> 16);
+    }
+}
+
+
+/*
+ * Passe 2 sans table intermédiaire (tuiles nombreuses pour une ligne
+ * étroite : mélanger toutes les tables coûterait plus que les pixels)
+ */
+static void clahe_blendRowDirect(const t_clahe_pass *pass, const uint8_t *gray, const uint8_t *lutTop,
+                                 const uint8_t *lutBottom, int wy, uint8_t *out) {
+    for (int x = 0; x < pass->width; x++) {
+        int v = gray[x];
+        int a = pass->colTile0[x] * 256 + v;
+        int b = pass->colTile1[x] * 256 + v;
+        int wx = pass->colWeight[x];
+        int top = lutTop[a] * (256 - wx) + lutTop[b] * wx;
+        int bottom = lutBottom[a] * (256 - wx) + lutBottom[b] * wx;
+        out[x] = (uint8_t)((top * (256 - wy) + bottom * wy + 32768) >> 16);
+    }
+}
+
+
+/*
+ * Couleur : ajoute à R, G et B la variation de luminance value - luma,
+ * bornée à [0, 255] (SSE2 : 16 pixels, soit trois registres de composantes)
+ */
+static void clahe_shiftRow(uint8_t *row, const uint8_t *luma, const uint8_t *value, int width) {
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    for (; x + 16 <= width; x += 16) {
+        // Luminance avant et après répétées sur les trois composantes de chaque pixel
+        uint8_t before[48], after[48];
+        for (int k = 0; k < 16; k++) {
+            before[3 * k] = before[3 * k + 1] = before[3 * k + 2] = luma[x + k];
+            after[3 * k] = after[3 * k + 1] = after[3 * k + 2] = value[x + k];
+        }
+        for (int q = 0; q < 3; q++) {
+            __m128i *p = (__m128i *)(row + 3 * x + 16 * q);
+            __m128i r = _mm_loadu_si128(p);
+            __m128i b = _mm_loadu_si128((const __m128i *)(before + 16 * q));
+            __m128i a = _mm_loadu_si128((const __m128i *)(after + 16 * q));
+            __m128i lo = _mm_sub_epi16(_mm_add_epi16(_mm_unpacklo_epi8(r, zero), _mm_unpacklo_epi8(a, zero)),
+                                       _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_sub_epi16(_mm_add_epi16(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(a, zero)),
+                                       _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+        }
+    }
+#endif
+
+    for (; x < width; x++) {
+        int delta = value[x] - luma[x];
+        row[x * 3] = clahe_clamp(row[x * 3] + delta);
+        row[x * 3 + 1] = clahe_clamp(row[x * 3 + 1] + delta);
+        row[x * 3 + 2] = clahe_clamp(row[x * 3 + 2] + delta);
+    }
+}
+
+
+/*
+ * Passe 2 : les lignes sont groupées par paquets de CLAHE_GRAIN ; chaque
+ * paquet a sa mémoire de travail dans pass->scratch, allouée avant la
+ * passe 1 : une fois commencé, le remplacement ne peut plus échouer
+ */
+static void clahe_remapBand(void *arg, int begin, int end) {
+    const t_clahe_pass *pass = (const t_clahe_pass *)arg;
+    int entries = pass->tilesX * 256;
+
+    for (int chunk = begin; chunk < end; chunk++) {
+        uint8_t *work = pass->scratch + (size_t)chunk * pass->scratchSize;
+        uint16_t *mixed = (uint16_t *)work;
+        uint8_t *luma = work + (pass->mixLuts ? (size_t)entries * sizeof(uint16_t) : 0);
+        uint8_t *value = luma + pass->width;
+        int last = (chunk + 1) * CLAHE_GRAIN;
+
+        for (int y = chunk * CLAHE_GRAIN; y < last && y < pass->height; y++) {
+            int ty0, ty1, wy;
+            clahe_locate(y, pass->tileHeight, pass->tilesY, &ty0, &ty1, &wy);
+
+            const uint8_t *lutTop = pass->luts + (size_t)ty0 * entries;
+            const uint8_t *lutBottom = pass->luts + (size_t)ty1 * entries;
+            uint8_t *row = pass->rows[y];
+            const uint8_t *gray = row;
+            uint8_t *out = row;
+
+            if (pass->channels == 3) {
+                bmp24_lumaRow((const t_pixel *)row, luma, pass->width);
+                gray = luma;
+                out = value;
+            }
+            if (pass->mixLuts) {
+                clahe_mixLuts(lutTop, lutBottom, wy, mixed, entries);
+                clahe_blendRow(pass, gray, mixed, out);
+            } else {
+                clahe_blendRowDirect(pass, gray, lutTop, lutBottom, wy, out);
+            }
+            if (pass->channels == 3) {
+                clahe_shiftRow(row, luma, value, pass->width);
+            }
+        }
+    }
+}
+
+
+static int clahe_run(uint8_t *const *rows, int channels, int width, int height,
+                     int tilesX, int tilesY, double clipLimit) {
+    if (tilesX < 1 || tilesY < 1 || tilesX > BMP_CLAHE_MAX_TILES || tilesY > BMP_CLAHE_MAX_TILES ||
+        tilesX > width || tilesY > height) {
+        printf("Erreur: Nombre de tuiles invalide\n");
+        return -1;
+    }
+
+    t_clahe_pass pass;
+    pass.rows = rows;
+    pass.channels = channels;
+    pass.width = width;
+    pass.height = height;
+    pass.tilesX = tilesX;
+    pass.tilesY = tilesY;
+    pass.tileWidth = (width + tilesX - 1) / tilesX;
+    pass.tileHeight = (height + tilesY - 1) / tilesY;
+    pass.clipLimit = clipLimit;
+    atomic_init(&pass.failed, 0);
+
+    // Avec des tuiles arrondies au-dessus, les dernières peuvent être vides
+    pass.tilesX = (width + pass.tileWidth - 1) / pass.tileWidth;
+    pass.tilesY = (height + pass.tileHeight - 1) / pass.tileHeight;
+
+    // Passe 2 : une table mélangée par ligne (tilesX * 256 entrées) tant
+    // qu'elle reste petite devant la ligne, et deux lignes de luminance en couleur
+    int chunks = (height + CLAHE_GRAIN - 1) / CLAHE_GRAIN;
+    pass.mixLuts = (pass.tilesX * 256 <= width * 2);
+    pass.scratchSize = (pass.mixLuts ? (size_t)pass.tilesX * 256 * sizeof(uint16_t) : 0) +
+                       ((channels == 3) ? (size_t)width * 2 : 0);
+
+    uint8_t *luts = (uint8_t *)malloc((size_t)pass.tilesX * pass.tilesY * 256);
+    int *columns = (int *)malloc((size_t)width * 3 * sizeof(int));
+    uint8_t *scratch = (uint8_t *)malloc(pass.scratchSize > 0 ? (size_t)chunks * pass.scratchSize : 1);
+    if (luts == NULL || columns == NULL || scratch == NULL) {
+        printf("Erreur: Impossible d'allouer les tables CLAHE\n");
+        free(luts);
+        free(columns);
+        free(scratch);
+        return -1;
+    }
+
+    for (int x = 0; x < width; x++) {
+        clahe_locate(x, pass.tileWidth, pass.tilesX, &columns[x], &columns[width + x], &columns[2 * width + x]);
+    }
+    pass.luts = luts;
+    pass.colTile0 = columns;
+    pass.colTile1 = columns + width;
+    pass.colWeight = columns + 2 * width;
+    pass.scratch = scratch;
+
+    // Sans toutes les tables, l'image n'est pas touchée
+    bmp_parallelFor(pass.tilesY, 1, clahe_tileBand, &pass);
+    if (atomic_load(&pass.failed) == 0) {
+        bmp_parallelFor(chunks, 1, clahe_remapBand, &pass);
+    }
+
+    free(luts);
+    free(columns);
+    free(scratch);
+    return (atomic_load(&pass.failed) == 0) ? 0 : -1;
+}
+
+
+int bmp8_clahe(t_bmp8 *img, int tilesX, int tilesY, double clipLimit) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = clahe_run(rows, 1, img->width, img->height, tilesX, tilesY, clipLimit);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_clahe(t_bmp24 *img, int tilesX, int tilesY, double clipLimit) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = clahe_run(rows, 3, img->width, img->height, tilesX, tilesY, clipLimit);
+    free(rows);
+    return status;
+}
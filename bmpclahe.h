@@ -0,0 +1,42 @@
+/**
+ * @file bmpclahe.h
+ *
+ * @brief
+ * Égalisation adaptative d'histogramme à contraste limité (CLAHE).
+ * Contrairement à l'égalisation globale, chaque zone de l'image reçoit sa
+ * propre courbe, ce qui relève les détails des zones sombres sans brûler
+ * les zones claires. Le plafond (clip limit) évite d'amplifier le bruit.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPCLAHE_H
+#define BMPCLAHE_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+/* Nombre maximal de tuiles dans chaque direction */
+#define BMP_CLAHE_MAX_TILES 64
+
+/* bmp8_clahe
+ * Rôle : Applique CLAHE à une image en niveaux de gris
+ * Paramètres :
+ *   img       - Image à modifier
+ *   tilesX    - Nombre de tuiles en largeur (1 à BMP_CLAHE_MAX_TILES, 8 en général)
+ *   tilesY    - Nombre de tuiles en hauteur
+ *   clipLimit - Plafond des histogrammes, en multiple de la hauteur moyenne
+ *               d'une case (2 à 4 en général, <= 1 : pas de plafond)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_clahe(t_bmp8 *img, int tilesX, int tilesY, double clipLimit);
+
+/* bmp24_clahe
+ * Rôle : Applique CLAHE à la luminance (Y) d'une image couleur ; la
+ *        chrominance est conservée
+ * Paramètres : Identiques à bmp8_clahe
+ */
+int bmp24_clahe(t_bmp24 *img, int tilesX, int tilesY, double clipLimit);
+
+#endif
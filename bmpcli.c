@@ -0,0 +1,159 @@
+/**
+ * @file bmpcli.c
+ *
+ * @brief
+ * Lecture des arguments puis un seul appel à bmp_streamFile : la chaîne
+ * est compilée en étapes (tables composées, filtres à fenêtre de lignes)
+ * et l'image ne passe qu'une fois de l'entrée à la sortie. Sous Windows,
+ * l'entrée et la sortie standard sont passées en mode binaire pour que
+ * les octets 0x0A et 0x1A des pixels traversent les tubes intacts.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpcli.h"
+#include "bmpchain.h"
+#include "bmpstream.h"
+#include "bmpbatch.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#define CLI_IO_BUFFER (1 << 20)
+
+
+static void cli_usage(const char *program) {
+    fprintf(stderr,
+            "Usage : %s <entrée> [étapes...] -o <sortie> [--band N] [--threads N]\n"
+            "        %s --batch <dossier source> <dossier destination> [options] [étapes...]\n"
+            "  <entrée>, <sortie> : fichier BMP 8 ou 24 bits non compressé, - pour stdin / stdout\n"
+            "  Étapes, appliquées dans l'ordre :\n"
+            "    --negative --brightness N --threshold N --grayscale\n"
+            "    --box-blur --gaussian --outline --emboss --sharpen\n"
+            "  --band N    : lignes lues à la fois (%d par défaut)\n"
+            "  --threads N : nombre de threads\n",
+            program, program, BMP_STREAM_DEFAULT_BAND);
+}
+
+
+/*
+ * Ouvre un fichier, ou l'entrée / la sortie standard pour "-"
+ */
+static FILE *cli_open(const char *path, int output) {
+    if (strcmp(path, "-") != 0) {
+        FILE *file = fopen(path, output ? "wb" : "rb");
+        if (file == NULL) {
+            fprintf(stderr, "Erreur: Impossible d'ouvrir %s\n", path);
+        }
+        return file;
+    }
+
+    FILE *file = output ? stdout : stdin;
+#ifdef _WIN32
+    _setmode(_fileno(file), _O_BINARY);
+#endif
+    return file;
+}
+
+
+/*
+ * Lit la valeur entière d'une option (argv[*index + 1])
+ */
+static int cli_value(int argc, char **argv, int *index, int *value) {
+    char *end = NULL;
+    if (*index + 1 >= argc) {
+        fprintf(stderr, "Erreur: %s attend une valeur\n", argv[*index]);
+        return -1;
+    }
+    *value = (int)strtol(argv[*index + 1], &end, 10);
+    if (end == argv[*index + 1] || *end != '\0') {
+        fprintf(stderr, "Erreur: %s attend une valeur entière\n", argv[*index]);
+        return -1;
+    }
+    *index += 2;
+    return 0;
+}
+
+
+int bmp_cliMain(int argc, char **argv) {
+    const char *program = (argc > 0) ? argv[0] : "main";
+
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        return bmp_batchMain(argc - 1, argv + 1);
+    }
+
+    t_bmp_chain *chain = bmp_chainCreate();
+    if (chain == NULL) {
+        return 1;
+    }
+
+    const char *input = NULL;
+    const char *output = NULL;
+    int bandRows = 0;
+    int threads = 0;
+    int status = 0;
+
+    int i = 1;
+    while (i < argc && status == 0) {
+        int parsed = bmp_chainParse(chain, argc, argv, &i);
+        if (parsed != 0) {
+            status = (parsed < 0) ? -1 : 0;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc && output == NULL) {
+            output = argv[i + 1];
+            i += 2;
+        } else if (strcmp(argv[i], "--band") == 0) {
+            status = cli_value(argc, argv, &i, &bandRows);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            status = cli_value(argc, argv, &i, &threads);
+        } else if ((argv[i][0] != '-' || strcmp(argv[i], "-") == 0) && input == NULL) {
+            input = argv[i++];
+        } else {
+            fprintf(stderr, "Erreur: Argument invalide : %s\n", argv[i]);
+            status = -1;
+        }
+    }
+
+    if (status != 0 || input == NULL || output == NULL) {
+        cli_usage(program);
+        bmp_chainFree(chain);
+        return 1;
+    }
+    if (threads > 0) {
+        bmp_setThreadCount(threads);
+    }
+
+    FILE *in = cli_open(input, 0);
+    FILE *out = (in != NULL) ? cli_open(output, 1) : NULL;
+    if (out == NULL) {
+        if (in != NULL && in != stdin) {
+            fclose(in);
+        }
+        bmp_chainFree(chain);
+        return 1;
+    }
+
+    // Grands tampons : les bandes sont lues et écrites d'un bloc
+    setvbuf(in, NULL, _IOFBF, CLI_IO_BUFFER);
+    setvbuf(out, NULL, _IOFBF, CLI_IO_BUFFER);
+
+    status = bmp_streamFile(in, out, chain, bandRows);
+
+    if (in != stdin) {
+        fclose(in);
+    }
+    int closed = (out != stdout) ? fclose(out) : fflush(out);
+    if (closed != 0 && status == 0) {
+        fprintf(stderr, "Erreur: Impossible d'écrire %s\n", output);
+        status = -1;
+    }
+
+    bmp_chainFree(chain);
+    return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file bmpcli.h
+ *
+ * @brief
+ * Ligne de commande non interactive de l'exécutable : une image, une
+ * suite d'opérations, une destination.
+ *
+ *   main entree.bmp --brightness 20 --gaussian --sharpen -o sortie.bmp
+ *   cat entree.bmp | main - --negative --box-blur -o - | main - --emboss -o sortie.bmp
+ *
+ * Toute la chaîne est exécutée en une seule lecture du fichier (bmpstream.h) :
+ * les opérations ponctuelles qui se suivent sont composées en une table,
+ * et chaque bande de lignes traverse tous les filtres avant d'être écrite.
+ * Un script n'a donc plus besoin de fichiers intermédiaires entre deux
+ * opérations.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPCLI_H
+#define BMPCLI_H
+
+/* bmp_cliMain
+ * Rôle : Interprète la ligne de commande et exécute la chaîne
+ *        <entrée> [étapes de bmp_chainParse...] -o <sortie>
+ *        [--band N] [--threads N]
+ *        "-" désigne l'entrée ou la sortie standard ; --batch passe au
+ *        traitement d'un dossier (bmp_batchMain)
+ * Paramètres :
+ *   argc, argv - Arguments reçus par main
+ * Retour : Code de sortie du programme (0 si réussi, 1 sinon)
+ * Note : Les messages vont sur la sortie d'erreur, la sortie standard
+ *        pouvant recevoir l'image
+ */
+int bmp_cliMain(int argc, char **argv);
+
+#endif
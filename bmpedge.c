@@ -0,0 +1,217 @@
+/**
+ * @file bmpedge.c
+ *
+ * @brief
+ * Gradient de Sobel / Scharr fusionné : pour chaque ligne on calcule Gx,
+ * Gy puis la norme (et l'orientation si demandée) sans jamais stocker
+ * d'image intermédiaire complète. Les opérateurs sont séparables, la boucle
+ * intérieure ne contient donc que des additions sur des lignes contiguës.
+ * Pour une image couleur, la luminance est calculée au vol sur trois lignes.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpedge.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#define EDGE_GRAIN 16
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct {
+    const uint8_t *const *src;   // Lignes source de haut en bas
+    int channels;                // 1 (gris) ou 3 (t_pixel)
+    int width;
+    int height;
+    t_gradient_op op;
+    t_magnitude_norm norm;
+    uint8_t *const *magnitude;   // Lignes destination de haut en bas
+    uint8_t *const *orientation; // NULL si non demandée
+    atomic_int failed;           // Une bande n'a pas pu allouer ses tampons
+} t_gradient_pass;
+
+
+int bmp_gradientWeight(t_gradient_op op) {
+    return (op == BMP_GRADIENT_SCHARR) ? 16 : 4;
+}
+
+
+void bmp_gradientRow(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                     int width, t_gradient_op op, int16_t *gx, int16_t *gy) {
+    int side = (op == BMP_GRADIENT_SCHARR) ? 3 : 1;
+    int mid = (op == BMP_GRADIENT_SCHARR) ? 10 : 2;
+
+    if (width == 1) {
+        gx[0] = 0;
+        gy[0] = (int16_t)((2 * side + mid) * (below[0] - above[0]));
+        return;
+    }
+
+    // Colonnes intérieures : aucune condition dans la boucle
+    for (int x = 1; x < width - 1; x++) {
+        int left = side * above[x - 1] + mid * row[x - 1] + side * below[x - 1];
+        int right = side * above[x + 1] + mid * row[x + 1] + side * below[x + 1];
+        gx[x] = (int16_t)(right - left);
+        gy[x] = (int16_t)(side * (below[x - 1] - above[x - 1]) + mid * (below[x] - above[x]) +
+                          side * (below[x + 1] - above[x + 1]));
+    }
+
+    // Bords répliqués
+    int last = width - 1;
+    gx[0] = (int16_t)(side * (above[1] - above[0]) + mid * (row[1] - row[0]) + side * (below[1] - below[0]));
+    gy[0] = (int16_t)((side + mid) * (below[0] - above[0]) + side * (below[1] - above[1]));
+    gx[last] = (int16_t)(side * (above[last] - above[last - 1]) + mid * (row[last] - row[last - 1]) +
+                         side * (below[last] - below[last - 1]));
+    gy[last] = (int16_t)(side * (below[last - 1] - above[last - 1]) + (side + mid) * (below[last] - above[last]));
+}
+
+
+/*
+ * Donne la ligne y en niveaux de gris ; pour une image couleur la
+ * luminance est mise en cache dans un anneau de trois lignes
+ */
+static const uint8_t *gradient_grayRow(const t_gradient_pass *pass, int y, uint8_t **ring, int *tags) {
+    if (y < 0) {
+        y = 0;
+    } else if (y >= pass->height) {
+        y = pass->height - 1;
+    }
+    if (pass->channels == 1) {
+        return pass->src[y];
+    }
+
+    int slot = y % 3;
+    if (tags[slot] != y) {
+        bmp24_lumaRow((const t_pixel *)pass->src[y], ring[slot], pass->width);
+        tags[slot] = y;
+    }
+    return ring[slot];
+}
+
+
+static void gradient_band(void *arg, int begin, int end) {
+    t_gradient_pass *pass = (t_gradient_pass *)arg;
+    int width = pass->width;
+    int weight = bmp_gradientWeight(pass->op);
+
+    int16_t *gx = (int16_t *)malloc(width * 2 * sizeof(int16_t));
+    uint8_t *block = (pass->channels == 3) ? (uint8_t *)malloc(width * 3) : NULL;
+    if (gx == NULL || (pass->channels == 3 && block == NULL)) {
+        printf("Erreur: Impossible d'allouer les tampons du gradient\n");
+        free(gx);
+        free(block);
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+    int16_t *gy = gx + width;
+    uint8_t *ring[3] = {block, block + width, block + 2 * width};
+    int tags[3] = {-1, -1, -1};
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *above = gradient_grayRow(pass, y - 1, ring, tags);
+        const uint8_t *row = gradient_grayRow(pass, y, ring, tags);
+        const uint8_t *below = gradient_grayRow(pass, y + 1, ring, tags);
+
+        bmp_gradientRow(above, row, below, width, pass->op, gx, gy);
+
+        uint8_t *mag = pass->magnitude[y];
+        if (pass->norm == BMP_MAGNITUDE_L1) {
+            for (int x = 0; x < width; x++) {
+                int m = (abs(gx[x]) + abs(gy[x])) / weight;
+                mag[x] = (uint8_t)((m > 255) ? 255 : m);
+            }
+        } else {
+            float scale = 1.0f / weight;
+            for (int x = 0; x < width; x++) {
+                float m = sqrtf((float)(gx[x] * gx[x] + gy[x] * gy[x])) * scale;
+                mag[x] = (uint8_t)((m > 255.0f) ? 255 : (int)(m + 0.5f));
+            }
+        }
+
+        if (pass->orientation != NULL) {
+            uint8_t *dir = pass->orientation[y];
+            for (int x = 0; x < width; x++) {
+                // Repère mathématique : y vers le haut, d'où le signe de gy
+                float angle = atan2f((float)-gy[x], (float)gx[x]);
+                dir[x] = (uint8_t)((int)lroundf(angle * (float)(128.0 / M_PI)) & 255);
+            }
+        }
+    }
+
+    free(gx);
+    free(block);
+}
+
+
+static t_bmp8 *gradient_run(const uint8_t *const *src, int channels, int width, int height,
+                            t_gradient_op op, t_magnitude_norm norm, t_bmp8 **orientation) {
+    t_bmp8 *magnitude = bmp8_allocate(width, height);
+    t_bmp8 *direction = (orientation != NULL) ? bmp8_allocate(width, height) : NULL;
+    uint8_t **magRows = (magnitude != NULL) ? bmp8_getTopDownRows(magnitude) : NULL;
+    uint8_t **dirRows = (direction != NULL) ? bmp8_getTopDownRows(direction) : NULL;
+
+    if (magRows == NULL || (orientation != NULL && dirRows == NULL)) {
+        free(magRows);
+        free(dirRows);
+        bmp8_free(magnitude);
+        bmp8_free(direction);
+        return NULL;
+    }
+
+    t_gradient_pass pass = {src, channels, width, height, op, norm, magRows, dirRows};
+    atomic_init(&pass.failed, 0);
+    bmp_parallelFor(height, EDGE_GRAIN, gradient_band, &pass);
+
+    free(magRows);
+    free(dirRows);
+    if (atomic_load(&pass.failed) != 0) {
+        bmp8_free(magnitude);
+        bmp8_free(direction);
+        return NULL;
+    }
+    if (orientation != NULL) {
+        *orientation = direction;
+    }
+    return magnitude;
+}
+
+
+t_bmp8 *bmp8_gradient(t_bmp8 *img, t_gradient_op op, t_magnitude_norm norm, t_bmp8 **orientation) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    uint8_t **src = bmp8_getTopDownRows(img);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp8 *result = gradient_run((const uint8_t *const *)src, 1, img->width, img->height, op, norm, orientation);
+    free(src);
+    return result;
+}
+
+
+t_bmp8 *bmp24_gradient(t_bmp24 *img, t_gradient_op op, t_magnitude_norm norm, t_bmp8 **orientation) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    uint8_t **src = bmp24_getRows(img);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp8 *result = gradient_run((const uint8_t *const *)src, 3, img->width, img->height, op, norm, orientation);
+    free(src);
+    return result;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file bmpedge.h
+ *
+ * @brief
+ * Détection de contours par gradient (opérateurs de Sobel et de Scharr).
+ * Le gradient horizontal Gx, le gradient vertical Gy, la norme et
+ * éventuellement l'orientation sont calculés en une seule passe sur
+ * l'image ; le résultat est une image 8 bits.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPEDGE_H
+#define BMPEDGE_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+/*
+ * Opérateurs de dérivation 3x3
+ */
+typedef enum {
+    BMP_GRADIENT_SOBEL,   // Lissage [1 2 1]
+    BMP_GRADIENT_SCHARR   // Lissage [3 10 3] (meilleure isotropie)
+} t_gradient_op;
+
+/*
+ * Norme utilisée pour combiner Gx et Gy
+ */
+typedef enum {
+    BMP_MAGNITUDE_L1,     // |Gx| + |Gy| (plus rapide)
+    BMP_MAGNITUDE_L2      // racine(Gx² + Gy²)
+} t_magnitude_norm;
+
+/* bmp_gradientRow
+ * Rôle : Calcule Gx et Gy pour une ligne à partir de ses deux voisines
+ * Paramètres :
+ *   above, row, below - Lignes y-1, y et y+1 (niveaux de gris, de haut en bas)
+ *   width             - Nombre de pixels par ligne
+ *   op                - Opérateur (Sobel ou Scharr)
+ *   gx, gy            - Tableaux de sortie (width valeurs chacun)
+ * Note : Les bords gauche et droit sont répliqués. Gy est positif quand
+ *        l'intensité augmente vers le bas.
+ */
+void bmp_gradientRow(const uint8_t *above, const uint8_t *row, const uint8_t *below,
+                     int width, t_gradient_op op, int16_t *gx, int16_t *gy);
+
+/* bmp_gradientWeight
+ * Rôle : Somme des coefficients de lissage de l'opérateur (4 pour Sobel,
+ *        16 pour Scharr), pour ramener la norme dans [0, 255]
+ */
+int bmp_gradientWeight(t_gradient_op op);
+
+/* bmp8_gradient
+ * Rôle : Calcule la norme du gradient d'une image en niveaux de gris
+ * Paramètres :
+ *   img         - Image source (non modifiée)
+ *   op          - Opérateur de dérivation
+ *   norm        - Norme L1 ou L2
+ *   orientation - Si non NULL, reçoit une image 8 bits de l'orientation du
+ *                 gradient (0..255 pour 0..360 degrés, sens trigonométrique)
+ * Retour : Image de la norme du gradient ou NULL si erreur
+ */
+t_bmp8 *bmp8_gradient(t_bmp8 *img, t_gradient_op op, t_magnitude_norm norm, t_bmp8 **orientation);
+
+/* bmp24_gradient
+ * Rôle : Identique à bmp8_gradient, calculé sur la luminance d'une image couleur
+ */
+t_bmp8 *bmp24_gradient(t_bmp24 *img, t_gradient_op op, t_magnitude_norm norm, t_bmp8 **orientation);
+
+#endif
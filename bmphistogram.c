@@ -0,0 +1,337 @@
+/**
+ * @file bmphistogram.c
+ *
+ * @brief
+ * Histogrammes rapides. Incrémenter une seule table crée une dépendance
+ * entre deux pixels de même valeur (fréquent dans les zones uniformes) :
+ * on répartit donc les pixels sur quatre tables fusionnées à la fin. Chaque
+ * thread compte sa bande de lignes puis ajoute son résultat au total.
+ * Les tables de correspondance (LUT) déduites des histogrammes sont
+ * appliquées ici aussi, en une passe parallèle.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmphistogram.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define HISTOGRAM_GRAIN 64
+
+typedef struct {
+    uint8_t **rows;
+    int width;
+    int channels;
+    int luma;                // 1 : histogramme de la luminance des t_pixel
+    uint32_t *hist;          // channels histogrammes de 256 cases
+    pthread_mutex_t lock;
+    atomic_int failed;       // Une bande n'a pas pu allouer son tampon
+} t_histogram_pass;
+
+typedef struct {
+    uint8_t **rows;
+    int width;
+    int channels;
+    int luma;                // 1 : table appliquée à la luminance des t_pixel
+    const uint8_t *luts;     // channels tables de 256 valeurs
+    atomic_int failed;       // Une bande n'a pas pu allouer son tampon
+} t_lut_pass;
+
+
+static inline uint8_t histogram_clamp(int v) {
+    return (uint8_t)((v < 0) ? 0 : ((v > 255) ? 255 : v));
+}
+
+
+/* Compte une ligne dans quatre tables partielles */
+static inline void histogram_count4(const uint8_t *row, int count, int step, uint32_t sub[4][256]) {
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        sub[0][row[(size_t)x * step]]++;
+        sub[1][row[(size_t)(x + 1) * step]]++;
+        sub[2][row[(size_t)(x + 2) * step]]++;
+        sub[3][row[(size_t)(x + 3) * step]]++;
+    }
+    for (; x < count; x++) {
+        sub[0][row[(size_t)x * step]]++;
+    }
+}
+
+
+static inline void histogram_merge4(uint32_t sub[4][256], uint32_t hist[256]) {
+    for (int v = 0; v < 256; v++) {
+        hist[v] += sub[0][v] + sub[1][v] + sub[2][v] + sub[3][v];
+    }
+}
+
+
+void bmp_histogramRow(const uint8_t *row, int count, int step, uint32_t hist[256]) {
+    uint32_t sub[4][256];
+    memset(sub, 0, sizeof(sub));
+    histogram_count4(row, count, step, sub);
+    histogram_merge4(sub, hist);
+}
+
+
+static void histogram_band(void *arg, int begin, int end) {
+    t_histogram_pass *pass = (t_histogram_pass *)arg;
+    uint32_t sub[4][4][256];
+    uint8_t *luma = NULL;
+
+    if (pass->luma && (luma = (uint8_t *)malloc(pass->width)) == NULL) {
+        printf("Erreur: Impossible d'allouer le tampon de luminance\n");
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    memset(sub, 0, sizeof(sub));
+    for (int y = begin; y < end; y++) {
+        if (pass->luma) {
+            bmp24_lumaRow((const t_pixel *)pass->rows[y], luma, pass->width);
+            histogram_count4(luma, pass->width, 1, sub[0]);
+            continue;
+        }
+        for (int c = 0; c < pass->channels; c++) {
+            histogram_count4(pass->rows[y] + c, pass->width, pass->channels, sub[c]);
+        }
+    }
+    free(luma);
+
+    pthread_mutex_lock(&pass->lock);
+    for (int c = 0; c < pass->channels; c++) {
+        histogram_merge4(sub[c], pass->hist + c * 256);
+    }
+    pthread_mutex_unlock(&pass->lock);
+}
+
+
+/* Retour : 0 si toutes les bandes sont comptées, -1 sinon */
+static int histogram_run(uint8_t **rows, int width, int height, int channels, int luma, uint32_t *hist) {
+    t_histogram_pass pass;
+    pass.rows = rows;
+    pass.width = width;
+    pass.channels = channels;
+    pass.luma = luma;
+    pass.hist = hist;
+    pthread_mutex_init(&pass.lock, NULL);
+    atomic_init(&pass.failed, 0);
+
+    memset(hist, 0, (size_t)channels * 256 * sizeof(uint32_t));
+    bmp_parallelFor(height, HISTOGRAM_GRAIN, histogram_band, &pass);
+
+    pthread_mutex_destroy(&pass.lock);
+    return (atomic_load(&pass.failed) != 0) ? -1 : 0;
+}
+
+
+int bmp8_histogram(t_bmp8 *img, uint32_t hist[256]) {
+    if (img == NULL || img->data == NULL || hist == NULL) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_run(rows, img->width, img->height, 1, 0, hist);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_histogram(t_bmp24 *img, uint32_t hist[3][256]) {
+    if (img == NULL || img->data == NULL || hist == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_run(rows, img->width, img->height, 3, 0, &hist[0][0]);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_lumaHistogram(t_bmp24 *img, uint32_t hist[256]) {
+    if (img == NULL || img->data == NULL || hist == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_run(rows, img->width, img->height, 1, 1, hist);
+    free(rows);
+    return status;
+}
+
+
+uint64_t bmp_histogramCDF(const uint32_t hist[256], uint64_t cdf[256]) {
+    uint64_t total = 0;
+    for (int v = 0; v < 256; v++) {
+        total += hist[v];
+        cdf[v] = total;
+    }
+    return total;
+}
+
+
+static void histogram_lutBand(void *arg, int begin, int end) {
+    t_lut_pass *pass = (t_lut_pass *)arg;
+    uint8_t *luma = NULL;
+
+    if (pass->luma && (luma = (uint8_t *)malloc(pass->width)) == NULL) {
+        printf("Erreur: Impossible d'allouer le tampon de luminance\n");
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *row = pass->rows[y];
+        if (pass->luma) {
+            // On ajoute à R, G et B la variation de Y : la chrominance est conservée
+            bmp24_lumaRow((const t_pixel *)row, luma, pass->width);
+            for (int x = 0; x < pass->width; x++) {
+                int delta = pass->luts[luma[x]] - luma[x];
+                row[x * 3] = histogram_clamp(row[x * 3] + delta);
+                row[x * 3 + 1] = histogram_clamp(row[x * 3 + 1] + delta);
+                row[x * 3 + 2] = histogram_clamp(row[x * 3 + 2] + delta);
+            }
+        } else if (pass->channels == 1) {
+            for (int x = 0; x < pass->width; x++) {
+                row[x] = pass->luts[row[x]];
+            }
+        } else if (pass->channels == 3) {
+            const uint8_t *lut0 = pass->luts;
+            const uint8_t *lut1 = pass->luts + 256;
+            const uint8_t *lut2 = pass->luts + 512;
+            for (int x = 0; x < pass->width; x++) {
+                row[x * 3] = lut0[row[x * 3]];
+                row[x * 3 + 1] = lut1[row[x * 3 + 1]];
+                row[x * 3 + 2] = lut2[row[x * 3 + 2]];
+            }
+        } else {
+            for (int x = 0; x < pass->width; x++) {
+                for (int c = 0; c < pass->channels; c++) {
+                    row[x * pass->channels + c] = pass->luts[c * 256 + row[x * pass->channels + c]];
+                }
+            }
+        }
+    }
+
+    free(luma);
+}
+
+
+/* Retour : 0 si toutes les bandes sont modifiées, -1 sinon */
+static int histogram_lutRun(uint8_t **rows, int width, int height, int channels, int luma, const uint8_t *luts) {
+    t_lut_pass pass;
+    pass.rows = rows;
+    pass.width = width;
+    pass.channels = channels;
+    pass.luma = luma;
+    pass.luts = luts;
+    atomic_init(&pass.failed, 0);
+
+    bmp_parallelFor(height, HISTOGRAM_GRAIN, histogram_lutBand, &pass);
+    return (atomic_load(&pass.failed) != 0) ? -1 : 0;
+}
+
+
+int bmp8_applyLut(t_bmp8 *img, const uint8_t lut[256]) {
+    if (img == NULL || img->data == NULL || lut == NULL) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_lutRun(rows, img->width, img->height, 1, 0, lut);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_applyLut(t_bmp24 *img, const uint8_t luts[3][256]) {
+    if (img == NULL || img->data == NULL || luts == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_lutRun(rows, img->width, img->height, 3, 0, &luts[0][0]);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_applyLumaLut(t_bmp24 *img, const uint8_t lut[256]) {
+    if (img == NULL || img->data == NULL || lut == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_lutRun(rows, img->width, img->height, 3, 1, lut);
+    free(rows);
+    return status;
+}
+
+
+int bmp_viewHistogram(const t_bmp_view *view, uint32_t *hist) {
+    if (hist == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp_viewRows(view);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_run(rows, view->width, view->height, view->channels, 0, hist);
+    free(rows);
+    return status;
+}
+
+
+int bmp_viewApplyLut(const t_bmp_view *view, const uint8_t *luts) {
+    if (luts == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp_viewRows(view);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = histogram_lutRun(rows, view->width, view->height, view->channels, 0, luts);
+    free(rows);
+    return status;
+}
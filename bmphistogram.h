@@ -0,0 +1,107 @@
+/**
+ * @file bmphistogram.h
+ *
+ * @brief
+ * Calcul d'histogrammes sur les images BMP. L'histogramme est la base des
+ * traitements automatiques (choix de seuil, statistiques, égalisation) :
+ * une seule lecture de l'image suffit à les alimenter, puis une table de
+ * correspondance applique le résultat en une seconde lecture.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPHISTOGRAM_H
+#define BMPHISTOGRAM_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/* bmp_histogramRow
+ * Rôle : Ajoute les valeurs d'une ligne à un histogramme
+ * Paramètres :
+ *   row    - Début de la ligne (premier octet à compter)
+ *   count  - Nombre de valeurs à compter
+ *   step   - Écart en octets entre deux valeurs (1 pour du gris, 3 pour
+ *            une composante de t_pixel)
+ *   hist   - Histogramme de 256 cases à compléter
+ */
+void bmp_histogramRow(const uint8_t *row, int count, int step, uint32_t hist[256]);
+
+/* bmp8_histogram
+ * Rôle : Calcule l'histogramme d'une image 8 bits (padding exclu)
+ * Paramètres :
+ *   img  - Image source
+ *   hist - Histogramme de sortie (256 cases, remis à zéro)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_histogram(t_bmp8 *img, uint32_t hist[256]);
+
+/* bmp24_histogram
+ * Rôle : Calcule les histogrammes des trois composantes en une seule lecture
+ * Paramètres :
+ *   img  - Image source
+ *   hist - Histogrammes de sortie : hist[0] rouge, hist[1] vert, hist[2] bleu
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_histogram(t_bmp24 *img, uint32_t hist[3][256]);
+
+/* bmp24_lumaHistogram
+ * Rôle : Calcule l'histogramme de la luminance Y (voir bmp24_lumaRow)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_lumaHistogram(t_bmp24 *img, uint32_t hist[256]);
+
+/* bmp_histogramCDF
+ * Rôle : Calcule l'histogramme cumulé (fonction de répartition non normalisée)
+ * Paramètres :
+ *   hist - Histogramme de 256 cases
+ *   cdf  - Reçoit cdf[v] = nombre de pixels <= v
+ * Retour : Nombre total de pixels (cdf[255])
+ */
+uint64_t bmp_histogramCDF(const uint32_t hist[256], uint64_t cdf[256]);
+
+/* bmp8_applyLut
+ * Rôle : Remplace chaque pixel v par lut[v]
+ * Paramètres :
+ *   img - Image à modifier
+ *   lut - Table de correspondance de 256 valeurs
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_applyLut(t_bmp8 *img, const uint8_t lut[256]);
+
+/* bmp24_applyLut
+ * Rôle : Applique une table par composante (luts[0] rouge, luts[1] vert, luts[2] bleu)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_applyLut(t_bmp24 *img, const uint8_t luts[3][256]);
+
+/* bmp24_applyLumaLut
+ * Rôle : Applique une table à la luminance Y : la variation de Y est ajoutée
+ *        à R, G et B, ce qui conserve la chrominance
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_applyLumaLut(t_bmp24 *img, const uint8_t lut[256]);
+
+/* bmp_viewHistogram
+ * Rôle : Calcule les histogrammes de chaque composante d'une zone d'image
+ * Paramètres :
+ *   view - Zone source
+ *   hist - view->channels histogrammes de 256 cases, dans l'ordre des
+ *          octets du pixel (R, G, B pour t_pixel ; B, G, R, A pour t_pixel32)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_viewHistogram(const t_bmp_view *view, uint32_t *hist);
+
+/* bmp_viewApplyLut
+ * Rôle : Applique une table par composante à une zone d'image
+ * Paramètres :
+ *   view - Zone à modifier
+ *   luts - view->channels tables de 256 valeurs, même ordre que bmp_viewHistogram
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_viewApplyLut(const t_bmp_view *view, const uint8_t *luts);
+
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file bmpintegral.c
+ *
+ * @brief
+ * Construction parallèle des images intégrales en deux passes :
+ * - sommes cumulées le long de chaque ligne (les lignes sont indépendantes),
+ * - cumul vertical par blocs de colonnes (les blocs sont indépendants et
+ *   chaque ligne d'un bloc est parcourue de façon contiguë).
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpintegral.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INTEGRAL_GRAIN 32
+#define INTEGRAL_COLUMN_BLOCK 512
+
+typedef struct {
+    const uint8_t *const *rows;
+    t_integral *integral;
+} t_integral_pass;
+
+
+static inline size_t integral_planeSize(const t_integral *integral) {
+    return (size_t)(integral->width + 1) * (integral->height + 1);
+}
+
+
+/* Passe 1 : sommes cumulées horizontales, ligne y de l'image -> ligne y + 1 */
+static void integral_rowBand(void *arg, int begin, int end) {
+    const t_integral_pass *pass = (const t_integral_pass *)arg;
+    const t_integral *ii = pass->integral;
+    size_t plane = integral_planeSize(ii);
+    int w1 = ii->width + 1;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *src = pass->rows[y];
+        for (int c = 0; c < ii->channels; c++) {
+            uint64_t *s = ii->sum + c * plane + (size_t)(y + 1) * w1;
+            uint64_t *q = ii->sqsum + c * plane + (size_t)(y + 1) * w1;
+            uint64_t rowSum = 0, rowSq = 0;
+
+            s[0] = 0;
+            q[0] = 0;
+            for (int x = 0; x < ii->width; x++) {
+                uint32_t v = src[(size_t)x * ii->channels + c];
+                rowSum += v;
+                rowSq += v * v;
+                s[x + 1] = rowSum;
+                q[x + 1] = rowSq;
+            }
+        }
+    }
+}
+
+
+/* Passe 2 : cumul vertical sur un bloc de colonnes */
+static void integral_columnBand(void *arg, int begin, int end) {
+    const t_integral_pass *pass = (const t_integral_pass *)arg;
+    const t_integral *ii = pass->integral;
+    size_t plane = integral_planeSize(ii);
+    int w1 = ii->width + 1;
+    int x0 = begin * INTEGRAL_COLUMN_BLOCK;
+    int x1 = (end * INTEGRAL_COLUMN_BLOCK < w1) ? end * INTEGRAL_COLUMN_BLOCK : w1;
+
+    for (int c = 0; c < ii->channels; c++) {
+        uint64_t *s = ii->sum + c * plane;
+        uint64_t *q = ii->sqsum + c * plane;
+
+        for (int y = 2; y <= ii->height; y++) {
+            uint64_t *sRow = s + (size_t)y * w1;
+            uint64_t *qRow = q + (size_t)y * w1;
+            const uint64_t *sAbove = sRow - w1;
+            const uint64_t *qAbove = qRow - w1;
+            for (int x = x0; x < x1; x++) {
+                sRow[x] += sAbove[x];
+                qRow[x] += qAbove[x];
+            }
+        }
+    }
+}
+
+
+t_integral *bmp_integralFromRows(const uint8_t *const *rows, int width, int height, int channels) {
+    if (rows == NULL || width <= 0 || height <= 0 || channels <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_integral *integral = (t_integral *)malloc(sizeof(t_integral));
+    if (integral == NULL) {
+        printf("Erreur: Impossible d'allouer l'image intégrale\n");
+        return NULL;
+    }
+
+    integral->width = width;
+    integral->height = height;
+    integral->channels = channels;
+    size_t cells = integral_planeSize(integral) * channels;
+    integral->sum = (uint64_t *)malloc(cells * sizeof(uint64_t));
+    integral->sqsum = (uint64_t *)malloc(cells * sizeof(uint64_t));
+
+    if (integral->sum == NULL || integral->sqsum == NULL) {
+        printf("Erreur: Impossible d'allouer l'image intégrale\n");
+        bmp_integralFree(integral);
+        return NULL;
+    }
+
+    // Première ligne de chaque plan à zéro
+    for (int c = 0; c < channels; c++) {
+        memset(integral->sum + c * integral_planeSize(integral), 0, (width + 1) * sizeof(uint64_t));
+        memset(integral->sqsum + c * integral_planeSize(integral), 0, (width + 1) * sizeof(uint64_t));
+    }
+
+    t_integral_pass pass = {rows, integral};
+    bmp_parallelFor(height, INTEGRAL_GRAIN, integral_rowBand, &pass);
+    bmp_parallelFor((width + INTEGRAL_COLUMN_BLOCK) / INTEGRAL_COLUMN_BLOCK, 1, integral_columnBand, &pass);
+
+    return integral;
+}
+
+
+t_integral *bmp8_integral(t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    // Ligne 0 en haut, quel que soit l'ordre de rangement
+    unsigned char **rows = bmp8_getTopDownRows(img);
+    if (rows == NULL) {
+        return NULL;
+    }
+
+    t_integral *integral = bmp_integralFromRows((const uint8_t *const *)rows, img->width, img->height, 1);
+    free(rows);
+    return integral;
+}
+
+
+t_integral *bmp24_integral(t_bmp24 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return NULL;
+    }
+
+    t_integral *integral = bmp_integralFromRows((const uint8_t *const *)rows, img->width, img->height, 3);
+    free(rows);
+    return integral;
+}
+
+
+void bmp_integralFree(t_integral *integral) {
+    if (integral == NULL) {
+        return;
+    }
+
+    free(integral->sum);
+    free(integral->sqsum);
+    free(integral);
+}
+
+
+/*
+ * Rogne le rectangle à l'image ; renvoie le nombre de pixels couverts
+ * et les indices des quatre coins dans un plan
+ */
+static uint64_t integral_corners(const t_integral *ii, int x, int y, int w, int h, size_t corners[4]) {
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = (x + w > ii->width) ? ii->width : x + w;
+    int y1 = (y + h > ii->height) ? ii->height : y + h;
+
+    if (x1 <= x0 || y1 <= y0) {
+        return 0;
+    }
+
+    size_t w1 = (size_t)ii->width + 1;
+    corners[0] = (size_t)y0 * w1 + x0;
+    corners[1] = (size_t)y0 * w1 + x1;
+    corners[2] = (size_t)y1 * w1 + x0;
+    corners[3] = (size_t)y1 * w1 + x1;
+    return (uint64_t)(x1 - x0) * (y1 - y0);
+}
+
+
+static uint64_t integral_rectangle(const uint64_t *plane, const size_t corners[4]) {
+    return plane[corners[3]] - plane[corners[1]] - plane[corners[2]] + plane[corners[0]];
+}
+
+
+uint64_t bmp_integralSum(const t_integral *integral, int channel, int x, int y, int w, int h) {
+    size_t corners[4];
+    if (integral == NULL || channel < 0 || channel >= integral->channels ||
+        integral_corners(integral, x, y, w, h, corners) == 0) {
+        return 0;
+    }
+
+    return integral_rectangle(integral->sum + channel * integral_planeSize(integral), corners);
+}
+
+
+double bmp_integralMean(const t_integral *integral, int channel, int x, int y, int w, int h) {
+    size_t corners[4];
+    uint64_t count;
+    if (integral == NULL || channel < 0 || channel >= integral->channels ||
+        (count = integral_corners(integral, x, y, w, h, corners)) == 0) {
+        return 0.0;
+    }
+
+    return (double)integral_rectangle(integral->sum + channel * integral_planeSize(integral), corners) / count;
+}
+
+
+double bmp_integralVariance(const t_integral *integral, int channel, int x, int y, int w, int h) {
+    size_t corners[4];
+    uint64_t count;
+    if (integral == NULL || channel < 0 || channel >= integral->channels ||
+        (count = integral_corners(integral, x, y, w, h, corners)) == 0) {
+        return 0.0;
+    }
+
+    size_t plane = channel * integral_planeSize(integral);
+    double mean = (double)integral_rectangle(integral->sum + plane, corners) / count;
+    double sq = (double)integral_rectangle(integral->sqsum + plane, corners) / count;
+    double variance = sq - mean * mean;
+    return (variance > 0.0) ? variance : 0.0;
+}
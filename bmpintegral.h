@@ -0,0 +1,71 @@
+/**
+ * @file bmpintegral.h
+ *
+ * @brief
+ * Images intégrales (tables de sommes cumulées) des images BMP 8 et 24 bits.
+ * Une fois la table construite, la somme, la moyenne ou la variance de
+ * n'importe quel rectangle s'obtient en quatre lectures, quelle que soit
+ * sa taille : flous de boîte, seuillage adaptatif, recherche de motifs...
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPINTEGRAL_H
+#define BMPINTEGRAL_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+/*
+ * Image intégrale : pour chaque canal, un plan de (width + 1) x (height + 1)
+ * valeurs où la case (x, y) contient la somme des pixels [0, x[ x [0, y[.
+ * Les sommes sont sur 64 bits : aucun dépassement possible.
+ */
+typedef struct {
+    int width;        // Dimensions de l'image d'origine
+    int height;
+    int channels;     // 1 pour une image 8 bits, 3 pour une image 24 bits
+    uint64_t *sum;    // Sommes des valeurs (channels plans)
+    uint64_t *sqsum;  // Sommes des carrés (channels plans)
+} t_integral;
+
+/* bmp_integralFromRows
+ * Rôle : Construit l'image intégrale de lignes d'octets entrelacés
+ * Paramètres :
+ *   rows     - Lignes source
+ *   width    - Largeur en pixels
+ *   height   - Nombre de lignes
+ *   channels - Octets par pixel (chaque octet est un canal)
+ * Retour : Image intégrale à libérer avec bmp_integralFree, NULL si erreur
+ */
+t_integral *bmp_integralFromRows(const uint8_t *const *rows, int width, int height, int channels);
+
+/* bmp8_integral / bmp24_integral
+ * Rôle : Construit l'image intégrale d'une image (ligne 0 = haut de l'image)
+ * Retour : Image intégrale ou NULL si erreur
+ * Note : Pour une image 24 bits, les canaux sont dans l'ordre rouge, vert, bleu
+ */
+t_integral *bmp8_integral(t_bmp8 *img);
+t_integral *bmp24_integral(t_bmp24 *img);
+
+/* bmp_integralFree
+ * Rôle : Libère une image intégrale
+ */
+void bmp_integralFree(t_integral *integral);
+
+/* bmp_integralSum / bmp_integralMean / bmp_integralVariance
+ * Rôle : Statistiques d'un rectangle en temps constant
+ * Paramètres :
+ *   integral - Image intégrale
+ *   channel  - Canal voulu (0 pour une image 8 bits)
+ *   x, y     - Coin haut gauche du rectangle
+ *   w, h     - Dimensions du rectangle (rogné aux bords de l'image)
+ * Retour : Somme, moyenne ou variance des pixels du rectangle (0 si vide)
+ */
+uint64_t bmp_integralSum(const t_integral *integral, int channel, int x, int y, int w, int h);
+double bmp_integralMean(const t_integral *integral, int channel, int x, int y, int w, int h);
+double bmp_integralVariance(const t_integral *integral, int channel, int x, int y, int w, int h);
+
+#endif
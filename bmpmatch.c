@@ -0,0 +1,134 @@
+/**
+ * @file bmpmatch.c
+ *
+ * @brief
+ * Spécification d'histogramme par les fonctions de répartition : un niveau
+ * v de l'image est envoyé sur le niveau de la référence dont la proportion
+ * cumulée est la plus proche de celle de v. Coût : un histogramme de
+ * l'image puis une passe de table de correspondance (l'histogramme de la
+ * référence n'est calculé qu'une fois, à la préparation).
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpmatch.h"
+#include "bmphistogram.h"
+#include <stdio.h>
+#include <string.h>
+
+
+/* Normalise l'histogramme cumulé d'une composante */
+static void match_normalizeCdf(const uint32_t hist[256], double cdf[256]) {
+    uint64_t cumulated[256];
+    uint64_t total = bmp_histogramCDF(hist, cumulated);
+
+    for (int v = 0; v < 256; v++) {
+        cdf[v] = (total > 0) ? (double)cumulated[v] / total : 1.0;
+    }
+}
+
+
+int bmp8_matchReference(t_bmp8 *ref, t_match_reference *reference) {
+    uint32_t hist[256];
+
+    if (reference == NULL || bmp8_histogram(ref, hist) != 0) {
+        return -1;
+    }
+
+    reference->channels = 1;
+    match_normalizeCdf(hist, reference->cdf[0]);
+    return 0;
+}
+
+
+int bmp24_matchReference(t_bmp24 *ref, t_match_mode mode, t_match_reference *reference) {
+    if (reference == NULL) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    if (mode == BMP_MATCH_LUMA) {
+        uint32_t hist[256];
+        if (bmp24_lumaHistogram(ref, hist) != 0) {
+            return -1;
+        }
+        reference->channels = 1;
+        match_normalizeCdf(hist, reference->cdf[0]);
+        return 0;
+    }
+
+    uint32_t hist[3][256];
+    if (bmp24_histogram(ref, hist) != 0) {
+        return -1;
+    }
+    reference->channels = 3;
+    for (int c = 0; c < 3; c++) {
+        match_normalizeCdf(hist[c], reference->cdf[c]);
+    }
+    return 0;
+}
+
+
+void bmp_matchLut(const uint32_t hist[256], const double referenceCdf[256], uint8_t lut[256]) {
+    double cdf[256];
+    match_normalizeCdf(hist, cdf);
+
+    // Les deux fonctions sont croissantes : un seul parcours de la référence
+    int r = 0;
+    for (int v = 0; v < 256; v++) {
+        while (r < 255 && referenceCdf[r] < cdf[v]) {
+            r++;
+        }
+        if (r > 0 && cdf[v] - referenceCdf[r - 1] < referenceCdf[r] - cdf[v]) {
+            lut[v] = (uint8_t)(r - 1);
+        } else {
+            lut[v] = (uint8_t)r;
+        }
+    }
+}
+
+
+int bmp8_matchHistogram(t_bmp8 *img, const t_match_reference *reference) {
+    if (reference == NULL || reference->channels != 1) {
+        fprintf(stderr, "Erreur: Référence invalide pour une image 8 bits\n");
+        return -1;
+    }
+
+    uint32_t hist[256];
+    if (bmp8_histogram(img, hist) != 0) {
+        return -1;
+    }
+
+    uint8_t lut[256];
+    bmp_matchLut(hist, reference->cdf[0], lut);
+    return bmp8_applyLut(img, lut);
+}
+
+
+int bmp24_matchHistogram(t_bmp24 *img, const t_match_reference *reference) {
+    if (reference == NULL || (reference->channels != 1 && reference->channels != 3)) {
+        printf("Erreur: Référence invalide\n");
+        return -1;
+    }
+
+    if (reference->channels == 1) {
+        uint32_t hist[256];
+        uint8_t lut[256];
+        if (bmp24_lumaHistogram(img, hist) != 0) {
+            return -1;
+        }
+        bmp_matchLut(hist, reference->cdf[0], lut);
+        return bmp24_applyLumaLut(img, lut);
+    }
+
+    uint32_t hist[3][256];
+    uint8_t luts[3][256];
+    if (bmp24_histogram(img, hist) != 0) {
+        return -1;
+    }
+    for (int c = 0; c < 3; c++) {
+        bmp_matchLut(hist[c], reference->cdf[c], luts[c]);
+    }
+    return bmp24_applyLut(img, (const uint8_t (*)[256])luts);
+}
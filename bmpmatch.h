@@ -0,0 +1,86 @@
+/**
+ * @file bmpmatch.h
+ *
+ * @brief
+ * Spécification d'histogramme : on transforme une image pour que son
+ * histogramme ressemble à celui d'une image de référence (même rendu pour
+ * toutes les photos d'une série). La référence est résumée une fois pour
+ * toutes dans un t_match_reference, réutilisable pour des milliers d'images.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPMATCH_H
+#define BMPMATCH_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+
+/*
+ * Composantes mises en correspondance pour une image couleur
+ */
+typedef enum {
+    BMP_MATCH_PER_CHANNEL,  // R, G et B séparément (corrige aussi les teintes)
+    BMP_MATCH_LUMA          // Luminance Y seulement (chrominance conservée)
+} t_match_mode;
+
+/*
+ * Fonction de répartition normalisée de la référence, par composante.
+ * La structure ne contient aucun pointeur : elle peut être copiée, gardée
+ * en cache ou partagée en lecture entre plusieurs threads.
+ */
+typedef struct {
+    int channels;           // 1 (gris ou luminance) ou 3 (R, G, B)
+    double cdf[3][256];     // cdf[c][v] = proportion des pixels <= v
+} t_match_reference;
+
+/* bmp8_matchReference
+ * Rôle : Prépare la référence à partir d'une image 8 bits
+ * Paramètres :
+ *   ref       - Image de référence
+ *   reference - Reçoit la référence (channels = 1)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_matchReference(t_bmp8 *ref, t_match_reference *reference);
+
+/* bmp24_matchReference
+ * Rôle : Prépare la référence à partir d'une image couleur
+ * Paramètres :
+ *   ref       - Image de référence
+ *   mode      - BMP_MATCH_PER_CHANNEL (channels = 3) ou BMP_MATCH_LUMA (channels = 1)
+ *   reference - Reçoit la référence
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_matchReference(t_bmp24 *ref, t_match_mode mode, t_match_reference *reference);
+
+/* bmp_matchLut
+ * Rôle : Construit la table qui envoie un histogramme sur la référence
+ * Paramètres :
+ *   hist         - Histogramme de l'image à transformer
+ *   referenceCdf - Fonction de répartition normalisée de la référence
+ *   lut          - Reçoit la table de 256 valeurs
+ */
+void bmp_matchLut(const uint32_t hist[256], const double referenceCdf[256], uint8_t lut[256]);
+
+/* bmp8_matchHistogram
+ * Rôle : Transforme l'image pour que son histogramme suive la référence
+ * Paramètres :
+ *   img       - Image à modifier
+ *   reference - Référence à une composante (image 8 bits ou luminance)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_matchHistogram(t_bmp8 *img, const t_match_reference *reference);
+
+/* bmp24_matchHistogram
+ * Rôle : Transforme une image couleur selon la référence : composante par
+ *        composante si elle en a 3, sur la luminance si elle n'en a qu'une
+ * Paramètres :
+ *   img       - Image à modifier
+ *   reference - Référence préparée
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_matchHistogram(t_bmp24 *img, const t_match_reference *reference);
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * @file bmpprobe.c
+ *
+ * @brief
+ * Les métadonnées sont lues par un seul pread des BMP_PROBE_SIZE premiers
+ * octets : pas de tampon FILE, pas de déplacement partagé, chaque thread
+ * du lot peut lire son fichier sans verrou. Sous Windows, où pread
+ * n'existe pas, chaque fichier a son propre descripteur et on se place
+ * avant de lire, ce qui revient au même.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+// pread est POSIX : à déclarer avant tout en-tête système en mode C11 strict,
+// avec des positions sur 64 bits pour les fichiers de plus de 2 Go
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#define _FILE_OFFSET_BITS 64
+
+#include "bmpprobe.h"
+#include "bmp8.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define PROBE_GRAIN 16
+#define PROBE_CORE_SIZE 12  // Ancien en-tête OS/2 (dimensions sur 16 bits)
+#define PROBE_MIN_SIZE 26   // En-tête de fichier + en-tête OS/2
+
+typedef struct {
+    const char *const *filenames;
+    t_bmp_probe *infos;
+    int *ok;
+} t_probe_pass;
+
+
+static uint32_t probe_field(const uint8_t *data, int offset, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint32_t)data[offset + i] << (8 * i);
+    }
+    return value;
+}
+
+
+int bmp_fileOpen(const char *filename) {
+#ifdef _WIN32
+    return _open(filename, _O_RDONLY | _O_BINARY);
+#else
+    return open(filename, O_RDONLY);
+#endif
+}
+
+
+long bmp_fileReadAt(int fd, void *buffer, size_t size, uint64_t offset) {
+    size_t done = 0;
+
+    // pread peut rendre moins que demandé : on complète jusqu'à la fin du fichier
+    while (done < size) {
+#ifdef _WIN32
+        if (_lseeki64(fd, (__int64)(offset + done), SEEK_SET) < 0) {
+            return -1;
+        }
+        long got = _read(fd, (char *)buffer + done, (unsigned int)(size - done));
+#else
+        long got = (long)pread(fd, (char *)buffer + done, size - done, (off_t)(offset + done));
+#endif
+        if (got < 0) {
+            return -1;
+        }
+        if (got == 0) {
+            break;
+        }
+        done += (size_t)got;
+    }
+    return (long)done;
+}
+
+
+void bmp_fileClose(int fd) {
+    if (fd >= 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+
+/* Lit le début d'un fichier, -1 si erreur */
+static long probe_readStart(const char *filename, uint8_t *buffer, size_t size) {
+    int fd = bmp_fileOpen(filename);
+    if (fd < 0) {
+        return -1;
+    }
+    long got = bmp_fileReadAt(fd, buffer, size, 0);
+    bmp_fileClose(fd);
+    return got;
+}
+
+
+int bmp_probeHeader(const uint8_t *data, size_t size, t_bmp_probe *info) {
+    if (data == NULL || info == NULL || size < PROBE_MIN_SIZE) {
+        return -1;
+    }
+    memset(info, 0, sizeof(t_bmp_probe));
+
+    if (data[0] != 'B' || data[1] != 'M') {
+        return -1;
+    }
+
+    info->fileSize = probe_field(data, 2, 4);
+    info->dataOffset = probe_field(data, 10, 4);
+    info->infoSize = probe_field(data, 14, 4);
+
+    int32_t height;
+    uint16_t bits;
+    if (info->infoSize == PROBE_CORE_SIZE) {
+        info->width = (int32_t)probe_field(data, 18, 2);
+        height = (int32_t)probe_field(data, 20, 2);
+        bits = (uint16_t)probe_field(data, 24, 2);
+    } else if (info->infoSize >= 40 && size >= BMP_HEADER_SIZE) {
+        info->width = (int32_t)probe_field(data, 18, 4);
+        height = (int32_t)probe_field(data, 22, 4);
+        bits = (uint16_t)probe_field(data, 28, 2);
+        info->compression = probe_field(data, 30, 4);
+        info->imageSize = probe_field(data, 34, 4);
+        info->xPixelsPerMeter = (int32_t)probe_field(data, 38, 4);
+        info->yPixelsPerMeter = (int32_t)probe_field(data, 42, 4);
+        info->colorsUsed = probe_field(data, 46, 4);
+    } else {
+        return -1;
+    }
+
+    if (info->width <= 0 || height == 0 || bits == 0) {
+        return -1;
+    }
+
+    info->topDown = (height < 0);
+    info->height = info->topDown ? -height : height;
+    info->bitDepth = bits;
+    info->rowSize = (uint32_t)((((uint64_t)info->width * bits + 31) / 32) * 4);
+    return 0;
+}
+
+
+int bmp_probe(const char *filename, t_bmp_probe *info) {
+    if (filename == NULL || info == NULL) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    uint8_t data[BMP_PROBE_SIZE];
+    long got = probe_readStart(filename, data, sizeof(data));
+    if (got < 0) {
+        perror("Erreur: Impossible d'ouvrir le fichier");
+        return -1;
+    }
+    if (bmp_probeHeader(data, (size_t)got, info) != 0) {
+        fprintf(stderr, "Erreur: %s n'est pas un fichier BMP valide\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+
+static void probe_band(void *arg, int begin, int end) {
+    const t_probe_pass *pass = (const t_probe_pass *)arg;
+
+    for (int i = begin; i < end; i++) {
+        uint8_t data[BMP_PROBE_SIZE];
+        long got = probe_readStart(pass->filenames[i], data, sizeof(data));
+        pass->ok[i] = (got >= 0 && bmp_probeHeader(data, (size_t)got, &pass->infos[i]) == 0);
+        if (!pass->ok[i]) {
+            memset(&pass->infos[i], 0, sizeof(t_bmp_probe));
+        }
+    }
+}
+
+
+int bmp_probeBatch(const char *const *filenames, int count, t_bmp_probe *infos) {
+    if (filenames == NULL || infos == NULL || count < 0) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    int *ok = (int *)malloc((size_t)count * sizeof(int));
+    if (ok == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        return -1;
+    }
+
+    t_probe_pass pass = {filenames, infos, ok};
+    bmp_parallelFor(count, PROBE_GRAIN, probe_band, &pass);
+
+    int success = 0;
+    for (int i = 0; i < count; i++) {
+        success += ok[i];
+    }
+    free(ok);
+    return success;
+}
+
+
+void bmp_probePrint(const t_bmp_probe *info) {
+    if (info == NULL) {
+        fprintf(stderr, "Erreur: Informations invalides\n");
+        return;
+    }
+
+    printf("Informations de l'image:\n");
+    printf("    Largeur: %d\n", info->width);
+    printf("    Hauteur: %d%s\n", info->height, info->topDown ? " (de haut en bas)" : "");
+    printf("    Profondeur de couleur: %u\n", info->bitDepth);
+    printf("    Compression: %u\n", info->compression);
+    printf("    Début des pixels: %u\n", info->dataOffset);
+    printf("    Taille des données: %u\n", info->imageSize != 0 ? info->imageSize : info->rowSize * (uint32_t)info->height);
+}
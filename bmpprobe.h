@@ -0,0 +1,90 @@
+/**
+ * @file bmpprobe.h
+ *
+ * @brief
+ * Lecture des seules métadonnées d'un fichier BMP (dimensions, profondeur,
+ * compression, positions) sans charger les pixels : un seul appel pread
+ * des premiers octets du fichier. La version par lots interroge des
+ * milliers de fichiers en parallèle, pour indexer une banque d'images
+ * sans relire tout son contenu.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPPROBE_H
+#define BMPPROBE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Octets lus au début du fichier : en-tête (14) + informations (40) + masques (16) */
+#define BMP_PROBE_SIZE 70
+
+/*
+ * Métadonnées communes à toutes les profondeurs
+ */
+typedef struct {
+    uint32_t fileSize;          // Taille annoncée par l'en-tête
+    uint32_t dataOffset;        // Début des pixels dans le fichier
+    uint32_t infoSize;          // Taille de l'en-tête d'informations (12, 40, 56, 108, 124)
+    int32_t width;              // Largeur en pixels
+    int32_t height;             // Hauteur en pixels (toujours positive)
+    int topDown;                // 1 : lignes de haut en bas (hauteur négative dans le fichier)
+    uint16_t bitDepth;          // Bits par pixel (0 si le fichier n'a pas pu être lu)
+    uint32_t compression;       // BMP_BI_RGB, BMP_BI_RLE8, BMP_BI_BITFIELDS...
+    uint32_t imageSize;         // Taille des pixels (0 permis pour BMP_BI_RGB)
+    uint32_t rowSize;           // Octets par ligne non compressée, padding compris
+    uint32_t colorsUsed;        // Entrées de la palette (0 : valeur par défaut)
+    int32_t xPixelsPerMeter;
+    int32_t yPixelsPerMeter;
+} t_bmp_probe;
+
+/* bmp_fileOpen / bmp_fileReadAt / bmp_fileClose
+ * Rôle : Lecture positionnée (pread) sans tampon ni position partagée :
+ *        plusieurs threads peuvent lire le même descripteur
+ * Retour : bmp_fileOpen : descripteur, -1 si erreur ;
+ *          bmp_fileReadAt : octets lus (moins que size en fin de fichier), -1 si erreur
+ * Note : Sous Windows (pas de pread) la lecture se place puis lit : un
+ *        descripteur ne doit alors servir qu'à un seul thread
+ */
+int bmp_fileOpen(const char *filename);
+long bmp_fileReadAt(int fd, void *buffer, size_t size, uint64_t offset);
+void bmp_fileClose(int fd);
+
+/* bmp_probeHeader
+ * Rôle : Décode les métadonnées depuis les premiers octets d'un fichier
+ * Paramètres :
+ *   data - Début du fichier
+ *   size - Nombre d'octets disponibles (au moins 26, BMP_PROBE_SIZE conseillé)
+ *   info - Reçoit les métadonnées
+ * Retour : 0 si réussi, -1 si ce n'est pas un BMP valide
+ */
+int bmp_probeHeader(const uint8_t *data, size_t size, t_bmp_probe *info);
+
+/* bmp_probe
+ * Rôle : Lit les métadonnées d'un fichier sans lire ses pixels
+ * Paramètres :
+ *   filename - Chemin du fichier
+ *   info     - Reçoit les métadonnées
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_probe(const char *filename, t_bmp_probe *info);
+
+/* bmp_probeBatch
+ * Rôle : Lit les métadonnées de nombreux fichiers, répartis entre les threads
+ * Paramètres :
+ *   filenames - Chemins des fichiers
+ *   count     - Nombre de fichiers
+ *   infos     - count entrées ; bitDepth vaut 0 pour un fichier illisible
+ * Retour : Nombre de fichiers lus avec succès, -1 si paramètres invalides
+ * Note : Aucun message n'est affiché pour les fichiers en erreur
+ */
+int bmp_probeBatch(const char *const *filenames, int count, t_bmp_probe *infos);
+
+/* bmp_probePrint
+ * Rôle : Affiche les métadonnées (équivalent de bmp8_printInfo sans charger l'image)
+ */
+void bmp_probePrint(const t_bmp_probe *info);
+
+#endif
@@ -0,0 +1,473 @@
+/**
+ * @file bmppyramid.c
+ *
+ * @brief
+ * Les dimensions de tous les niveaux sont connues d'avance : un seul
+ * malloc les contient, chaque niveau commençant sur 64 octets et chaque
+ * ligne sur 16 octets. Une réduction se fait en deux temps par ligne
+ * produite : somme verticale des lignes sources en entiers 16 bits (SSE2,
+ * 16 octets par itération quel que soit le nombre de composantes), puis
+ * somme horizontale des paires de pixels. En niveaux de gris, le filtre
+ * boîte fait les deux en SSE2 (octets pairs et impairs séparés par masque
+ * et décalage). Les arrondis sont ceux de bmp_boxReduceRows. La recherche
+ * de motif compare les blocs avec _mm_sad_epu8 et abandonne une position
+ * dès que l'écart dépasse le meilleur trouvé.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmppyramid.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define PYRAMID_GRAIN 8
+#define PYRAMID_ALIGN 64
+#define PYRAMID_ROW_ALIGN 16
+#define PYRAMID_MATCH_MIN 8     // Côté minimal du motif au niveau de départ
+#define PYRAMID_REFINE 2        // Rayon de l'affinage à chaque niveau
+
+typedef struct {
+    const t_bmp_view *src;
+    const t_bmp_view *dst;
+    t_pyramid_filter filter;
+    atomic_int failed;      // Une bande n'a pas pu allouer sa ligne de travail
+} t_pyramid_pass;
+
+typedef struct {
+    const t_bmp_view *image;
+    const t_bmp_view *templ;
+    int64_t *bestSad;       // Meilleur écart de chaque ligne de positions
+    int *bestX;
+} t_find_pass;
+
+
+static inline int pyramid_clamp(int v, int max) {
+    return (v < 0) ? 0 : ((v > max) ? max : v);
+}
+
+
+/* tmp = r0 + r1 sur n octets */
+static void pyramid_sum2(const uint8_t *r0, const uint8_t *r1, uint16_t *tmp, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(r0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r1 + i));
+        _mm_storeu_si128((__m128i *)(tmp + i), _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)));
+        _mm_storeu_si128((__m128i *)(tmp + i + 8), _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        tmp[i] = (uint16_t)(r0[i] + r1[i]);
+    }
+}
+
+
+/* tmp = r[0] + 4 r[1] + 6 r[2] + 4 r[3] + r[4] sur n octets */
+static void pyramid_sum5(const uint8_t *const r[5], uint16_t *tmp, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[5];
+        for (int j = 0; j < 5; j++) {
+            v[j] = _mm_loadu_si128((const __m128i *)(r[j] + i));
+        }
+        for (int half = 0; half < 2; half++) {
+            __m128i s[5];
+            for (int j = 0; j < 5; j++) {
+                s[j] = half ? _mm_unpackhi_epi8(v[j], zero) : _mm_unpacklo_epi8(v[j], zero);
+            }
+            __m128i outer = _mm_add_epi16(s[0], s[4]);
+            __m128i inner = _mm_slli_epi16(_mm_add_epi16(s[1], s[3]), 2);
+            __m128i center = _mm_add_epi16(_mm_slli_epi16(s[2], 2), _mm_slli_epi16(s[2], 1));
+            _mm_storeu_si128((__m128i *)(tmp + i + half * 8),
+                             _mm_add_epi16(_mm_add_epi16(outer, inner), center));
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        tmp[i] = (uint16_t)(r[0][i] + 4 * (r[1][i] + r[3][i]) + 6 * r[2][i] + r[4][i]);
+    }
+}
+
+
+/* Filtre boîte en niveaux de gris, entièrement en SSE2 */
+static void pyramid_boxGray(const uint8_t *r0, const uint8_t *r1, uint8_t *dst, int dstWidth) {
+    int x = 0;
+
+#ifdef __SSE2__
+    __m128i low = _mm_set1_epi16(0x00FF);
+    __m128i two = _mm_set1_epi16(2);
+    for (; x + 16 <= dstWidth; x += 16) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(r0 + 2 * x + 16 * half));
+            __m128i b = _mm_loadu_si128((const __m128i *)(r1 + 2 * x + 16 * half));
+            // Pixel pair + pixel impair de chaque ligne, sur 16 bits
+            __m128i s = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, low), _mm_srli_epi16(a, 8)),
+                                      _mm_add_epi16(_mm_and_si128(b, low), _mm_srli_epi16(b, 8)));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(s, two), 2);
+        }
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#endif
+
+    for (; x < dstWidth; x++) {
+        dst[x] = (uint8_t)((r0[2 * x] + r0[2 * x + 1] + r1[2 * x] + r1[2 * x + 1] + 2) >> 2);
+    }
+}
+
+
+static void pyramid_reduceBand(void *arg, int begin, int end) {
+    t_pyramid_pass *pass = (t_pyramid_pass *)arg;
+    const t_bmp_view *src = pass->src;
+    const t_bmp_view *dst = pass->dst;
+    int ch = src->channels;
+    int n = src->width * ch;
+    uint16_t *tmp = (uint16_t *)malloc((size_t)n * sizeof(uint16_t));
+
+    if (tmp == NULL) {
+        printf("Erreur: Impossible d'allouer la ligne de réduction\n");
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *out = bmp_viewRow(dst, y);
+
+        if (pass->filter == BMP_PYRAMID_BOX) {
+            const uint8_t *r0 = bmp_viewRow(src, 2 * y);
+            const uint8_t *r1 = bmp_viewRow(src, 2 * y + 1);
+            if (ch == 1) {
+                pyramid_boxGray(r0, r1, out, dst->width);
+                continue;
+            }
+            pyramid_sum2(r0, r1, tmp, 2 * dst->width * ch);
+            for (int x = 0; x < dst->width; x++) {
+                for (int c = 0; c < ch; c++) {
+                    int i = 2 * x * ch + c;
+                    out[x * ch + c] = (uint8_t)((tmp[i] + tmp[i + ch] + 2) >> 2);
+                }
+            }
+            continue;
+        }
+
+        // Gaussienne : lignes 2y-2 à 2y+2, bords répétés
+        const uint8_t *rows[5];
+        for (int j = 0; j < 5; j++) {
+            rows[j] = bmp_viewRow(src, pyramid_clamp(2 * y - 2 + j, src->height - 1));
+        }
+        pyramid_sum5(rows, tmp, n);
+        for (int x = 0; x < dst->width; x++) {
+            int x0 = pyramid_clamp(2 * x - 2, src->width - 1) * ch;
+            int x1 = pyramid_clamp(2 * x - 1, src->width - 1) * ch;
+            int x2 = 2 * x * ch;
+            int x3 = pyramid_clamp(2 * x + 1, src->width - 1) * ch;
+            int x4 = pyramid_clamp(2 * x + 2, src->width - 1) * ch;
+            for (int c = 0; c < ch; c++) {
+                uint32_t sum = tmp[x0 + c] + 4u * (tmp[x1 + c] + tmp[x3 + c]) + 6u * tmp[x2 + c] + tmp[x4 + c];
+                out[x * ch + c] = (uint8_t)((sum + 128) >> 8);
+            }
+        }
+    }
+
+    free(tmp);
+}
+
+
+t_bmp_pyramid *bmp_buildPyramid(const t_bmp_view *src, t_pyramid_filter filter, int minSize) {
+    if (src == NULL || src->base == NULL || src->width <= 0 || src->height <= 0 ||
+        (src->channels != 1 && src->channels != 3 && src->channels != 4) ||
+        (filter != BMP_PYRAMID_BOX && filter != BMP_PYRAMID_GAUSSIAN)) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+    if (minSize < 1) {
+        minSize = 1;
+    }
+
+    t_bmp_pyramid *pyramid = (t_bmp_pyramid *)calloc(1, sizeof(t_bmp_pyramid));
+    if (pyramid == NULL) {
+        printf("Erreur: Impossible d'allouer la pyramide\n");
+        return NULL;
+    }
+    pyramid->filter = filter;
+
+    // Dimensions et position de chaque niveau dans le bloc
+    size_t offsets[BMP_PYRAMID_MAX_LEVELS];
+    size_t total = 0;
+    int width = src->width, height = src->height;
+    while (pyramid->levels < BMP_PYRAMID_MAX_LEVELS) {
+        t_bmp_view *level = &pyramid->level[pyramid->levels];
+        level->width = width;
+        level->height = height;
+        level->channels = src->channels;
+        level->stride = ((ptrdiff_t)width * src->channels + PYRAMID_ROW_ALIGN - 1) & ~(ptrdiff_t)(PYRAMID_ROW_ALIGN - 1);
+        offsets[pyramid->levels++] = total;
+        total += ((size_t)level->stride * (size_t)height + PYRAMID_ALIGN - 1) & ~(size_t)(PYRAMID_ALIGN - 1);
+
+        width /= 2;
+        height /= 2;
+        if (width < minSize || height < minSize) {
+            break;
+        }
+    }
+
+    pyramid->arena = (uint8_t *)malloc(total + PYRAMID_ALIGN - 1);
+    if (pyramid->arena == NULL) {
+        printf("Erreur: Impossible d'allouer les niveaux de la pyramide\n");
+        free(pyramid);
+        return NULL;
+    }
+    pyramid->arenaSize = total;
+
+    uint8_t *base = (uint8_t *)(((uintptr_t)pyramid->arena + PYRAMID_ALIGN - 1) & ~(uintptr_t)(PYRAMID_ALIGN - 1));
+    for (int k = 0; k < pyramid->levels; k++) {
+        pyramid->level[k].base = base + offsets[k];
+    }
+
+    // Niveau 0 : copie de la source, de haut en bas
+    size_t span = (size_t)src->width * src->channels;
+    for (int y = 0; y < src->height; y++) {
+        memcpy(bmp_viewRow(&pyramid->level[0], y), bmp_viewRow(src, y), span);
+    }
+
+    for (int k = 1; k < pyramid->levels; k++) {
+        t_pyramid_pass pass = {&pyramid->level[k - 1], &pyramid->level[k], filter};
+        atomic_init(&pass.failed, 0);
+        bmp_parallelFor(pyramid->level[k].height, PYRAMID_GRAIN, pyramid_reduceBand, &pass);
+        if (atomic_load(&pass.failed) != 0) {
+            bmp_pyramidFree(pyramid);
+            return NULL;
+        }
+    }
+    return pyramid;
+}
+
+
+t_bmp_pyramid *bmp8_buildPyramid(t_bmp8 *img, t_pyramid_filter filter, int minSize) {
+    t_bmp_view view;
+    if (bmp8_view(img, &view) != 0) {
+        return NULL;
+    }
+    return bmp_buildPyramid(&view, filter, minSize);
+}
+
+
+t_bmp_pyramid *bmp24_buildPyramid(t_bmp24 *img, t_pyramid_filter filter, int minSize) {
+    t_bmp_view view;
+    if (bmp24_view(img, &view) != 0) {
+        return NULL;
+    }
+    return bmp_buildPyramid(&view, filter, minSize);
+}
+
+
+void bmp_pyramidFree(t_bmp_pyramid *pyramid) {
+    if (pyramid == NULL) {
+        return;
+    }
+    free(pyramid->arena);
+    free(pyramid);
+}
+
+
+int bmp_pyramidLevelFor(const t_bmp_pyramid *pyramid, int width, int height) {
+    if (pyramid == NULL || width <= 0 || height <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    int level = 0;
+    while (level + 1 < pyramid->levels && pyramid->level[level + 1].width >= width &&
+           pyramid->level[level + 1].height >= height) {
+        level++;
+    }
+    return level;
+}
+
+
+/* Vérifie le niveau demandé et le nombre de composantes attendu */
+static const t_bmp_view *pyramid_getLevel(const t_bmp_pyramid *pyramid, int level, int channels) {
+    if (pyramid == NULL || level < 0 || level >= pyramid->levels ||
+        pyramid->level[level].channels != channels) {
+        printf("Erreur: Niveau de pyramide invalide\n");
+        return NULL;
+    }
+    return &pyramid->level[level];
+}
+
+
+t_bmp8 *bmp8_pyramidImage(const t_bmp_pyramid *pyramid, int level) {
+    const t_bmp_view *src = pyramid_getLevel(pyramid, level, 1);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp8 *img = bmp8_allocate((uint32_t)src->width, (uint32_t)src->height);
+    t_bmp_view dst;
+    if (img == NULL || bmp8_view(img, &dst) != 0 || bmp_viewCopy(&dst, src) != 0) {
+        bmp8_free(img);
+        return NULL;
+    }
+    return img;
+}
+
+
+t_bmp24 *bmp24_pyramidImage(const t_bmp_pyramid *pyramid, int level) {
+    const t_bmp_view *src = pyramid_getLevel(pyramid, level, 3);
+    if (src == NULL) {
+        return NULL;
+    }
+
+    t_bmp24 *img = bmp24_allocate(src->width, src->height, DEFAULT_DEPTH);
+    t_bmp_view dst;
+    if (img == NULL || bmp24_view(img, &dst) != 0 || bmp_viewCopy(&dst, src) != 0) {
+        bmp24_free(img);
+        return NULL;
+    }
+    return img;
+}
+
+
+/* RECHERCHE DE MOTIF */
+
+/* Somme des écarts absolus sur n octets */
+static inline uint64_t pyramid_sadRow(const uint8_t *a, const uint8_t *b, int n) {
+    uint64_t sum = 0;
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(a + i)),
+                                              _mm_loadu_si128((const __m128i *)(b + i))));
+    }
+    sum = (uint64_t)_mm_cvtsi128_si32(acc) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#endif
+
+    for (; i < n; i++) {
+        sum += (a[i] > b[i]) ? a[i] - b[i] : b[i] - a[i];
+    }
+    return sum;
+}
+
+
+/* Écart entre le motif et l'image en (x, y) ; s'arrête dès qu'il dépasse limit */
+static uint64_t pyramid_sad(const t_bmp_view *image, const t_bmp_view *templ, int x, int y, uint64_t limit) {
+    int n = templ->width * templ->channels;
+    uint64_t sum = 0;
+
+    for (int j = 0; j < templ->height && sum <= limit; j++) {
+        sum += pyramid_sadRow(bmp_viewRow(image, y + j) + (size_t)x * image->channels, bmp_viewRow(templ, j), n);
+    }
+    return sum;
+}
+
+
+static void pyramid_findBand(void *arg, int begin, int end) {
+    const t_find_pass *pass = (const t_find_pass *)arg;
+    int positions = pass->image->width - pass->templ->width + 1;
+
+    for (int y = begin; y < end; y++) {
+        uint64_t best = UINT64_MAX;
+        int bestX = 0;
+        for (int x = 0; x < positions; x++) {
+            uint64_t sad = pyramid_sad(pass->image, pass->templ, x, y, best);
+            if (sad < best) {
+                best = sad;
+                bestX = x;
+            }
+        }
+        pass->bestSad[y] = (int64_t)best;
+        pass->bestX[y] = bestX;
+    }
+}
+
+
+int64_t bmp_pyramidFind(const t_bmp_pyramid *image, const t_bmp_pyramid *templ, int *x, int *y) {
+    if (image == NULL || templ == NULL || x == NULL || y == NULL ||
+        image->level[0].channels != templ->level[0].channels ||
+        image->level[0].width < templ->level[0].width || image->level[0].height < templ->level[0].height) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    // Niveau de départ : le plus petit où le motif reste assez grand et tient dans l'image
+    int start = 0;
+    int levels = (image->levels < templ->levels) ? image->levels : templ->levels;
+    while (start + 1 < levels && templ->level[start + 1].width >= PYRAMID_MATCH_MIN &&
+           templ->level[start + 1].height >= PYRAMID_MATCH_MIN &&
+           image->level[start + 1].width >= templ->level[start + 1].width &&
+           image->level[start + 1].height >= templ->level[start + 1].height) {
+        start++;
+    }
+
+    // Recherche exhaustive au niveau de départ, une ligne de positions par tâche
+    const t_bmp_view *img = &image->level[start];
+    const t_bmp_view *tpl = &templ->level[start];
+    int rows = img->height - tpl->height + 1;
+    int64_t *bestSad = (int64_t *)malloc((size_t)rows * sizeof(int64_t));
+    int *bestX = (int *)malloc((size_t)rows * sizeof(int));
+    if (bestSad == NULL || bestX == NULL) {
+        printf("Erreur: Impossible d'allouer la recherche\n");
+        free(bestSad);
+        free(bestX);
+        return -1;
+    }
+
+    t_find_pass pass = {img, tpl, bestSad, bestX};
+    bmp_parallelFor(rows, 1, pyramid_findBand, &pass);
+
+    int bx = bestX[0], by = 0;
+    int64_t best = bestSad[0];
+    for (int r = 1; r < rows; r++) {
+        if (bestSad[r] < best) {
+            best = bestSad[r];
+            bx = bestX[r];
+            by = r;
+        }
+    }
+    free(bestSad);
+    free(bestX);
+
+    // Affinage autour de la position doublée à chaque niveau plus grand
+    for (int k = start - 1; k >= 0; k--) {
+        img = &image->level[k];
+        tpl = &templ->level[k];
+        int maxX = img->width - tpl->width;
+        int maxY = img->height - tpl->height;
+        int cx = 2 * bx, cy = 2 * by;
+        uint64_t refined = UINT64_MAX;
+
+        for (int py = pyramid_clamp(cy - PYRAMID_REFINE, maxY); py <= pyramid_clamp(cy + PYRAMID_REFINE, maxY); py++) {
+            for (int px = pyramid_clamp(cx - PYRAMID_REFINE, maxX); px <= pyramid_clamp(cx + PYRAMID_REFINE, maxX); px++) {
+                uint64_t sad = pyramid_sad(img, tpl, px, py, refined);
+                if (sad < refined) {
+                    refined = sad;
+                    bx = px;
+                    by = py;
+                }
+            }
+        }
+        best = (int64_t)refined;
+    }
+
+    *x = bx;
+    *y = by;
+    return best;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file bmppyramid.h
+ *
+ * @brief
+ * Pyramide d'images : l'image puis ses réductions successives par 2, jusqu'à
+ * quelques pixels. Tous les niveaux sont rangés dans un seul bloc mémoire et
+ * exposés comme des vues (bmpview.h). Une interface graphique affiche un
+ * aperçu instantané sur un petit niveau (réglage de luminosité, flou...)
+ * puis n'applique le traitement en pleine résolution qu'au relâchement du
+ * curseur ; la recherche d'un motif commence sur le niveau le plus petit et
+ * ne fait qu'affiner la position aux niveaux suivants.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPPYRAMID_H
+#define BMPPYRAMID_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/* Nombre maximal de niveaux (largeur et hauteur sur 31 bits) */
+#define BMP_PYRAMID_MAX_LEVELS 32
+
+/*
+ * Filtre appliqué avant chaque réduction par 2
+ */
+typedef enum {
+    BMP_PYRAMID_BOX,        // Moyenne des blocs 2x2 (mipmap classique, le plus rapide)
+    BMP_PYRAMID_GAUSSIAN    // Noyau 5x5 [1 4 6 4 1] / 16 (moins de repliement)
+} t_pyramid_filter;
+
+/*
+ * Pyramide : level[0] est une copie de l'image, level[k] mesure
+ * floor(largeur / 2^k) x floor(hauteur / 2^k)
+ */
+typedef struct {
+    uint8_t *arena;                             // Bloc unique contenant tous les niveaux
+    size_t arenaSize;
+    int levels;                                 // Nombre de niveaux (1 : image seule)
+    t_pyramid_filter filter;
+    t_bmp_view level[BMP_PYRAMID_MAX_LEVELS];   // Niveaux, de haut en bas, lignes alignées sur 16 octets
+} t_bmp_pyramid;
+
+/* bmp_buildPyramid
+ * Rôle : Construit la pyramide d'une image ou d'une zone
+ * Paramètres :
+ *   src     - Image de départ (1, 3 ou 4 composantes), copiée au niveau 0
+ *   filter  - Filtre de réduction
+ *   minSize - Les réductions s'arrêtent avant qu'une dimension passe sous
+ *             minSize (1 : jusqu'à un pixel de large ou de haut)
+ * Retour : Nouvelle pyramide à libérer avec bmp_pyramidFree, NULL si erreur
+ */
+t_bmp_pyramid *bmp_buildPyramid(const t_bmp_view *src, t_pyramid_filter filter, int minSize);
+
+/* bmp8_buildPyramid / bmp24_buildPyramid
+ * Rôle : Construit la pyramide d'une image entière
+ * Paramètres : Identiques à bmp_buildPyramid
+ */
+t_bmp_pyramid *bmp8_buildPyramid(t_bmp8 *img, t_pyramid_filter filter, int minSize);
+t_bmp_pyramid *bmp24_buildPyramid(t_bmp24 *img, t_pyramid_filter filter, int minSize);
+
+void bmp_pyramidFree(t_bmp_pyramid *pyramid);
+
+/* bmp_pyramidLevelFor
+ * Rôle : Choisit le niveau à afficher pour une taille donnée
+ * Paramètres :
+ *   pyramid       - Pyramide
+ *   width, height - Taille de l'affichage en pixels
+ * Retour : Le plus petit niveau encore au moins aussi grand que l'affichage
+ *          dans les deux dimensions (0 si l'affichage dépasse l'image), -1 si erreur
+ */
+int bmp_pyramidLevelFor(const t_bmp_pyramid *pyramid, int width, int height);
+
+/* bmp8_pyramidImage / bmp24_pyramidImage
+ * Rôle : Copie un niveau dans une nouvelle image (aperçu à modifier ou enregistrer)
+ * Paramètres :
+ *   pyramid - Pyramide à 1 (bmp8) ou 3 (bmp24) composantes
+ *   level   - Niveau voulu
+ * Retour : Nouvelle image, NULL si erreur
+ */
+t_bmp8 *bmp8_pyramidImage(const t_bmp_pyramid *pyramid, int level);
+t_bmp24 *bmp24_pyramidImage(const t_bmp_pyramid *pyramid, int level);
+
+/* bmp_pyramidFind
+ * Rôle : Cherche la position d'un motif, du niveau le plus petit au plus
+ *        grand : recherche exhaustive sur le niveau grossier, puis
+ *        affinage à +/- 2 pixels autour de la position doublée
+ * Paramètres :
+ *   image - Pyramide de l'image où chercher
+ *   templ - Pyramide du motif (même filtre et mêmes composantes)
+ *   x, y  - Reçoivent le coin haut gauche du motif dans l'image (niveau 0)
+ * Retour : Somme des écarts absolus à cette position (0 : identique), -1 si erreur
+ * Note : La recherche commence au niveau le plus petit où le motif
+ *        mesure encore au moins 8 pixels de côté
+ */
+int64_t bmp_pyramidFind(const t_bmp_pyramid *image, const t_bmp_pyramid *templ, int *x, int *y);
+
+#endif
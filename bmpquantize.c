@@ -0,0 +1,667 @@
+/**
+ * @file bmpquantize.c
+ *
+ * @brief
+ * Les deux méthodes de palette partent d'un histogramme des couleurs
+ * réduites à 5 bits par composante (32768 cases, calculé en parallèle).
+ * La correspondance couleur -> index passe par un cube de 32x32x32 cases
+ * dont chacune contient l'index de la couleur de palette la plus proche
+ * de son centre : un accès mémoire par pixel.
+ * La diffusion d'erreur est séquentielle dans une ligne, mais la ligne y
+ * peut avancer dès que la ligne y - 1 a deux pixels d'avance (front
+ * d'onde) : les threads se partagent les lignes dans l'ordre et publient
+ * leur progression.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpquantize.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define QUANTIZE_BITS 5
+#define QUANTIZE_SIDE (1 << QUANTIZE_BITS)
+#define QUANTIZE_CELLS (QUANTIZE_SIDE * QUANTIZE_SIDE * QUANTIZE_SIDE)
+#define QUANTIZE_GRAIN 32
+#define QUANTIZE_PROGRESS_STEP 32   // Pixels entre deux publications de progression
+#define QUANTIZE_OCTREE_DEPTH QUANTIZE_BITS
+
+typedef struct {
+    uint8_t **rows;
+    int width;
+    uint32_t *counts;       // QUANTIZE_CELLS cases
+    uint64_t *sums;         // Somme des R, G, B de chaque case (3 * QUANTIZE_CELLS)
+    pthread_mutex_t lock;
+    atomic_int failed;      // Une bande n'a pas pu allouer ses tables
+} t_quantize_histogram_pass;
+
+typedef struct {
+    const t_palette *palette;
+    uint8_t *cube;          // QUANTIZE_CELLS index
+} t_quantize_cube_pass;
+
+typedef struct {
+    t_pixel **src;          // Lignes de l'image source (de haut en bas)
+    t_bmp8 *dst;
+    int width;
+    int height;
+    const uint8_t *cube;
+    const t_palette *palette;
+    atomic_int nextRow;     // Prochaine ligne à prendre (diffusion d'erreur)
+    atomic_int *progress;   // Pixels terminés par ligne
+    int32_t *errors;        // Anneau de lignes d'erreur (3 * (width + 2) valeurs)
+    int ringSize;
+} t_quantize_map_pass;
+
+/* Une case non vide de l'histogramme des couleurs */
+typedef struct {
+    uint8_t r, g, b;        // Couleur moyenne des pixels de la case
+    uint32_t count;
+    uint64_t sum[3];        // Sommes exactes, pour les moyennes de la palette
+} t_quantize_color;
+
+
+static inline int quantize_cell(int r, int g, int b) {
+    return ((r >> (8 - QUANTIZE_BITS)) << (2 * QUANTIZE_BITS)) |
+           ((g >> (8 - QUANTIZE_BITS)) << QUANTIZE_BITS) |
+           (b >> (8 - QUANTIZE_BITS));
+}
+
+
+static inline uint8_t quantize_cellCenter(int index) {
+    return (uint8_t)((index << (8 - QUANTIZE_BITS)) | (1 << (7 - QUANTIZE_BITS)));
+}
+
+
+/* HISTOGRAMME DES COULEURS */
+
+static void quantize_histogramBand(void *arg, int begin, int end) {
+    t_quantize_histogram_pass *pass = (t_quantize_histogram_pass *)arg;
+    uint32_t *counts = (uint32_t *)calloc(QUANTIZE_CELLS, sizeof(uint32_t));
+    uint64_t *sums = (uint64_t *)calloc(3 * QUANTIZE_CELLS, sizeof(uint64_t));
+
+    if (counts == NULL || sums == NULL) {
+        printf("Erreur: Impossible d'allouer l'histogramme des couleurs\n");
+        free(counts);
+        free(sums);
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int y = begin; y < end; y++) {
+        const t_pixel *row = (const t_pixel *)pass->rows[y];
+        for (int x = 0; x < pass->width; x++) {
+            int cell = quantize_cell(row[x].red, row[x].green, row[x].blue);
+            counts[cell]++;
+            sums[cell * 3] += row[x].red;
+            sums[cell * 3 + 1] += row[x].green;
+            sums[cell * 3 + 2] += row[x].blue;
+        }
+    }
+
+    pthread_mutex_lock(&pass->lock);
+    for (int i = 0; i < QUANTIZE_CELLS; i++) {
+        pass->counts[i] += counts[i];
+    }
+    for (int i = 0; i < 3 * QUANTIZE_CELLS; i++) {
+        pass->sums[i] += sums[i];
+    }
+    pthread_mutex_unlock(&pass->lock);
+    free(counts);
+    free(sums);
+}
+
+
+/* Liste des couleurs présentes, renvoie leur nombre ou -1 */
+static int quantize_colors(t_bmp24 *img, t_quantize_color **colors) {
+    uint8_t **rows = bmp24_getRows(img);
+    uint32_t *counts = (uint32_t *)calloc(QUANTIZE_CELLS, sizeof(uint32_t));
+    uint64_t *sums = (uint64_t *)calloc(3 * QUANTIZE_CELLS, sizeof(uint64_t));
+
+    if (rows == NULL || counts == NULL || sums == NULL) {
+        printf("Erreur: Impossible d'allouer l'histogramme des couleurs\n");
+        free(rows);
+        free(counts);
+        free(sums);
+        return -1;
+    }
+
+    t_quantize_histogram_pass pass;
+    pass.rows = rows;
+    pass.width = img->width;
+    pass.counts = counts;
+    pass.sums = sums;
+    pthread_mutex_init(&pass.lock, NULL);
+    atomic_init(&pass.failed, 0);
+    bmp_parallelFor(img->height, QUANTIZE_GRAIN, quantize_histogramBand, &pass);
+    pthread_mutex_destroy(&pass.lock);
+    free(rows);
+
+    if (atomic_load(&pass.failed) != 0) {
+        free(counts);
+        free(sums);
+        return -1;
+    }
+
+    int used = 0;
+    for (int i = 0; i < QUANTIZE_CELLS; i++) {
+        used += (counts[i] != 0);
+    }
+
+    *colors = (t_quantize_color *)malloc((size_t)(used > 0 ? used : 1) * sizeof(t_quantize_color));
+    if (*colors == NULL) {
+        printf("Erreur: Impossible d'allouer la liste des couleurs\n");
+        free(counts);
+        free(sums);
+        return -1;
+    }
+
+    int n = 0;
+    for (int i = 0; i < QUANTIZE_CELLS; i++) {
+        if (counts[i] != 0) {
+            t_quantize_color *color = &(*colors)[n++];
+            color->count = counts[i];
+            color->sum[0] = sums[i * 3];
+            color->sum[1] = sums[i * 3 + 1];
+            color->sum[2] = sums[i * 3 + 2];
+            color->r = (uint8_t)((color->sum[0] + counts[i] / 2) / counts[i]);
+            color->g = (uint8_t)((color->sum[1] + counts[i] / 2) / counts[i]);
+            color->b = (uint8_t)((color->sum[2] + counts[i] / 2) / counts[i]);
+        }
+    }
+
+    free(counts);
+    free(sums);
+    return n;
+}
+
+
+/* COUPE MÉDIANE */
+
+typedef struct {
+    int begin, end;         // Couleurs de la boîte dans le tableau
+    int axis;               // Composante la plus étendue
+    int range;              // Étendue sur cet axe
+} t_quantize_box;
+
+static inline uint8_t quantize_component(const t_quantize_color *c, int axis) {
+    return (axis == 0) ? c->r : ((axis == 1) ? c->g : c->b);
+}
+
+
+static int quantize_compareRed(const void *a, const void *b) {
+    return (int)((const t_quantize_color *)a)->r - (int)((const t_quantize_color *)b)->r;
+}
+
+
+static int quantize_compareGreen(const void *a, const void *b) {
+    return (int)((const t_quantize_color *)a)->g - (int)((const t_quantize_color *)b)->g;
+}
+
+
+static int quantize_compareBlue(const void *a, const void *b) {
+    return (int)((const t_quantize_color *)a)->b - (int)((const t_quantize_color *)b)->b;
+}
+
+
+static void quantize_measureBox(const t_quantize_color *colors, t_quantize_box *box) {
+    int min[3] = {255, 255, 255}, max[3] = {0, 0, 0};
+
+    for (int i = box->begin; i < box->end; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            int v = quantize_component(&colors[i], axis);
+            min[axis] = (v < min[axis]) ? v : min[axis];
+            max[axis] = (v > max[axis]) ? v : max[axis];
+        }
+    }
+
+    box->axis = 0;
+    box->range = max[0] - min[0];
+    for (int axis = 1; axis < 3; axis++) {
+        if (max[axis] - min[axis] > box->range) {
+            box->axis = axis;
+            box->range = max[axis] - min[axis];
+        }
+    }
+}
+
+
+static void quantize_medianCut(t_quantize_color *colors, int n, int wanted, t_palette *palette) {
+    t_quantize_box boxes[BMP_PALETTE_MAX];
+    int count = 1;
+
+    boxes[0].begin = 0;
+    boxes[0].end = n;
+    quantize_measureBox(colors, &boxes[0]);
+
+    while (count < wanted) {
+        // Boîte la plus étendue parmi celles qui contiennent plusieurs couleurs
+        int best = -1;
+        for (int i = 0; i < count; i++) {
+            if (boxes[i].end - boxes[i].begin > 1 && (best < 0 || boxes[i].range > boxes[best].range)) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        t_quantize_box *box = &boxes[best];
+        int (*compare)(const void *, const void *) = (box->axis == 0) ? quantize_compareRed :
+                                                    ((box->axis == 1) ? quantize_compareGreen : quantize_compareBlue);
+        qsort(colors + box->begin, box->end - box->begin, sizeof(t_quantize_color), compare);
+
+        // Coupe à la médiane des pixels (et non des couleurs)
+        uint64_t total = 0, half = 0;
+        for (int i = box->begin; i < box->end; i++) {
+            total += colors[i].count;
+        }
+        int cut = box->begin + 1;
+        for (int i = box->begin; i < box->end - 1; i++) {
+            half += colors[i].count;
+            cut = i + 1;
+            if (half * 2 >= total) {
+                break;
+            }
+        }
+
+        boxes[count].begin = cut;
+        boxes[count].end = box->end;
+        box->end = cut;
+        quantize_measureBox(colors, box);
+        quantize_measureBox(colors, &boxes[count]);
+        count++;
+    }
+
+    palette->count = count;
+    for (int i = 0; i < count; i++) {
+        uint64_t sum[3] = {0, 0, 0}, weight = 0;
+        for (int j = boxes[i].begin; j < boxes[i].end; j++) {
+            sum[0] += colors[j].sum[0];
+            sum[1] += colors[j].sum[1];
+            sum[2] += colors[j].sum[2];
+            weight += colors[j].count;
+        }
+        palette->colors[i].red = (uint8_t)((sum[0] + weight / 2) / weight);
+        palette->colors[i].green = (uint8_t)((sum[1] + weight / 2) / weight);
+        palette->colors[i].blue = (uint8_t)((sum[2] + weight / 2) / weight);
+    }
+}
+
+
+/* OCTREE */
+
+typedef struct {
+    uint64_t count;
+    uint64_t sum[3];
+    int children[8];        // -1 si absent
+    int childCount;
+    int level;
+} t_octree_node;
+
+/* Candidat à la fusion : trié par nombre de pixels croissant */
+typedef struct {
+    uint64_t count;
+    int node;
+} t_octree_candidate;
+
+
+static int quantize_compareCandidates(const void *a, const void *b) {
+    uint64_t ca = ((const t_octree_candidate *)a)->count;
+    uint64_t cb = ((const t_octree_candidate *)b)->count;
+    return (ca > cb) - (ca < cb);
+}
+
+
+static int quantize_octreeNode(t_octree_node *nodes, int *used, int level) {
+    int index = (*used)++;
+    memset(&nodes[index], 0, sizeof(t_octree_node));
+    memset(nodes[index].children, -1, sizeof(nodes[index].children));
+    nodes[index].level = level;
+    return index;
+}
+
+
+static int quantize_octree(const t_quantize_color *colors, int n, int wanted, t_palette *palette) {
+    // Au plus une feuille par couleur et un noeud par niveau au-dessus
+    int capacity = n * (QUANTIZE_OCTREE_DEPTH + 1) + 1;
+    t_octree_node *nodes = (t_octree_node *)malloc((size_t)capacity * sizeof(t_octree_node));
+    t_octree_candidate *order = (t_octree_candidate *)malloc((size_t)capacity * sizeof(t_octree_candidate));
+    if (nodes == NULL || order == NULL) {
+        printf("Erreur: Impossible d'allouer l'octree\n");
+        free(nodes);
+        free(order);
+        return -1;
+    }
+
+    int used = 0, leaves = 0;
+    quantize_octreeNode(nodes, &used, 0);
+
+    for (int i = 0; i < n; i++) {
+        int node = 0;
+        for (int level = 0; level < QUANTIZE_OCTREE_DEPTH; level++) {
+            int shift = 7 - level;
+            int child = (((colors[i].r >> shift) & 1) << 2) | (((colors[i].g >> shift) & 1) << 1) |
+                        ((colors[i].b >> shift) & 1);
+            if (nodes[node].children[child] < 0) {
+                int created = quantize_octreeNode(nodes, &used, level + 1);
+                nodes[node].children[child] = created;
+                nodes[node].childCount++;
+            }
+            node = nodes[node].children[child];
+        }
+        nodes[node].count += colors[i].count;
+        nodes[node].sum[0] += colors[i].sum[0];
+        nodes[node].sum[1] += colors[i].sum[1];
+        nodes[node].sum[2] += colors[i].sum[2];
+        leaves++;
+    }
+
+    // Nombre de pixels de chaque sous-arbre, du niveau le plus profond vers la racine
+    for (int level = QUANTIZE_OCTREE_DEPTH - 1; level >= 0; level--) {
+        for (int i = 0; i < used; i++) {
+            if (nodes[i].level != level) {
+                continue;
+            }
+            for (int c = 0; c < 8; c++) {
+                if (nodes[i].children[c] >= 0) {
+                    nodes[i].count += nodes[nodes[i].children[c]].count;
+                }
+            }
+        }
+    }
+
+    // Fusion des noeuds les moins peuplés, du niveau le plus profond vers la racine
+    for (int level = QUANTIZE_OCTREE_DEPTH - 1; level >= 0 && leaves > wanted; level--) {
+        int candidates = 0;
+        for (int i = 0; i < used; i++) {
+            if (nodes[i].level == level && nodes[i].childCount > 0) {
+                order[candidates].count = nodes[i].count;
+                order[candidates].node = i;
+                candidates++;
+            }
+        }
+        qsort(order, candidates, sizeof(t_octree_candidate), quantize_compareCandidates);
+
+        for (int k = 0; k < candidates && leaves > wanted; k++) {
+            t_octree_node *node = &nodes[order[k].node];
+            for (int c = 0; c < 8; c++) {
+                int child = node->children[c];
+                if (child >= 0) {
+                    node->sum[0] += nodes[child].sum[0];
+                    node->sum[1] += nodes[child].sum[1];
+                    node->sum[2] += nodes[child].sum[2];
+                    node->children[c] = -1;
+                }
+            }
+            leaves -= node->childCount - 1;
+            node->childCount = 0;
+        }
+    }
+
+    // Les feuilles restantes forment la palette (parcours depuis la racine)
+    int stack[QUANTIZE_OCTREE_DEPTH * 8 + 1], top = 0;
+    palette->count = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        t_octree_node *node = &nodes[stack[--top]];
+        if (node->childCount == 0) {
+            if (node->count > 0 && palette->count < BMP_PALETTE_MAX) {
+                t_pixel *color = &palette->colors[palette->count++];
+                color->red = (uint8_t)((node->sum[0] + node->count / 2) / node->count);
+                color->green = (uint8_t)((node->sum[1] + node->count / 2) / node->count);
+                color->blue = (uint8_t)((node->sum[2] + node->count / 2) / node->count);
+            }
+            continue;
+        }
+        for (int c = 7; c >= 0; c--) {
+            if (node->children[c] >= 0) {
+                stack[top++] = node->children[c];
+            }
+        }
+    }
+
+    free(nodes);
+    free(order);
+    return 0;
+}
+
+
+int bmp24_buildPalette(t_bmp24 *img, int colors, t_palette_method method, t_palette *palette) {
+    if (img == NULL || img->data == NULL || palette == NULL || colors < 2 || colors > BMP_PALETTE_MAX) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    t_quantize_color *list = NULL;
+    int n = quantize_colors(img, &list);
+    if (n < 0) {
+        return -1;
+    }
+
+    int status = 0;
+    if (n == 0) {
+        palette->count = 1;
+        memset(&palette->colors[0], 0, sizeof(t_pixel));
+    } else if (method == BMP_PALETTE_OCTREE) {
+        status = quantize_octree(list, n, colors, palette);
+    } else {
+        quantize_medianCut(list, n, colors, palette);
+    }
+
+    free(list);
+    return status;
+}
+
+
+/* CUBE DE CORRESPONDANCE */
+
+/* Une bande = des tranches de rouge du cube */
+static void quantize_cubeBand(void *arg, int begin, int end) {
+    const t_quantize_cube_pass *pass = (const t_quantize_cube_pass *)arg;
+    const t_palette *palette = pass->palette;
+
+    for (int r = begin; r < end; r++) {
+        int cr = quantize_cellCenter(r);
+        for (int g = 0; g < QUANTIZE_SIDE; g++) {
+            int cg = quantize_cellCenter(g);
+            for (int b = 0; b < QUANTIZE_SIDE; b++) {
+                int cb = quantize_cellCenter(b);
+                int best = 0, bestDistance = 1 << 30;
+                for (int i = 0; i < palette->count; i++) {
+                    int dr = cr - palette->colors[i].red;
+                    int dg = cg - palette->colors[i].green;
+                    int db = cb - palette->colors[i].blue;
+                    int distance = dr * dr + dg * dg + db * db;
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        best = i;
+                    }
+                }
+                pass->cube[(r << (2 * QUANTIZE_BITS)) | (g << QUANTIZE_BITS) | b] = (uint8_t)best;
+            }
+        }
+    }
+}
+
+
+/* CONVERSION */
+
+static inline uint8_t *quantize_dstRow(const t_quantize_map_pass *pass, int y) {
+    // L'image 8 bits est stockée de bas en haut
+    return pass->dst->data + (size_t)(pass->height - 1 - y) * (pass->width + pass->dst->rowPadding);
+}
+
+
+static void quantize_mapBand(void *arg, int begin, int end) {
+    const t_quantize_map_pass *pass = (const t_quantize_map_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        const t_pixel *src = pass->src[y];
+        uint8_t *dst = quantize_dstRow(pass, y);
+        for (int x = 0; x < pass->width; x++) {
+            dst[x] = pass->cube[quantize_cell(src[x].red, src[x].green, src[x].blue)];
+        }
+    }
+}
+
+
+static inline int quantize_clamp(int v) {
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+
+/* Attend que la ligne y ait au moins needed pixels terminés */
+static inline int quantize_waitRow(atomic_int *progress, int needed) {
+    int done;
+    while ((done = atomic_load_explicit(progress, memory_order_acquire)) < needed) {
+        sched_yield();
+    }
+    return done;
+}
+
+
+/*
+ * Floyd–Steinberg : chaque participant prend la ligne suivante puis la
+ * parcourt en suivant la progression de la ligne du dessus. Les erreurs
+ * sont comptées en seizièmes.
+ */
+static void quantize_ditherWorker(void *arg, int begin, int end) {
+    t_quantize_map_pass *pass = (t_quantize_map_pass *)arg;
+    int w = pass->width, stride = 3 * (w + 2);
+    (void)begin;
+    (void)end;
+
+    for (;;) {
+        int y = atomic_fetch_add(&pass->nextRow, 1);
+        if (y >= pass->height) {
+            break;
+        }
+
+        // Le tampon de la ligne y + 1 servait à la ligne y + 1 - ringSize : elle doit être finie
+        if (y + 1 - pass->ringSize >= 0) {
+            quantize_waitRow(&pass->progress[y + 1 - pass->ringSize], w);
+        }
+        int32_t *incoming = pass->errors + (size_t)(y % pass->ringSize) * stride + 3;
+        int32_t *outgoing = pass->errors + (size_t)((y + 1) % pass->ringSize) * stride + 3;
+        memset(outgoing - 3, 0, (size_t)stride * sizeof(int32_t));
+
+        const t_pixel *src = pass->src[y];
+        uint8_t *dst = quantize_dstRow(pass, y);
+        int32_t right[3] = {0, 0, 0};
+        int available = (y == 0) ? w : 0;
+
+        for (int x = 0; x < w; x++) {
+            // Les erreurs de la case x sont complètes quand la ligne du dessus a fini x + 1
+            int needed = (x + 2 < w) ? x + 2 : w;
+            if (available < needed) {
+                available = quantize_waitRow(&pass->progress[y - 1], needed);
+            }
+
+            int wanted[3] = {
+                quantize_clamp(src[x].red + ((incoming[x * 3] + right[0] + 8) >> 4)),
+                quantize_clamp(src[x].green + ((incoming[x * 3 + 1] + right[1] + 8) >> 4)),
+                quantize_clamp(src[x].blue + ((incoming[x * 3 + 2] + right[2] + 8) >> 4))
+            };
+            uint8_t index = pass->cube[quantize_cell(wanted[0], wanted[1], wanted[2])];
+            const t_pixel *chosen = &pass->palette->colors[index];
+            int error[3] = {wanted[0] - chosen->red, wanted[1] - chosen->green, wanted[2] - chosen->blue};
+            dst[x] = index;
+
+            for (int c = 0; c < 3; c++) {
+                right[c] = error[c] * 7;
+                outgoing[(x - 1) * 3 + c] += error[c] * 3;
+                outgoing[x * 3 + c] += error[c] * 5;
+                outgoing[(x + 1) * 3 + c] += error[c];
+            }
+
+            if ((x + 1) % QUANTIZE_PROGRESS_STEP == 0) {
+                atomic_store_explicit(&pass->progress[y], x + 1, memory_order_release);
+            }
+        }
+        atomic_store_explicit(&pass->progress[y], w, memory_order_release);
+    }
+}
+
+
+t_bmp8 *bmp24_applyPalette(t_bmp24 *img, const t_palette *palette, int dither) {
+    if (img == NULL || img->data == NULL || palette == NULL || palette->count < 1 ||
+        palette->count > BMP_PALETTE_MAX) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp8 *dst = bmp8_allocate(img->width, img->height);
+    uint8_t *cube = (uint8_t *)malloc(QUANTIZE_CELLS);
+    if (dst == NULL || cube == NULL) {
+        printf("Erreur: Impossible d'allouer l'image indexée\n");
+        bmp8_free(dst);
+        free(cube);
+        return NULL;
+    }
+
+    // Palette dans colorTable : B, G, R, réservé
+    memset(dst->colorTable, 0, BMP_COLOR_TABLE_SIZE);
+    for (int i = 0; i < palette->count; i++) {
+        dst->colorTable[i * 4] = palette->colors[i].blue;
+        dst->colorTable[i * 4 + 1] = palette->colors[i].green;
+        dst->colorTable[i * 4 + 2] = palette->colors[i].red;
+    }
+
+    t_quantize_cube_pass cubePass = {palette, cube};
+    bmp_parallelFor(QUANTIZE_SIDE, 1, quantize_cubeBand, &cubePass);
+
+    t_quantize_map_pass pass;
+    pass.src = img->data;
+    pass.dst = dst;
+    pass.width = img->width;
+    pass.height = img->height;
+    pass.cube = cube;
+    pass.palette = palette;
+
+    if (!dither) {
+        bmp_parallelFor(img->height, QUANTIZE_GRAIN, quantize_mapBand, &pass);
+        free(cube);
+        return dst;
+    }
+
+    int workers = bmp_threadCount();
+    pass.ringSize = 2 * workers + 2;
+    atomic_init(&pass.nextRow, 0);
+    pass.progress = (atomic_int *)malloc((size_t)img->height * sizeof(atomic_int));
+    pass.errors = (int32_t *)malloc((size_t)pass.ringSize * 3 * (img->width + 2) * sizeof(int32_t));
+    if (pass.progress == NULL || pass.errors == NULL) {
+        printf("Erreur: Impossible d'allouer les tampons de diffusion\n");
+        free(pass.progress);
+        free(pass.errors);
+        free(cube);
+        bmp8_free(dst);
+        return NULL;
+    }
+    for (int y = 0; y < img->height; y++) {
+        atomic_init(&pass.progress[y], 0);
+    }
+    memset(pass.errors, 0, (size_t)3 * (img->width + 2) * sizeof(int32_t));   // Ligne 0 : pas d'erreur entrante
+
+    bmp_parallelFor(workers, 1, quantize_ditherWorker, &pass);
+
+    free(pass.progress);
+    free(pass.errors);
+    free(cube);
+    return dst;
+}
+
+
+t_bmp8 *bmp24_quantize(t_bmp24 *img, int colors, t_palette_method method, int dither) {
+    t_palette palette;
+    if (bmp24_buildPalette(img, colors, method, &palette) != 0) {
+        return NULL;
+    }
+    return bmp24_applyPalette(img, &palette, dither);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file bmpquantize.h
+ *
+ * @brief
+ * Réduction des couleurs : conversion d'une image 24 bits en image 8 bits
+ * indexée (palette de 256 couleurs au plus dans colorTable). Le fichier
+ * obtenu est trois fois plus petit. La palette est choisie par coupe
+ * médiane ou par octree, et chaque pixel trouve sa couleur la plus proche
+ * dans un cube de correspondance précalculé. La diffusion d'erreur de
+ * Floyd–Steinberg est optionnelle.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPQUANTIZE_H
+#define BMPQUANTIZE_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+/* Nombre maximal de couleurs d'une palette */
+#define BMP_PALETTE_MAX 256
+
+/*
+ * Méthodes de construction de la palette
+ */
+typedef enum {
+    BMP_PALETTE_MEDIAN_CUT, // Découpe récursive de la boîte la plus étendue
+    BMP_PALETTE_OCTREE      // Fusion des branches les moins peuplées d'un octree
+} t_palette_method;
+
+/*
+ * Palette de couleurs
+ */
+typedef struct {
+    int count;                          // Nombre de couleurs utilisées
+    t_pixel colors[BMP_PALETTE_MAX];
+} t_palette;
+
+/* bmp24_buildPalette
+ * Rôle : Choisit une palette représentative de l'image
+ * Paramètres :
+ *   img     - Image source
+ *   colors  - Nombre de couleurs voulu (2 à BMP_PALETTE_MAX)
+ *   method  - Méthode de construction
+ *   palette - Reçoit la palette (count peut être inférieur à colors si
+ *             l'image contient moins de couleurs)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_buildPalette(t_bmp24 *img, int colors, t_palette_method method, t_palette *palette);
+
+/* bmp24_applyPalette
+ * Rôle : Convertit l'image en image indexée sur une palette donnée
+ * Paramètres :
+ *   img     - Image source (non modifiée)
+ *   palette - Palette à utiliser (recopiée dans colorTable)
+ *   dither  - 1 : diffusion d'erreur de Floyd–Steinberg, 0 : couleur la plus proche
+ * Retour : Nouvelle image 8 bits indexée, NULL si erreur
+ */
+t_bmp8 *bmp24_applyPalette(t_bmp24 *img, const t_palette *palette, int dither);
+
+/* bmp24_quantize
+ * Rôle : Construit la palette puis convertit l'image (les deux étapes ci-dessus)
+ * Paramètres :
+ *   img    - Image source (non modifiée)
+ *   colors - Nombre de couleurs (2 à BMP_PALETTE_MAX)
+ *   method - Méthode de construction de la palette
+ *   dither - 1 : diffusion d'erreur, 0 : sans
+ * Retour : Nouvelle image 8 bits indexée, NULL si erreur
+ */
+t_bmp8 *bmp24_quantize(t_bmp24 *img, int colors, t_palette_method method, int dither);
+
+#endif
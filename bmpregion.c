@@ -0,0 +1,188 @@
+/**
+ * @file bmpregion.c
+ *
+ * @brief
+ * L'en-tête donne la position de chaque ligne dans le fichier (début des
+ * pixels, taille de ligne avec padding, ordre des lignes). Chaque ligne de
+ * la zone est lue par un pread de ses seuls octets, dans l'ordre croissant
+ * des positions pour que le disque lise en avançant.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpregion.h"
+#include "bmpprobe.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Fichier ouvert et zone rognée aux dimensions de l'image
+ */
+typedef struct {
+    int fd;
+    t_bmp_probe info;
+    uint8_t start[BMP_PROBE_SIZE];  // Début du fichier (en-têtes)
+    int x;
+    int y;
+    int width;
+    int height;
+} t_region;
+
+
+/*
+ * Ouvre le fichier, vérifie sa profondeur et rogne la zone demandée
+ * Renvoie 0 si la zone est lisible, -1 sinon (message dans error)
+ */
+static int region_open(t_region *region, const char *filename, int bits,
+                       int x, int y, int width, int height, const char **error) {
+    region->fd = bmp_fileOpen(filename);
+    if (region->fd < 0) {
+        *error = "Impossible d'ouvrir le fichier";
+        return -1;
+    }
+
+    long got = bmp_fileReadAt(region->fd, region->start, sizeof(region->start), 0);
+    if (got < 0 || bmp_probeHeader(region->start, (size_t)got, &region->info) != 0) {
+        *error = "Le fichier n'est pas au format BMP";
+        return -1;
+    }
+    if (region->info.bitDepth != bits || region->info.compression != BMP_BI_RGB) {
+        *error = "Profondeur non prise en charge ou image compressée";
+        return -1;
+    }
+
+    int x1 = (x + width > region->info.width) ? region->info.width : x + width;
+    int y1 = (y + height > region->info.height) ? region->info.height : y + height;
+    region->x = (x < 0) ? 0 : x;
+    region->y = (y < 0) ? 0 : y;
+    region->width = x1 - region->x;
+    region->height = y1 - region->y;
+    if (width <= 0 || height <= 0 || region->width <= 0 || region->height <= 0) {
+        *error = "La zone demandée est hors de l'image";
+        return -1;
+    }
+    return 0;
+}
+
+
+/*
+ * Position dans le fichier du premier pixel de la zone sur la i-ème ligne
+ * lue ; *row reçoit la ligne correspondante de la zone (0 = haut).
+ * Les lignes sont parcourues dans l'ordre du fichier.
+ */
+static uint64_t region_rowOffset(const t_region *region, int i, int *row) {
+    const t_bmp_probe *info = &region->info;
+
+    *row = info->topDown ? i : region->height - 1 - i;
+    int imageRow = region->y + *row;
+    int fileRow = info->topDown ? imageRow : info->height - 1 - imageRow;
+    return (uint64_t)info->dataOffset + (uint64_t)fileRow * info->rowSize +
+           (uint64_t)region->x * (info->bitDepth / 8);
+}
+
+
+t_bmp8 *bmp8_loadRegion(const char *filename, int x, int y, int width, int height) {
+    t_region region;
+    const char *error = NULL;
+
+    if (filename == NULL || region_open(&region, filename, 8, x, y, width, height, &error) != 0) {
+        fprintf(stderr, "Erreur: %s\n", (error != NULL) ? error : "Paramètres invalides");
+        if (filename != NULL) {
+            bmp_fileClose(region.fd);
+        }
+        return NULL;
+    }
+
+    t_bmp8 *img = bmp8_allocate((uint32_t)region.width, (uint32_t)region.height);
+    if (img == NULL) {
+        bmp_fileClose(region.fd);
+        return NULL;
+    }
+
+    // Palette du fichier (colorsUsed entrées, 256 si 0) juste après l'en-tête d'informations
+    uint32_t colors = region.info.colorsUsed;
+    if (colors == 0 || colors > 256) {
+        colors = 256;
+    }
+    memset(img->colorTable, 0, BMP_COLOR_TABLE_SIZE);
+    int status = (bmp_fileReadAt(region.fd, img->colorTable, colors * 4,
+                                 14 + (uint64_t)region.info.infoSize) == (long)(colors * 4)) ? 0 : -1;
+
+    for (int i = 0; status == 0 && i < region.height; i++) {
+        int row;
+        uint64_t offset = region_rowOffset(&region, i, &row);
+        if (bmp_fileReadAt(region.fd, bmp8_row(img, (uint32_t)row), (size_t)region.width, offset) != region.width) {
+            status = -1;
+        }
+    }
+    bmp_fileClose(region.fd);
+
+    if (status != 0) {
+        fprintf(stderr, "Erreur: Impossible de lire la zone de l'image\n");
+        bmp8_free(img);
+        return NULL;
+    }
+
+    // Résolution du fichier d'origine
+    if (region.info.infoSize >= 40) {
+        memcpy(&img->header[38], &region.start[38], 8);
+    }
+    return img;
+}
+
+
+t_bmp24 *bmp24_loadRegion(const char *filename, int x, int y, int width, int height) {
+    t_region region;
+    const char *error = NULL;
+
+    if (filename == NULL || region_open(&region, filename, 24, x, y, width, height, &error) != 0) {
+        printf("Erreur: %s\n", (error != NULL) ? error : "Paramètres invalides");
+        if (filename != NULL) {
+            bmp_fileClose(region.fd);
+        }
+        return NULL;
+    }
+
+    t_bmp24 *img = bmp24_allocate(region.width, region.height, DEFAULT_DEPTH);
+    size_t span = (size_t)region.width * 3;
+    uint8_t *line = (uint8_t *)malloc(span);
+    if (img == NULL || line == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour la zone\n");
+        bmp24_free(img);
+        free(line);
+        bmp_fileClose(region.fd);
+        return NULL;
+    }
+
+    int status = 0;
+    for (int i = 0; i < region.height; i++) {
+        int row;
+        uint64_t offset = region_rowOffset(&region, i, &row);
+        if (bmp_fileReadAt(region.fd, line, span, offset) != (long)span) {
+            status = -1;
+            break;
+        }
+
+        // Le fichier range B, G, R
+        t_pixel *dst = img->data[row];
+        for (int k = 0; k < region.width; k++) {
+            dst[k].blue = line[3 * k];
+            dst[k].green = line[3 * k + 1];
+            dst[k].red = line[3 * k + 2];
+        }
+    }
+    free(line);
+    bmp_fileClose(region.fd);
+
+    if (status != 0) {
+        printf("Erreur: Impossible de lire la zone de l'image\n");
+        bmp24_free(img);
+        return NULL;
+    }
+
+    img->header_info.xPixelsPerMeter = region.info.xPixelsPerMeter;
+    img->header_info.yPixelsPerMeter = region.info.yPixelsPerMeter;
+    return img;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file bmpregion.h
+ *
+ * @brief
+ * Chargement d'une zone rectangulaire d'un fichier BMP sans lire le reste
+ * de l'image : seuls les octets de la zone sont lus, ligne par ligne, aux
+ * positions calculées à partir de l'en-tête. Extraire une vignette de
+ * 512x512 d'un scan de 20000x20000 ne lit plus que 512 segments de ligne.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPREGION_H
+#define BMPREGION_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+
+/* bmp8_loadRegion
+ * Rôle : Charge une zone d'une image 8 bits non compressée
+ * Paramètres :
+ *   filename - Chemin du fichier
+ *   x, y     - Coin haut gauche de la zone (y compté depuis le haut de l'image)
+ *   width    - Largeur de la zone
+ *   height   - Hauteur de la zone
+ * Retour : Nouvelle image (palette du fichier), NULL si erreur
+ * Note : La zone est rognée aux bords de l'image ; l'ordre des lignes du
+ *        fichier (hauteur négative ou non) est pris en compte
+ */
+t_bmp8 *bmp8_loadRegion(const char *filename, int x, int y, int width, int height);
+
+/* bmp24_loadRegion
+ * Rôle : Charge une zone d'une image 24 bits
+ * Paramètres : Identiques à bmp8_loadRegion
+ * Retour : Nouvelle image, NULL si erreur
+ */
+t_bmp24 *bmp24_loadRegion(const char *filename, int x, int y, int width, int height);
+
+#endif
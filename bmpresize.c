@@ -0,0 +1,679 @@
+/**
+ * @file bmpresize.c
+ *
+ * @brief
+ * Redimensionnement séparable : une passe horizontale et une passe verticale,
+ * chacune pilotée par une table de poids précalculée (un jeu de coefficients
+ * par colonne ou par ligne de destination). Les calculs se font en virgule
+ * fixe sur 14 bits et les boucles internes parcourent des lignes contiguës.
+ * La passe verticale, la plus coûteuse, a une version SSE2 : les octets de
+ * deux lignes source sont entrelacés sur 16 bits et _mm_madd_epi16 ajoute
+ * les deux produits pondérés à l'accumulateur 32 bits en une instruction
+ * (résultat identique à la version scalaire). Les lignes sont réparties en
+ * bandes sur plusieurs threads.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpresize.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define RESIZE_BITS 14
+#define RESIZE_ONE (1 << RESIZE_BITS)
+#define RESIZE_GRAIN 16
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Table de poids pour un axe : pour chaque pixel destination, l'indice du
+ * premier pixel source utilisé et ses coefficients (somme = RESIZE_ONE)
+ */
+typedef struct {
+    int taps;          // Nombre maximal de coefficients par pixel
+    int *start;        // Premier pixel source
+    int *count;        // Nombre de coefficients utilisés
+    int16_t *weights;  // taps coefficients par pixel destination
+} t_resize_table;
+
+typedef struct {
+    const uint8_t *const *src;
+    uint8_t *const *dst;
+    const t_resize_table *table;
+    int width;     // Largeur en pixels des lignes produites (passe H) ou traitées (passe V)
+    int channels;
+    atomic_int failed;  // Une bande n'a pas pu allouer son tampon
+} t_resize_pass;
+
+typedef struct {
+    const uint8_t *const *src;
+    uint8_t *const *dst;
+    int dstWidth;
+    int channels;
+    int factor;
+} t_reduce_pass;
+
+
+static double resize_sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    x *= M_PI;
+    return sin(x) / x;
+}
+
+
+static double resize_support(t_resize_mode mode) {
+    switch (mode) {
+        case BMP_RESIZE_AREA:     return 0.5;
+        case BMP_RESIZE_BILINEAR: return 1.0;
+        case BMP_RESIZE_LANCZOS:  return 3.0;
+        default:                  return 0.5;
+    }
+}
+
+
+static double resize_filter(t_resize_mode mode, double x) {
+    switch (mode) {
+        case BMP_RESIZE_AREA:
+            return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+        case BMP_RESIZE_BILINEAR:
+            x = fabs(x);
+            return (x < 1.0) ? 1.0 - x : 0.0;
+        case BMP_RESIZE_LANCZOS:
+            return (fabs(x) < 3.0) ? resize_sinc(x) * resize_sinc(x / 3.0) : 0.0;
+        default:
+            return 0.0;
+    }
+}
+
+
+static void resize_freeTable(t_resize_table *table) {
+    free(table->start);
+    free(table->count);
+    free(table->weights);
+}
+
+
+/*
+ * Calcule les poids d'un axe. En réduction, le support du filtre est élargi
+ * du facteur d'échelle pour que chaque pixel destination couvre tous les
+ * pixels source qu'il représente (pas d'aliasing).
+ */
+static int resize_buildTable(t_resize_table *table, int srcSize, int dstSize, t_resize_mode mode) {
+    double scale = (double)srcSize / dstSize;
+    double filterScale = (scale > 1.0) ? scale : 1.0;
+    double support = resize_support(mode) * filterScale;
+
+    table->taps = (mode == BMP_RESIZE_NEAREST) ? 1 : (int)ceil(support) * 2 + 1;
+    table->start = (int *)malloc(dstSize * sizeof(int));
+    table->count = (int *)malloc(dstSize * sizeof(int));
+    table->weights = (int16_t *)calloc((size_t)dstSize * table->taps, sizeof(int16_t));
+    double *w = (double *)malloc(table->taps * sizeof(double));
+
+    if (table->start == NULL || table->count == NULL || table->weights == NULL || w == NULL) {
+        printf("Erreur: Impossible d'allouer la table de redimensionnement\n");
+        resize_freeTable(table);
+        free(w);
+        return -1;
+    }
+
+    for (int i = 0; i < dstSize; i++) {
+        double center = (i + 0.5) * scale;
+        int16_t *iw = table->weights + (size_t)i * table->taps;
+
+        if (mode == BMP_RESIZE_NEAREST) {
+            int x = (int)center;
+            table->start[i] = (x < srcSize) ? x : srcSize - 1;
+            table->count[i] = 1;
+            iw[0] = RESIZE_ONE;
+            continue;
+        }
+
+        int xmin = (int)(center - support + 0.5);
+        int xmax = (int)(center + support + 0.5);
+        if (xmin < 0) {
+            xmin = 0;
+        }
+        if (xmax > srcSize) {
+            xmax = srcSize;
+        }
+        if (xmax - xmin > table->taps) {
+            xmax = xmin + table->taps;
+        }
+
+        double total = 0.0;
+        for (int x = xmin; x < xmax; x++) {
+            w[x - xmin] = resize_filter(mode, (x + 0.5 - center) / filterScale);
+            total += w[x - xmin];
+        }
+        if (total == 0.0) {
+            // Cas dégénéré : on se rabat sur le plus proche voisin
+            int x = (int)center;
+            xmin = (x < srcSize) ? x : srcSize - 1;
+            xmax = xmin + 1;
+            w[0] = total = 1.0;
+        }
+
+        // Passage en virgule fixe, l'erreur d'arrondi va au plus gros coefficient
+        int sum = 0, biggest = 0;
+        for (int k = 0; k < xmax - xmin; k++) {
+            iw[k] = (int16_t)lround(w[k] / total * RESIZE_ONE);
+            sum += iw[k];
+            if (iw[k] > iw[biggest]) {
+                biggest = k;
+            }
+        }
+        iw[biggest] += RESIZE_ONE - sum;
+
+        table->start[i] = xmin;
+        table->count[i] = xmax - xmin;
+    }
+
+    free(w);
+    return 0;
+}
+
+
+static inline uint8_t resize_clamp(int32_t acc) {
+    acc >>= RESIZE_BITS;
+    return (acc < 0) ? 0 : ((acc > 255) ? 255 : (uint8_t)acc);
+}
+
+
+/*
+ * Passe horizontale : chaque ligne source donne une ligne de table->width pixels
+ */
+static void resize_horizontalBand(void *arg, int begin, int end) {
+    const t_resize_pass *pass = (const t_resize_pass *)arg;
+    const t_resize_table *t = pass->table;
+    int ch = pass->channels;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *src = pass->src[y];
+        uint8_t *dst = pass->dst[y];
+
+        for (int x = 0; x < pass->width; x++) {
+            const int16_t *w = t->weights + (size_t)x * t->taps;
+            const uint8_t *p = src + (size_t)t->start[x] * ch;
+            int n = t->count[x];
+
+            for (int c = 0; c < ch; c++) {
+                int32_t acc = RESIZE_ONE / 2;
+                for (int k = 0; k < n; k++) {
+                    acc += w[k] * p[k * ch + c];
+                }
+                dst[x * ch + c] = resize_clamp(acc);
+            }
+        }
+    }
+}
+
+
+/* acc += w0 * r0 + w1 * r1 sur n octets */
+static void resize_accumulate2(int32_t *acc, const uint8_t *r0, const uint8_t *r1, int16_t w0, int16_t w1, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    __m128i zero = _mm_setzero_si128();
+    __m128i w = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)w1 << 16) | (uint16_t)w0));
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(r0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r1 + i));
+        __m128i lo = _mm_unpacklo_epi8(a, zero);
+        __m128i hi = _mm_unpackhi_epi8(a, zero);
+        __m128i blo = _mm_unpacklo_epi8(b, zero);
+        __m128i bhi = _mm_unpackhi_epi8(b, zero);
+        // (r0, r1) entrelacés : chaque paire donne w0 * r0 + w1 * r1 sur 32 bits
+        __m128i pairs[4] = {
+            _mm_unpacklo_epi16(lo, blo), _mm_unpackhi_epi16(lo, blo),
+            _mm_unpacklo_epi16(hi, bhi), _mm_unpackhi_epi16(hi, bhi)
+        };
+        for (int q = 0; q < 4; q++) {
+            __m128i *out = (__m128i *)(acc + i + 4 * q);
+            _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), _mm_madd_epi16(pairs[q], w)));
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        acc[i] += w0 * r0[i] + w1 * r1[i];
+    }
+}
+
+
+/* dst = resize_clamp(acc) sur n octets */
+static void resize_store(const int32_t *acc, uint8_t *dst, int n) {
+    int i = 0;
+
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        __m128i v[4];
+        for (int q = 0; q < 4; q++) {
+            v[q] = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(acc + i + 4 * q)), RESIZE_BITS);
+        }
+        // Saturation signée sur 16 bits puis non signée sur 8 bits : borne à [0, 255]
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3])));
+    }
+#endif
+
+    for (; i < n; i++) {
+        dst[i] = resize_clamp(acc[i]);
+    }
+}
+
+
+/*
+ * Passe verticale : chaque ligne destination est une somme pondérée de
+ * lignes source entières, accumulée dans un tampon 32 bits deux lignes
+ * source à la fois
+ */
+static void resize_verticalBand(void *arg, int begin, int end) {
+    t_resize_pass *pass = (t_resize_pass *)arg;
+    const t_resize_table *t = pass->table;
+    int length = pass->width * pass->channels;
+
+    int32_t *acc = (int32_t *)malloc(length * sizeof(int32_t));
+    if (acc == NULL) {
+        printf("Erreur: Impossible d'allouer le tampon de redimensionnement\n");
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int y = begin; y < end; y++) {
+        const int16_t *w = t->weights + (size_t)y * t->taps;
+        uint8_t *dst = pass->dst[y];
+
+        for (int i = 0; i < length; i++) {
+            acc[i] = RESIZE_ONE / 2;
+        }
+        const uint8_t *const *rows = pass->src + t->start[y];
+        int count = t->count[y];
+        int k = 0;
+        for (; k + 2 <= count; k += 2) {
+            resize_accumulate2(acc, rows[k], rows[k + 1], w[k], w[k + 1], length);
+        }
+        if (k < count) {
+            // Dernière ligne seule : poids nul pour la seconde
+            resize_accumulate2(acc, rows[k], rows[k], w[k], 0, length);
+        }
+        resize_store(acc, dst, length);
+    }
+
+    free(acc);
+}
+
+
+static uint8_t **resize_allocRows(int width, int height, int channels, uint8_t **block) {
+    size_t rowSize = (size_t)width * channels;
+    uint8_t **rows = (uint8_t **)malloc(height * sizeof(uint8_t *));
+    *block = (uint8_t *)malloc(rowSize * height);
+
+    if (rows == NULL || *block == NULL) {
+        printf("Erreur: Impossible d'allouer l'image intermédiaire\n");
+        free(rows);
+        free(*block);
+        return NULL;
+    }
+    for (int y = 0; y < height; y++) {
+        rows[y] = *block + rowSize * y;
+    }
+    return rows;
+}
+
+
+int bmp_resizeRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                   uint8_t *const *dstRows, int dstWidth, int dstHeight,
+                   int channels, t_resize_mode mode) {
+    if (srcRows == NULL || dstRows == NULL || srcWidth <= 0 || srcHeight <= 0 ||
+        dstWidth <= 0 || dstHeight <= 0 || channels <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    int needH = (srcWidth != dstWidth);
+    int needV = (srcHeight != dstHeight);
+
+    if (!needH && !needV) {
+        for (int y = 0; y < dstHeight; y++) {
+            memcpy(dstRows[y], srcRows[y], (size_t)dstWidth * channels);
+        }
+        return 0;
+    }
+
+    t_resize_table hTable = {0}, vTable = {0};
+    if (needH && resize_buildTable(&hTable, srcWidth, dstWidth, mode) != 0) {
+        return -1;
+    }
+    if (needV && resize_buildTable(&vTable, srcHeight, dstHeight, mode) != 0) {
+        resize_freeTable(&hTable);
+        return -1;
+    }
+
+    t_resize_pass hPass = {NULL, NULL, &hTable, dstWidth, channels};
+    t_resize_pass vPass = {NULL, NULL, &vTable, 0, channels};
+    atomic_init(&hPass.failed, 0);
+    atomic_init(&vPass.failed, 0);
+    int status = 0;
+
+    if (!needV) {
+        hPass.src = srcRows;
+        hPass.dst = dstRows;
+        bmp_parallelFor(srcHeight, RESIZE_GRAIN, resize_horizontalBand, &hPass);
+    } else if (!needH) {
+        vPass.src = srcRows;
+        vPass.dst = dstRows;
+        vPass.width = srcWidth;
+        bmp_parallelFor(dstHeight, RESIZE_GRAIN, resize_verticalBand, &vPass);
+    } else {
+        // On commence par la passe qui réduit le plus le travail de la suivante
+        double hFirst = (double)srcHeight * dstWidth * hTable.taps + (double)dstHeight * dstWidth * vTable.taps;
+        double vFirst = (double)dstHeight * srcWidth * vTable.taps + (double)dstHeight * dstWidth * hTable.taps;
+        uint8_t *block = NULL;
+        uint8_t **tmp;
+
+        if (hFirst <= vFirst) {
+            tmp = resize_allocRows(dstWidth, srcHeight, channels, &block);
+            if (tmp != NULL) {
+                hPass.src = srcRows;
+                hPass.dst = tmp;
+                bmp_parallelFor(srcHeight, RESIZE_GRAIN, resize_horizontalBand, &hPass);
+                vPass.src = (const uint8_t *const *)tmp;
+                vPass.dst = dstRows;
+                vPass.width = dstWidth;
+                bmp_parallelFor(dstHeight, RESIZE_GRAIN, resize_verticalBand, &vPass);
+            }
+        } else {
+            tmp = resize_allocRows(srcWidth, dstHeight, channels, &block);
+            if (tmp != NULL) {
+                vPass.src = srcRows;
+                vPass.dst = tmp;
+                vPass.width = srcWidth;
+                bmp_parallelFor(dstHeight, RESIZE_GRAIN, resize_verticalBand, &vPass);
+                if (atomic_load(&vPass.failed) == 0) {
+                    hPass.src = (const uint8_t *const *)tmp;
+                    hPass.dst = dstRows;
+                    bmp_parallelFor(dstHeight, RESIZE_GRAIN, resize_horizontalBand, &hPass);
+                }
+            }
+        }
+
+        status = (tmp == NULL) ? -1 : 0;
+        free(tmp);
+        free(block);
+    }
+
+    if (atomic_load(&vPass.failed) != 0) {
+        status = -1;
+    }
+
+    resize_freeTable(&hTable);
+    resize_freeTable(&vTable);
+    return status;
+}
+
+
+/*
+ * Moyenne d'un bloc factor x factor ; factor est une constante une fois
+ * la fonction inlinée, ce qui permet de dérouler les boucles
+ */
+static inline void reduce_row(const uint8_t *const *rows, uint8_t *dst, int dstWidth, int ch, int factor) {
+    int shift = (factor == 2) ? 2 : 4;
+    int round = 1 << (shift - 1);
+
+    for (int x = 0; x < dstWidth; x++) {
+        for (int c = 0; c < ch; c++) {
+            int sum = round;
+            for (int j = 0; j < factor; j++) {
+                const uint8_t *p = rows[j] + (size_t)x * factor * ch + c;
+                for (int i = 0; i < factor; i++) {
+                    sum += p[i * ch];
+                }
+            }
+            dst[x * ch + c] = (uint8_t)(sum >> shift);
+        }
+    }
+}
+
+
+static void reduce_band(void *arg, int begin, int end) {
+    const t_reduce_pass *pass = (const t_reduce_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *const *rows = pass->src + (size_t)y * pass->factor;
+        if (pass->factor == 2) {
+            reduce_row(rows, pass->dst[y], pass->dstWidth, pass->channels, 2);
+        } else {
+            reduce_row(rows, pass->dst[y], pass->dstWidth, pass->channels, 4);
+        }
+    }
+}
+
+
+int bmp_boxReduceRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                      uint8_t *const *dstRows, int channels, int factor) {
+    if (srcRows == NULL || dstRows == NULL || channels <= 0 || (factor != 2 && factor != 4) ||
+        srcWidth < factor || srcHeight < factor) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    t_reduce_pass pass = {srcRows, dstRows, srcWidth / factor, channels, factor};
+    bmp_parallelFor(srcHeight / factor, RESIZE_GRAIN, reduce_band, &pass);
+    return 0;
+}
+
+
+/* Copie la palette et la résolution de la source dans l'image produite */
+static void resize_copyInfo8(t_bmp8 *dst, const t_bmp8 *src) {
+    memcpy(dst->colorTable, src->colorTable, BMP_COLOR_TABLE_SIZE);
+    memcpy(&dst->header[38], &src->header[38], 8);
+}
+
+
+t_bmp8 *bmp8_resize(t_bmp8 *img, int width, int height, t_resize_mode mode) {
+    if (img == NULL || img->data == NULL || width <= 0 || height <= 0) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp8 *result = bmp8_allocate(width, height);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    unsigned char **src = bmp8_getTopDownRows(img);
+    unsigned char **dst = bmp8_getTopDownRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_resizeRows((const uint8_t *const *)src, img->width, img->height,
+                                dst, width, height, 1, mode);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp8_free(result);
+        return NULL;
+    }
+
+    resize_copyInfo8(result, img);
+    return result;
+}
+
+
+t_bmp24 *bmp24_resize(t_bmp24 *img, int width, int height, t_resize_mode mode) {
+    if (img == NULL || img->data == NULL || width <= 0 || height <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp24 *result = bmp24_allocate(width, height, img->colorDepth);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp24_getRows(img);
+    uint8_t **dst = bmp24_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_resizeRows((const uint8_t *const *)src, img->width, img->height,
+                                dst, width, height, 3, mode);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp24_free(result);
+        return NULL;
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
+
+
+t_bmp8 *bmp8_boxReduce(t_bmp8 *img, int factor) {
+    if (img == NULL || img->data == NULL || (factor != 2 && factor != 4) ||
+        img->width < (uint32_t)factor || img->height < (uint32_t)factor) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp8 *result = bmp8_allocate(img->width / factor, img->height / factor);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    unsigned char **src = bmp8_getTopDownRows(img);
+    unsigned char **dst = bmp8_getTopDownRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_boxReduceRows((const uint8_t *const *)src, img->width, img->height, dst, 1, factor);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp8_free(result);
+        return NULL;
+    }
+
+    resize_copyInfo8(result, img);
+    return result;
+}
+
+
+t_bmp24 *bmp24_boxReduce(t_bmp24 *img, int factor) {
+    if (img == NULL || img->data == NULL || (factor != 2 && factor != 4) ||
+        img->width < factor || img->height < factor) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp24 *result = bmp24_allocate(img->width / factor, img->height / factor, img->colorDepth);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp24_getRows(img);
+    uint8_t **dst = bmp24_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_boxReduceRows((const uint8_t *const *)src, img->width, img->height, dst, 3, factor);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp24_free(result);
+        return NULL;
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
+
+
+t_bmp32 *bmp32_resize(t_bmp32 *img, int width, int height, t_resize_mode mode) {
+    if (img == NULL || img->data == NULL || width <= 0 || height <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp32 *result = bmp32_allocate(width, height);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp32_getRows(img);
+    uint8_t **dst = bmp32_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_resizeRows((const uint8_t *const *)src, img->width, img->height,
+                                dst, width, height, 4, mode);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp32_free(result);
+        return NULL;
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
+
+
+t_bmp32 *bmp32_boxReduce(t_bmp32 *img, int factor) {
+    if (img == NULL || img->data == NULL || (factor != 2 && factor != 4) ||
+        img->width < factor || img->height < factor) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    t_bmp32 *result = bmp32_allocate(img->width / factor, img->height / factor);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    uint8_t **src = bmp32_getRows(img);
+    uint8_t **dst = bmp32_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = bmp_boxReduceRows((const uint8_t *const *)src, img->width, img->height, dst, 4, factor);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp32_free(result);
+        return NULL;
+    }
+
+    result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+    return result;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bmpresize.h
+ *
+ * @brief
+ * Redimensionnement des images BMP 8, 24 et 32 bits (vignettes, aperçus).
+ * Quatre modes sont proposés : plus proche voisin, bilinéaire, moyenne
+ * par zone (boîte) et Lanczos. Une réduction rapide par 2 ou par 4 sert
+ * à construire des pyramides d'images.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPRESIZE_H
+#define BMPRESIZE_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmp32.h"
+
+/*
+ * Méthodes d'interpolation disponibles
+ */
+typedef enum {
+    BMP_RESIZE_NEAREST,   // Plus proche voisin (le plus rapide)
+    BMP_RESIZE_BILINEAR,  // Interpolation linéaire (triangle)
+    BMP_RESIZE_AREA,      // Moyenne des pixels couverts (idéal pour réduire)
+    BMP_RESIZE_LANCZOS    // Lanczos-3 (le plus net)
+} t_resize_mode;
+
+/* bmp_resizeRows
+ * Rôle : Redimensionne un tableau de lignes d'octets entrelacés
+ * Paramètres :
+ *   srcRows   - Lignes source
+ *   srcWidth  - Largeur source en pixels
+ *   srcHeight - Hauteur source
+ *   dstRows   - Lignes destination (déjà allouées)
+ *   dstWidth  - Largeur voulue
+ *   dstHeight - Hauteur voulue
+ *   channels  - Nombre d'octets par pixel (1, 3 ou 4)
+ *   mode      - Méthode d'interpolation
+ * Retour : 0 si réussi, -1 si erreur
+ * Méthode : Deux passes séparables (horizontale puis verticale) avec
+ *           des tables de poids précalculées en virgule fixe
+ */
+int bmp_resizeRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                   uint8_t *const *dstRows, int dstWidth, int dstHeight,
+                   int channels, t_resize_mode mode);
+
+/* bmp_boxReduceRows
+ * Rôle : Réduit des lignes d'un facteur 2 ou 4 (moyenne de blocs factor x factor)
+ * Paramètres :
+ *   srcRows, srcWidth, srcHeight - Image source
+ *   dstRows  - Lignes destination de srcWidth/factor pixels (srcHeight/factor lignes)
+ *   channels - Nombre d'octets par pixel
+ *   factor   - 2 ou 4
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_boxReduceRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                      uint8_t *const *dstRows, int channels, int factor);
+
+/* bmp8_resize
+ * Rôle : Crée une copie redimensionnée d'une image 8 bits
+ * Paramètres :
+ *   img    - Image source (non modifiée)
+ *   width  - Nouvelle largeur
+ *   height - Nouvelle hauteur
+ *   mode   - Méthode d'interpolation
+ * Retour : Nouvelle image ou NULL si erreur
+ */
+t_bmp8 *bmp8_resize(t_bmp8 *img, int width, int height, t_resize_mode mode);
+
+/* bmp24_resize
+ * Rôle : Crée une copie redimensionnée d'une image 24 bits
+ * Paramètres : Identiques à bmp8_resize
+ */
+t_bmp24 *bmp24_resize(t_bmp24 *img, int width, int height, t_resize_mode mode);
+
+/* bmp32_resize
+ * Rôle : Crée une copie redimensionnée d'une image 32 bits (alpha interpolé
+ *        comme les autres composantes)
+ * Paramètres : Identiques à bmp8_resize
+ */
+t_bmp32 *bmp32_resize(t_bmp32 *img, int width, int height, t_resize_mode mode);
+
+/* bmp8_boxReduce / bmp24_boxReduce
+ * Rôle : Réduction rapide par 2 ou par 4 (niveau suivant d'une pyramide)
+ * Paramètres :
+ *   img    - Image source (non modifiée)
+ *   factor - 2 ou 4
+ * Retour : Nouvelle image ou NULL si erreur
+ */
+t_bmp8 *bmp8_boxReduce(t_bmp8 *img, int factor);
+t_bmp24 *bmp24_boxReduce(t_bmp24 *img, int factor);
+t_bmp32 *bmp32_boxReduce(t_bmp32 *img, int factor);
+
+#endif
@@ -0,0 +1,290 @@
+/**
+ * @file bmprle.c
+ *
+ * @brief
+ * Codage RLE8. Le décodeur écrit directement dans le tampon des pixels
+ * (memset pour une suite, memcpy pour un passage en mode absolu). Le
+ * codeur cherche la longueur des suites 16 octets à la fois (SSE2 :
+ * comparaison avec la valeur répétée puis _mm_movemask_epi8 ; sinon 8
+ * octets par mot de 64 bits). Les lignes sont compressées en parallèle
+ * par paquets, puis écrites dans l'ordre.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmprle.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define RLE_GRAIN 64
+#define RLE_CHUNK_ROWS 1024 // Lignes compressées avant chaque écriture
+#define RLE_MIN_RUN 3       // En dessous, une suite coûte autant qu'en mode absolu
+#define RLE_MAX_COUNT 255
+
+typedef struct {
+    t_bmp8 *img;
+    uint32_t first;         // Première ligne du paquet (ordre du fichier, de bas en haut)
+    uint8_t *out;           // Une zone de BMP_RLE8_ROW_MAX(width) octets par ligne
+    size_t rowCap;
+    size_t *sizes;          // Taille compressée de chaque ligne
+} t_rle_pass;
+
+
+static void rle_setField(unsigned char *header, int offset, uint32_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        header[offset + i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+
+/* Longueur de la suite de pixels égaux à p[0] (au plus n) */
+static uint32_t rle_runLength(const uint8_t *p, uint32_t n) {
+    uint8_t value = p[0];
+    uint32_t i = 1;
+
+    // Dans les zones texturées la suite s'arrête presque toujours ici
+    while (i < n && i < RLE_MIN_RUN && p[i] == value) {
+        i++;
+    }
+    if (i < RLE_MIN_RUN) {
+        return i;
+    }
+
+#ifdef __SSE2__
+    __m128i ref = _mm_set1_epi8((char)value);
+    for (; i + 16 <= n; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), ref);
+        if (_mm_movemask_epi8(eq) != 0xFFFF) {
+            break;
+        }
+    }
+#else
+    uint64_t pattern = value * 0x0101010101010101ULL;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        if (word != pattern) {
+            break;
+        }
+    }
+#endif
+
+    // Fin de la suite à l'intérieur du dernier bloc comparé
+    while (i < n && p[i] == value) {
+        i++;
+    }
+    return i;
+}
+
+
+/* Pixels sans suite : mode absolu (au moins 3 pixels), sinon suites de 1 */
+static uint8_t *rle_putLiteral(uint8_t *out, const uint8_t *p, uint32_t n) {
+    while (n > 0) {
+        uint32_t chunk = (n > RLE_MAX_COUNT) ? RLE_MAX_COUNT : n;
+        if (chunk < 3) {
+            for (uint32_t i = 0; i < chunk; i++) {
+                *out++ = 1;
+                *out++ = p[i];
+            }
+        } else {
+            *out++ = 0;
+            *out++ = (uint8_t)chunk;
+            memcpy(out, p, chunk);
+            out += chunk;
+            // Le mode absolu est aligné sur 2 octets
+            if (chunk & 1) {
+                *out++ = 0;
+            }
+        }
+        p += chunk;
+        n -= chunk;
+    }
+    return out;
+}
+
+
+size_t bmp_encodeRLE8Row(const uint8_t *row, uint32_t width, uint8_t *out) {
+    uint8_t *o = out;
+    uint32_t x = 0, literal = 0;
+
+    while (x < width) {
+        uint32_t n = width - x;
+        uint32_t run = rle_runLength(row + x, (n > RLE_MAX_COUNT) ? RLE_MAX_COUNT : n);
+        if (run >= RLE_MIN_RUN) {
+            o = rle_putLiteral(o, row + literal, x - literal);
+            *o++ = (uint8_t)run;
+            *o++ = row[x];
+            x += run;
+            literal = x;
+        } else {
+            x += run;
+        }
+    }
+    o = rle_putLiteral(o, row + literal, x - literal);
+
+    // Fin de ligne
+    *o++ = 0;
+    *o++ = 0;
+    return (size_t)(o - out);
+}
+
+
+int bmp_decodeRLE8(const uint8_t *src, size_t size, uint8_t *dst,
+                   uint32_t width, uint32_t height, uint32_t stride) {
+    size_t pos = 0;
+    uint32_t x = 0, y = 0;
+
+    while (pos + 2 <= size) {
+        uint32_t count = src[pos];
+        uint32_t value = src[pos + 1];
+        pos += 2;
+
+        if (count > 0) {
+            // Suite de count pixels identiques
+            if (y < height && x < width) {
+                memset(dst + (size_t)y * stride + x, (int)value,
+                       (count < width - x) ? count : width - x);
+            }
+            x += count;
+            continue;
+        }
+
+        if (value == 0) {
+            // Fin de ligne
+            x = 0;
+            y++;
+        } else if (value == 1) {
+            // Fin de l'image
+            return 0;
+        } else if (value == 2) {
+            // Déplacement : les pixels sautés restent à 0
+            if (pos + 2 > size) {
+                return -1;
+            }
+            x += src[pos];
+            y += src[pos + 1];
+            pos += 2;
+        } else {
+            // Mode absolu : value pixels recopiés tels quels
+            if (pos + value > size) {
+                return -1;
+            }
+            if (y < height && x < width) {
+                memcpy(dst + (size_t)y * stride + x, src + pos,
+                       (value < width - x) ? value : width - x);
+            }
+            x += value;
+            pos += value + (value & 1);
+        }
+    }
+
+    // Flux sans marqueur de fin : on garde ce qui a été décodé
+    return 0;
+}
+
+
+static void rle_encodeBand(void *arg, int begin, int end) {
+    const t_rle_pass *pass = (const t_rle_pass *)arg;
+    t_bmp8 *img = pass->img;
+
+    // Le RLE8 est toujours de bas en haut, même pour une image topDown
+    for (int row = begin; row < end; row++) {
+        pass->sizes[row] = bmp_encodeRLE8Row(bmp8_row(img, img->height - 1 - (pass->first + row)), img->width,
+                                             pass->out + (size_t)row * pass->rowCap);
+    }
+}
+
+
+int bmp8_saveImageRLE(const char *filename, t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    uint32_t chunkRows = (img->height < RLE_CHUNK_ROWS) ? img->height : RLE_CHUNK_ROWS;
+    size_t rowCap = BMP_RLE8_ROW_MAX(img->width);
+    uint8_t *out = (uint8_t *)malloc(rowCap * chunkRows);
+    size_t *sizes = (size_t *)malloc(chunkRows * sizeof(size_t));
+    if (out == NULL || sizes == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        free(out);
+        free(sizes);
+        return -1;
+    }
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier pour l'écriture");
+        free(out);
+        free(sizes);
+        return -1;
+    }
+
+    // L'en-tête est réécrit à la fin, quand la taille compressée est connue
+    unsigned char header[BMP_HEADER_SIZE];
+    memcpy(header, img->header, BMP_HEADER_SIZE);
+    int status = 0;
+    if (fwrite(header, 1, BMP_HEADER_SIZE, file) != BMP_HEADER_SIZE ||
+        fwrite(img->colorTable, 1, BMP_COLOR_TABLE_SIZE, file) != BMP_COLOR_TABLE_SIZE) {
+        status = -1;
+    }
+
+    uint32_t total = 0;
+    for (uint32_t first = 0; status == 0 && first < img->height; first += chunkRows) {
+        uint32_t rows = (img->height - first < chunkRows) ? img->height - first : chunkRows;
+
+        t_rle_pass pass;
+        pass.img = img;
+        pass.first = first;
+        pass.out = out;
+        pass.rowCap = rowCap;
+        pass.sizes = sizes;
+        bmp_parallelFor((int)rows, RLE_GRAIN, rle_encodeBand, &pass);
+
+        // La dernière fin de ligne devient la fin de l'image (0, 1)
+        if (first + rows == img->height) {
+            out[(size_t)(rows - 1) * rowCap + sizes[rows - 1] - 1] = 1;
+        }
+
+        for (uint32_t r = 0; r < rows; r++) {
+            if (fwrite(out + (size_t)r * rowCap, 1, sizes[r], file) != sizes[r]) {
+                status = -1;
+                break;
+            }
+            total += (uint32_t)sizes[r];
+        }
+    }
+
+    if (status == 0) {
+        uint32_t offset = BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE;
+        rle_setField(header, 2, offset + total, 4);
+        rle_setField(header, 10, offset, 4);
+        rle_setField(header, 18, img->width, 4);
+        rle_setField(header, 22, img->height, 4);
+        rle_setField(header, 28, 8, 2);
+        rle_setField(header, 30, BMP_BI_RLE8, 4);
+        rle_setField(header, 34, total, 4);
+        rle_setField(header, 46, 256, 4);
+        if (fseek(file, 0, SEEK_SET) != 0 || fwrite(header, 1, BMP_HEADER_SIZE, file) != BMP_HEADER_SIZE) {
+            status = -1;
+        }
+    }
+    if (status != 0) {
+        perror("Erreur: Impossible d'écrire l'image compressée");
+    }
+
+    if (fclose(file) != 0 && status == 0) {
+        perror("Erreur: Impossible d'écrire l'image compressée");
+        status = -1;
+    }
+    free(out);
+    free(sizes);
+    return status;
+}
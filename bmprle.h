@@ -0,0 +1,60 @@
+/**
+ * @file bmprle.h
+ *
+ * @brief
+ * Compression RLE8 (BI_RLE8) des images 8 bits : chaque suite de pixels
+ * identiques devient un couple (longueur, valeur). Les images seuillées et
+ * les documents scannés, faits de grands aplats, deviennent 10 à 50 fois
+ * plus petits, ce qui réduit d'autant le stockage et les lectures disque.
+ * bmp8_loadImage décode ces fichiers de façon transparente.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPRLE_H
+#define BMPRLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bmp8.h"
+
+/* bmp_decodeRLE8
+ * Rôle : Décode un flux RLE8 directement dans un tampon de pixels
+ * Paramètres :
+ *   src    - Données compressées
+ *   size   - Taille de src en octets
+ *   dst    - Pixels (lignes de bas en haut comme dans le fichier), mis à 0
+ *            au préalable : les pixels sautés par un déplacement restent à 0
+ *   width  - Largeur en pixels
+ *   height - Nombre de lignes
+ *   stride - Octets par ligne de dst (padding compris)
+ * Retour : 0 si réussi, -1 si le flux est tronqué ou incohérent
+ * Note : Les suites qui dépassent la fin d'une ligne sont coupées
+ */
+int bmp_decodeRLE8(const uint8_t *src, size_t size, uint8_t *dst,
+                   uint32_t width, uint32_t height, uint32_t stride);
+
+/* bmp_encodeRLE8Row
+ * Rôle : Compresse une ligne de pixels, fin de ligne (0, 0) comprise
+ * Paramètres :
+ *   row   - width pixels
+ *   width - Largeur en pixels
+ *   out   - Reçoit au plus BMP_RLE8_ROW_MAX(width) octets
+ * Retour : Nombre d'octets écrits
+ */
+size_t bmp_encodeRLE8Row(const uint8_t *row, uint32_t width, uint8_t *out);
+
+/* Taille maximale d'une ligne compressée (2 octets par pixel au pire) */
+#define BMP_RLE8_ROW_MAX(width) (2 * (size_t)(width) + 2)
+
+/* bmp8_saveImageRLE
+ * Rôle : Enregistre une image 8 bits compressée en RLE8
+ * Paramètres :
+ *   filename - Chemin du fichier
+ *   img      - Image à sauvegarder (non modifiée)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_saveImageRLE(const char *filename, t_bmp8 *img);
+
+#endif
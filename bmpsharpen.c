@@ -0,0 +1,263 @@
+/**
+ * @file bmpsharpen.c
+ *
+ * @brief
+ * Masque flou fusionné, par tuiles de lignes traitées en parallèle.
+ * Chaque tuile garde un anneau de 2r + 1 lignes floutées horizontalement ;
+ * dès qu'une ligne de sortie a tous ses voisins, on calcule son flou
+ * vertical et on la combine avec l'originale, sur place. Seules les
+ * lignes de bord (r au-dessus et r au-dessous de chaque tuile) sont
+ * copiées avant la passe, car la tuile voisine peut les modifier.
+ * Calcul en virgule fixe : noyau sur 14 bits, flou horizontal stocké sur
+ * 16 bits (8 bits de fraction), intensité sur 8 bits.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpsharpen.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#define UNSHARP_KERNEL_BITS 14
+#define UNSHARP_MIN_TILE 64
+
+typedef struct {
+    uint8_t **rows;         // Lignes de l'image
+    int rowBytes;           // width * channels
+    int channels;
+    int height;
+    int radius;
+    int tileHeight;
+    const int32_t *kernel;  // 2r + 1 poids, somme = 1 << UNSHARP_KERNEL_BITS
+    int amount;             // Intensité sur 8 bits de fraction
+    int threshold;          // Seuil sur 8 bits de fraction
+    uint8_t *halo;          // Pour chaque tuile : r lignes au-dessus puis r au-dessous
+    atomic_int failed;      // Une bande n'a pas pu allouer ses tampons
+} t_unsharp_pass;
+
+
+/* Noyau gaussien quantifié dont la somme vaut exactement 1 << UNSHARP_KERNEL_BITS */
+static void unsharp_kernel(int radius, int32_t *kernel) {
+    double sigma = radius / 2.0, weights[2 * BMP_UNSHARP_MAX_RADIUS + 1], total = 0.0;
+    int32_t sum = 0;
+
+    for (int j = -radius; j <= radius; j++) {
+        weights[j + radius] = exp(-(double)j * j / (2.0 * sigma * sigma));
+        total += weights[j + radius];
+    }
+    for (int j = 0; j <= 2 * radius; j++) {
+        kernel[j] = (int32_t)(weights[j] / total * (1 << UNSHARP_KERNEL_BITS) + 0.5);
+        sum += kernel[j];
+    }
+    kernel[radius] += (1 << UNSHARP_KERNEL_BITS) - sum;
+}
+
+
+/* Ligne source y (bords répétés) vue depuis la tuile [y0, y1) */
+static const uint8_t *unsharp_source(const t_unsharp_pass *pass, int tile, int y0, int y1, int y) {
+    y = (y < 0) ? 0 : ((y >= pass->height) ? pass->height - 1 : y);
+    if (y >= y0 && y < y1) {
+        return pass->rows[y];
+    }
+
+    // Ligne d'une tuile voisine : copie faite avant la passe
+    const uint8_t *halo = pass->halo + (size_t)tile * 2 * pass->radius * pass->rowBytes;
+    int index = (y < y0) ? y - (y0 - pass->radius) : pass->radius + (y - y1);
+    return halo + (size_t)index * pass->rowBytes;
+}
+
+
+/* Flou horizontal d'une ligne, résultat sur 8 bits de fraction */
+static void unsharp_blurRow(const t_unsharp_pass *pass, const uint8_t *src, uint16_t *dst, int32_t *acc) {
+    int n = pass->rowBytes, c = pass->channels, r = pass->radius;
+    int width = n / c;
+
+    memset(acc, 0, (size_t)n * sizeof(int32_t));
+    for (int j = -r; j <= r; j++) {
+        int32_t k = pass->kernel[j + r];
+        int x0 = (j < 0) ? -j : 0;              // Colonnes dont le voisin est dans l'image
+        int x1 = (j > 0) ? width - j : width;
+        if (x1 < x0) {
+            x1 = x0;
+        }
+
+        // Bords : colonne répétée
+        for (int x = 0; x < x0 && x < width; x++) {
+            for (int ch = 0; ch < c; ch++) {
+                acc[x * c + ch] += k * src[ch];
+            }
+        }
+        const uint8_t *shifted = src + j * c;
+        for (int i = x0 * c; i < x1 * c; i++) {
+            acc[i] += k * shifted[i];
+        }
+        for (int x = (x1 > x0) ? x1 : x0; x < width; x++) {
+            for (int ch = 0; ch < c; ch++) {
+                acc[x * c + ch] += k * src[(width - 1) * c + ch];
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        dst[i] = (uint16_t)((acc[i] + (1 << (UNSHARP_KERNEL_BITS - 9))) >> (UNSHARP_KERNEL_BITS - 8));
+    }
+}
+
+
+static void unsharp_tileBand(void *arg, int begin, int end) {
+    t_unsharp_pass *pass = (t_unsharp_pass *)arg;
+    int n = pass->rowBytes, r = pass->radius, ringSize = 2 * r + 1;
+    uint16_t *ring = (uint16_t *)malloc((size_t)ringSize * n * sizeof(uint16_t));
+    int32_t *acc = (int32_t *)malloc((size_t)n * sizeof(int32_t));
+
+    if (ring == NULL || acc == NULL) {
+        printf("Erreur: Impossible d'allouer les tampons du masque flou\n");
+        free(ring);
+        free(acc);
+        atomic_store(&pass->failed, 1);
+        return;
+    }
+
+    for (int tile = begin; tile < end; tile++) {
+        int y0 = tile * pass->tileHeight;
+        int y1 = (y0 + pass->tileHeight < pass->height) ? y0 + pass->tileHeight : pass->height;
+
+        // L'anneau contient les lignes y - r à y + r, indexées par (ligne - y0 + r) % ringSize
+        for (int y = y0 - r; y < y0 + r; y++) {
+            unsharp_blurRow(pass, unsharp_source(pass, tile, y0, y1, y),
+                            ring + (size_t)((y - y0 + r) % ringSize) * n, acc);
+        }
+
+        for (int y = y0; y < y1; y++) {
+            unsharp_blurRow(pass, unsharp_source(pass, tile, y0, y1, y + r),
+                            ring + (size_t)((y + r - y0 + r) % ringSize) * n, acc);
+
+            memset(acc, 0, (size_t)n * sizeof(int32_t));
+            for (int j = -r; j <= r; j++) {
+                int32_t k = pass->kernel[j + r];
+                const uint16_t *blurred = ring + (size_t)((y + j - y0 + r) % ringSize) * n;
+                for (int i = 0; i < n; i++) {
+                    acc[i] += k * blurred[i];
+                }
+            }
+
+            // Différence avec le flou sur 8 bits de fraction, puis combinaison
+            uint8_t *row = pass->rows[y];
+            for (int i = 0; i < n; i++) {
+                int blur = (acc[i] + (1 << (UNSHARP_KERNEL_BITS - 1))) >> UNSHARP_KERNEL_BITS;
+                int diff = row[i] * 256 - blur;
+                if (abs(diff) >= pass->threshold) {
+                    int v = row[i] + ((diff * pass->amount + (1 << 15)) >> 16);
+                    row[i] = (uint8_t)((v < 0) ? 0 : ((v > 255) ? 255 : v));
+                }
+            }
+        }
+    }
+
+    free(ring);
+    free(acc);
+}
+
+
+static int unsharp_run(uint8_t **rows, int channels, int width, int height, int radius, double amount, int threshold) {
+    if (radius < 1 || radius > BMP_UNSHARP_MAX_RADIUS || amount < 0.0 || amount > 10.0 ||
+        threshold < 0 || threshold > 255) {
+        printf("Erreur: Paramètres du masque flou invalides\n");
+        return -1;
+    }
+
+    int32_t kernel[2 * BMP_UNSHARP_MAX_RADIUS + 1];
+    unsharp_kernel(radius, kernel);
+
+    t_unsharp_pass pass;
+    pass.rows = rows;
+    pass.rowBytes = width * channels;
+    pass.channels = channels;
+    pass.height = height;
+    pass.radius = radius;
+    pass.tileHeight = (4 * radius > UNSHARP_MIN_TILE) ? 4 * radius : UNSHARP_MIN_TILE;
+    pass.kernel = kernel;
+    pass.amount = (int)(amount * 256.0 + 0.5);
+    pass.threshold = threshold * 256;
+    atomic_init(&pass.failed, 0);
+
+    int tiles = (height + pass.tileHeight - 1) / pass.tileHeight;
+    pass.halo = (uint8_t *)malloc((size_t)tiles * 2 * radius * pass.rowBytes);
+    if (pass.halo == NULL) {
+        printf("Erreur: Impossible d'allouer les bords des tuiles\n");
+        return -1;
+    }
+
+    // Copie des lignes voisines de chaque tuile avant toute modification
+    for (int tile = 0; tile < tiles; tile++) {
+        int y0 = tile * pass.tileHeight;
+        int y1 = (y0 + pass.tileHeight < height) ? y0 + pass.tileHeight : height;
+        uint8_t *halo = pass.halo + (size_t)tile * 2 * radius * pass.rowBytes;
+
+        for (int i = 0; i < radius; i++) {
+            int above = y0 - radius + i;
+            int below = y1 + i;
+            above = (above < 0) ? 0 : above;
+            below = (below >= height) ? height - 1 : below;
+            memcpy(halo + (size_t)i * pass.rowBytes, rows[above], pass.rowBytes);
+            memcpy(halo + (size_t)(radius + i) * pass.rowBytes, rows[below], pass.rowBytes);
+        }
+    }
+
+    bmp_parallelFor(tiles, 1, unsharp_tileBand, &pass);
+
+    free(pass.halo);
+    return (atomic_load(&pass.failed) == 0) ? 0 : -1;
+}
+
+
+int bmp8_unsharpMask(t_bmp8 *img, int radius, double amount, int threshold) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    // Flou symétrique : l'ordre des lignes en mémoire convient
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = unsharp_run(rows, 1, img->width, img->height, radius, amount, threshold);
+    free(rows);
+    return status;
+}
+
+
+int bmp24_unsharpMask(t_bmp24 *img, int radius, double amount, int threshold) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = unsharp_run(rows, 3, img->width, img->height, radius, amount, threshold);
+    free(rows);
+    return status;
+}
+
+
+int bmp_viewUnsharpMask(const t_bmp_view *view, int radius, double amount, int threshold) {
+    uint8_t **rows = bmp_viewRows(view);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = unsharp_run(rows, view->channels, view->width, view->height, radius, amount, threshold);
+    free(rows);
+    return status;
+}
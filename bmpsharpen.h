@@ -0,0 +1,55 @@
+/**
+ * @file bmpsharpen.h
+ *
+ * @brief
+ * Masque flou (unsharp mask) réglable : on ajoute à l'image la différence
+ * entre elle et sa version floutée. Contrairement à bmp24_sharpen (noyau
+ * 3x3 fixe), le rayon, l'intensité et le seuil sont paramétrables, et le
+ * flou comme la combinaison se font en une seule passe.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPSHARPEN_H
+#define BMPSHARPEN_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/* Rayon maximal du flou */
+#define BMP_UNSHARP_MAX_RADIUS 64
+
+/* bmp8_unsharpMask
+ * Rôle : Accentue la netteté par masque flou
+ * Paramètres :
+ *   img       - Image à modifier
+ *   radius    - Rayon du flou gaussien (1 à BMP_UNSHARP_MAX_RADIUS,
+ *               écart-type radius / 2)
+ *   amount    - Intensité : 0.5 = +50 % de la différence (0 à 10)
+ *   threshold - Écart minimal avec le flou pour modifier un pixel (0 à 255) ;
+ *               évite d'accentuer le bruit des zones unies
+ * Retour : 0 si réussi, -1 si erreur (si un thread manque de mémoire,
+ *          les tuiles des autres threads restent traitées)
+ */
+int bmp8_unsharpMask(t_bmp8 *img, int radius, double amount, int threshold);
+
+/* bmp24_unsharpMask
+ * Rôle : Accentue la netteté de chaque composante par masque flou
+ * Paramètres : Identiques à bmp8_unsharpMask
+ */
+int bmp24_unsharpMask(t_bmp24 *img, int radius, double amount, int threshold);
+
+/* bmp_viewUnsharpMask
+ * Rôle : Accentue la netteté d'une zone d'image, sans la copier
+ * Paramètres :
+ *   view - Zone à modifier (toutes ses composantes, alpha compris)
+ *   Autres paramètres identiques à bmp8_unsharpMask
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : Les pixels hors de la zone ne sont ni lus ni modifiés : ses bords
+ *        sont répétés comme ceux d'une image entière
+ */
+int bmp_viewUnsharpMask(const t_bmp_view *view, int radius, double amount, int threshold);
+
+#endif
@@ -0,0 +1,611 @@
+/**
+ * @file bmpsmooth.c
+ *
+ * @brief
+ * Les deux filtres travaillent sur des plans flottants d'une composante.
+ * - Filtre guidé : a = var / (var + eps), b = moyenne - a * moyenne sur
+ *   chaque fenêtre, puis sortie = moyenne(a) * I + moyenne(b). Les moyennes
+ *   sont des filtres boîte par sommes glissantes (horizontale par ligne,
+ *   verticale par blocs de colonnes), d'où un coût indépendant du rayon.
+ * - Bilatéral rapide : pour quelques niveaux i_k espacés de sigmaRange, on
+ *   lisse W = g(I - i_k) et J = g(I - i_k) * I par une gaussienne séparable ;
+ *   chaque pixel interpole J / W entre les deux niveaux qui l'encadrent.
+ * Toutes les passes sont découpées en bandes pour bmp_parallelFor, et les
+ * boucles internes parcourent des lignes contiguës (vectorisables).
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpsmooth.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SMOOTH_GRAIN 16
+#define SMOOTH_COLUMN_BLOCK 256
+#define SMOOTH_MAX_LEVELS 256
+
+typedef struct {
+    uint8_t **rows;         // Lignes de l'image
+    int channels;           // 1 (gris), 3 (t_pixel) ou 4 (t_pixel32)
+    int channel;            // Composante traitée
+    int width;
+    int height;
+    int radius;
+    float *plane0;          // Plans de travail (width * height)
+    float *plane1;
+    float *tmp;
+    float *out;
+    const float *kernel;    // Gaussienne spatiale (2 * radius + 1 coefficients)
+    const float *range;     // Poids d'intensité indexés par valeur (bilatéral)
+    float eps;              // Régularisation du filtre guidé
+    float level;            // Niveau courant du bilatéral
+    float levelMin;         // Premier niveau
+    float levelStep;        // Écart entre deux niveaux
+    int levelIndex;
+} t_smooth_pass;
+
+
+static inline uint8_t smooth_round(float v) {
+    return (uint8_t)((v <= 0.0f) ? 0 : ((v >= 255.0f) ? 255 : (int)(v + 0.5f)));
+}
+
+
+/* FILTRE BOÎTE */
+
+/* Moyenne horizontale : src -> tmp */
+static void smooth_boxRowBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+    int w = pass->width, r = pass->radius;
+
+    for (int y = begin; y < end; y++) {
+        const float *src = pass->plane0 + (size_t)y * w;
+        float *dst = pass->tmp + (size_t)y * w;
+        double sum = 0.0;
+
+        for (int x = 0; x < r && x < w; x++) {
+            sum += src[x];
+        }
+        for (int x = 0; x < w; x++) {
+            if (x + r < w) {
+                sum += src[x + r];
+            }
+            if (x - r - 1 >= 0) {
+                sum -= src[x - r - 1];
+            }
+            int x0 = (x - r < 0) ? 0 : x - r;
+            int x1 = (x + r + 1 > w) ? w : x + r + 1;
+            dst[x] = (float)(sum / (x1 - x0));
+        }
+    }
+}
+
+
+/* Moyenne verticale sur des blocs de colonnes : tmp -> plane0 */
+static void smooth_boxColumnBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+    int w = pass->width, h = pass->height, r = pass->radius;
+    double sum[SMOOTH_COLUMN_BLOCK];
+
+    for (int block = begin; block < end; block++) {
+        int x0 = block * SMOOTH_COLUMN_BLOCK;
+        int n = (x0 + SMOOTH_COLUMN_BLOCK < w) ? SMOOTH_COLUMN_BLOCK : w - x0;
+
+        memset(sum, 0, sizeof(sum));
+        for (int y = 0; y < r && y < h; y++) {
+            const float *row = pass->tmp + (size_t)y * w + x0;
+            for (int i = 0; i < n; i++) {
+                sum[i] += row[i];
+            }
+        }
+
+        for (int y = 0; y < h; y++) {
+            if (y + r < h) {
+                const float *add = pass->tmp + (size_t)(y + r) * w + x0;
+                for (int i = 0; i < n; i++) {
+                    sum[i] += add[i];
+                }
+            }
+            if (y - r - 1 >= 0) {
+                const float *sub = pass->tmp + (size_t)(y - r - 1) * w + x0;
+                for (int i = 0; i < n; i++) {
+                    sum[i] -= sub[i];
+                }
+            }
+
+            int y0 = (y - r < 0) ? 0 : y - r;
+            int y1 = (y + r + 1 > h) ? h : y + r + 1;
+            double inv = 1.0 / (y1 - y0);
+            float *dst = pass->plane0 + (size_t)y * w + x0;
+            for (int i = 0; i < n; i++) {
+                dst[i] = (float)(sum[i] * inv);
+            }
+        }
+    }
+}
+
+
+/* Remplace plane par sa moyenne sur une fenêtre (2r + 1) x (2r + 1) rognée à l'image */
+static void smooth_box(t_smooth_pass *pass, float *plane) {
+    t_smooth_pass box = *pass;
+    box.plane0 = plane;
+    bmp_parallelFor(pass->height, SMOOTH_GRAIN, smooth_boxRowBand, &box);
+    bmp_parallelFor((pass->width + SMOOTH_COLUMN_BLOCK - 1) / SMOOTH_COLUMN_BLOCK, 1, smooth_boxColumnBand, &box);
+}
+
+
+/* GAUSSIENNE SÉPARABLE (zéros hors de l'image) */
+
+static void smooth_gaussRowBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+    int w = pass->width, r = pass->radius;
+
+    for (int y = begin; y < end; y++) {
+        const float *src = pass->plane0 + (size_t)y * w;
+        float *dst = pass->tmp + (size_t)y * w;
+
+        memset(dst, 0, (size_t)w * sizeof(float));
+        for (int j = -r; j <= r; j++) {
+            float k = pass->kernel[j + r];
+            int x0 = (j < 0) ? -j : 0;
+            int x1 = (j > 0) ? w - j : w;
+            for (int x = x0; x < x1; x++) {
+                dst[x] += k * src[x + j];
+            }
+        }
+    }
+}
+
+
+static void smooth_gaussColumnBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+    int w = pass->width, h = pass->height, r = pass->radius;
+
+    for (int y = begin; y < end; y++) {
+        float *dst = pass->plane0 + (size_t)y * w;
+
+        memset(dst, 0, (size_t)w * sizeof(float));
+        for (int j = -r; j <= r; j++) {
+            if (y + j < 0 || y + j >= h) {
+                continue;
+            }
+            float k = pass->kernel[j + r];
+            const float *src = pass->tmp + (size_t)(y + j) * w;
+            for (int x = 0; x < w; x++) {
+                dst[x] += k * src[x];
+            }
+        }
+    }
+}
+
+
+static void smooth_gauss(t_smooth_pass *pass, float *plane) {
+    t_smooth_pass gauss = *pass;
+    gauss.plane0 = plane;
+    bmp_parallelFor(pass->height, SMOOTH_GRAIN, smooth_gaussRowBand, &gauss);
+    bmp_parallelFor(pass->height, SMOOTH_GRAIN, smooth_gaussColumnBand, &gauss);
+}
+
+
+/* FILTRE GUIDÉ */
+
+/* plane0 = I, plane1 = I² */
+static void smooth_guidedLoadBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *src = pass->rows[y] + pass->channel;
+        float *mean = pass->plane0 + (size_t)y * pass->width;
+        float *corr = pass->plane1 + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            float v = src[(size_t)x * pass->channels];
+            mean[x] = v;
+            corr[x] = v * v;
+        }
+    }
+}
+
+
+/* Coefficients locaux : plane0 <- a, plane1 <- b */
+static void smooth_guidedCoefBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        float *mean = pass->plane0 + (size_t)y * pass->width;
+        float *corr = pass->plane1 + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            float m = mean[x];
+            float variance = corr[x] - m * m;
+            if (variance < 0.0f) {
+                variance = 0.0f;
+            }
+            float a = variance / (variance + pass->eps);
+            mean[x] = a;
+            corr[x] = m - a * m;
+        }
+    }
+}
+
+
+static void smooth_guidedStoreBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *dst = pass->rows[y] + pass->channel;
+        const float *a = pass->plane0 + (size_t)y * pass->width;
+        const float *b = pass->plane1 + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            size_t i = (size_t)x * pass->channels;
+            dst[i] = smooth_round(a[x] * dst[i] + b[x]);
+        }
+    }
+}
+
+
+static int smooth_guided(uint8_t **rows, int channels, int width, int height, int radius, double strength) {
+    if (radius < 1 || strength <= 0.0) {
+        printf("Erreur: Rayon ou force invalide\n");
+        return -1;
+    }
+
+    size_t size = (size_t)width * height;
+    t_smooth_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.rows = rows;
+    pass.channels = channels;
+    pass.width = width;
+    pass.height = height;
+    pass.radius = radius;
+    pass.eps = (float)(strength * strength);
+    pass.plane0 = (float *)malloc(size * sizeof(float));
+    pass.plane1 = (float *)malloc(size * sizeof(float));
+    pass.tmp = (float *)malloc(size * sizeof(float));
+
+    if (pass.plane0 == NULL || pass.plane1 == NULL || pass.tmp == NULL) {
+        printf("Erreur: Impossible d'allouer les plans du filtre guidé\n");
+        free(pass.plane0);
+        free(pass.plane1);
+        free(pass.tmp);
+        return -1;
+    }
+
+    for (int c = 0; c < channels; c++) {
+        pass.channel = c;
+        bmp_parallelFor(height, SMOOTH_GRAIN, smooth_guidedLoadBand, &pass);
+        smooth_box(&pass, pass.plane0);
+        smooth_box(&pass, pass.plane1);
+        bmp_parallelFor(height, SMOOTH_GRAIN, smooth_guidedCoefBand, &pass);
+        smooth_box(&pass, pass.plane0);
+        smooth_box(&pass, pass.plane1);
+        bmp_parallelFor(height, SMOOTH_GRAIN, smooth_guidedStoreBand, &pass);
+    }
+
+    free(pass.plane0);
+    free(pass.plane1);
+    free(pass.tmp);
+    return 0;
+}
+
+
+/* FILTRE BILATÉRAL */
+
+/* Gaussienne spatiale d'écart-type radius / 2, non normalisée (J / W s'en charge) */
+static float *smooth_spatialKernel(int radius) {
+    float *kernel = (float *)malloc((size_t)(2 * radius + 1) * sizeof(float));
+    if (kernel == NULL) {
+        printf("Erreur: Impossible d'allouer le noyau\n");
+        return NULL;
+    }
+
+    double sigma = radius / 2.0;
+    for (int j = -radius; j <= radius; j++) {
+        kernel[j + radius] = (float)exp(-(double)j * j / (2.0 * sigma * sigma));
+    }
+    return kernel;
+}
+
+
+/* W = g(I - i_k) dans plane0, J = W * I dans plane1 */
+static void smooth_levelLoadBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *src = pass->rows[y] + pass->channel;
+        float *weight = pass->plane0 + (size_t)y * pass->width;
+        float *weighted = pass->plane1 + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            int v = src[(size_t)x * pass->channels];
+            float g = pass->range[v];
+            weight[x] = g;
+            weighted[x] = g * v;
+        }
+    }
+}
+
+
+/* Ajoute la contribution du niveau courant aux pixels qu'il encadre */
+static void smooth_levelAccumulateBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        const uint8_t *src = pass->rows[y] + pass->channel;
+        const float *weight = pass->plane0 + (size_t)y * pass->width;
+        const float *weighted = pass->plane1 + (size_t)y * pass->width;
+        float *out = pass->out + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            float t = (src[(size_t)x * pass->channels] - pass->levelMin) / pass->levelStep;
+            float share = 1.0f - fabsf(t - (float)pass->levelIndex);
+            if (share > 0.0f && weight[x] > 1e-20f) {
+                out[x] += share * weighted[x] / weight[x];
+            }
+        }
+    }
+}
+
+
+static void smooth_levelStoreBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *dst = pass->rows[y] + pass->channel;
+        const float *out = pass->out + (size_t)y * pass->width;
+        for (int x = 0; x < pass->width; x++) {
+            dst[(size_t)x * pass->channels] = smooth_round(out[x]);
+        }
+    }
+}
+
+
+static int smooth_bilateral(uint8_t **rows, int channels, int width, int height, int radius, double sigmaRange) {
+    if (radius < 1 || sigmaRange <= 0.0) {
+        printf("Erreur: Rayon ou écart-type invalide\n");
+        return -1;
+    }
+
+    size_t size = (size_t)width * height;
+    t_smooth_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.rows = rows;
+    pass.channels = channels;
+    pass.width = width;
+    pass.height = height;
+    pass.radius = radius;
+    pass.plane0 = (float *)malloc(size * sizeof(float));
+    pass.plane1 = (float *)malloc(size * sizeof(float));
+    pass.tmp = (float *)malloc(size * sizeof(float));
+    pass.out = (float *)malloc(size * sizeof(float));
+    float *kernel = smooth_spatialKernel(radius);
+    float range[256];
+
+    if (pass.plane0 == NULL || pass.plane1 == NULL || pass.tmp == NULL || pass.out == NULL || kernel == NULL) {
+        printf("Erreur: Impossible d'allouer les plans du filtre bilatéral\n");
+        free(pass.plane0);
+        free(pass.plane1);
+        free(pass.tmp);
+        free(pass.out);
+        free(kernel);
+        return -1;
+    }
+    pass.kernel = kernel;
+    pass.range = range;
+
+    for (int c = 0; c < channels; c++) {
+        int min = 255, max = 0;
+        for (int y = 0; y < height; y++) {
+            const uint8_t *src = rows[y] + c;
+            for (int x = 0; x < width; x++) {
+                int v = src[(size_t)x * channels];
+                min = (v < min) ? v : min;
+                max = (v > max) ? v : max;
+            }
+        }
+        if (max <= min) {
+            continue;   // Composante uniforme : rien à lisser
+        }
+
+        // Niveaux espacés d'au plus sigmaRange, extrémités comprises
+        int levels = (int)ceil((max - min) / sigmaRange) + 1;
+        if (levels > SMOOTH_MAX_LEVELS) {
+            levels = SMOOTH_MAX_LEVELS;
+        }
+        pass.channel = c;
+        pass.levelMin = (float)min;
+        pass.levelStep = (float)(max - min) / (levels - 1);
+        memset(pass.out, 0, size * sizeof(float));
+
+        for (int k = 0; k < levels; k++) {
+            pass.levelIndex = k;
+            pass.level = pass.levelMin + k * pass.levelStep;
+            for (int v = 0; v < 256; v++) {
+                double d = v - pass.level;
+                range[v] = (float)exp(-d * d / (2.0 * sigmaRange * sigmaRange));
+            }
+
+            bmp_parallelFor(height, SMOOTH_GRAIN, smooth_levelLoadBand, &pass);
+            smooth_gauss(&pass, pass.plane0);
+            smooth_gauss(&pass, pass.plane1);
+            bmp_parallelFor(height, SMOOTH_GRAIN, smooth_levelAccumulateBand, &pass);
+        }
+
+        bmp_parallelFor(height, SMOOTH_GRAIN, smooth_levelStoreBand, &pass);
+    }
+
+    free(pass.plane0);
+    free(pass.plane1);
+    free(pass.tmp);
+    free(pass.out);
+    free(kernel);
+    return 0;
+}
+
+
+/* Bilatéral exact : source copiée dans plane0, une composante à la fois */
+static void smooth_referenceBand(void *arg, int begin, int end) {
+    const t_smooth_pass *pass = (const t_smooth_pass *)arg;
+    int w = pass->width, h = pass->height, r = pass->radius;
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *dst = pass->rows[y] + pass->channel;
+        for (int x = 0; x < w; x++) {
+            int center = (int)pass->plane0[(size_t)y * w + x];
+            double sum = 0.0, norm = 0.0;
+
+            for (int dy = -r; dy <= r; dy++) {
+                if (y + dy < 0 || y + dy >= h) {
+                    continue;
+                }
+                const float *row = pass->plane0 + (size_t)(y + dy) * w;
+                for (int dx = -r; dx <= r; dx++) {
+                    if (x + dx < 0 || x + dx >= w) {
+                        continue;
+                    }
+                    int v = (int)row[x + dx];
+                    double weight = pass->kernel[dy + r] * pass->kernel[dx + r] * pass->range[abs(v - center)];
+                    sum += weight * v;
+                    norm += weight;
+                }
+            }
+            dst[(size_t)x * pass->channels] = smooth_round((float)(sum / norm));
+        }
+    }
+}
+
+
+static int smooth_reference(uint8_t **rows, int channels, int width, int height, int radius, double sigmaRange) {
+    if (radius < 1 || sigmaRange <= 0.0) {
+        printf("Erreur: Rayon ou écart-type invalide\n");
+        return -1;
+    }
+
+    t_smooth_pass pass;
+    memset(&pass, 0, sizeof(pass));
+    pass.rows = rows;
+    pass.channels = channels;
+    pass.width = width;
+    pass.height = height;
+    pass.radius = radius;
+    pass.plane0 = (float *)malloc((size_t)width * height * sizeof(float));
+    float *kernel = smooth_spatialKernel(radius);
+    float range[256];
+
+    if (pass.plane0 == NULL || kernel == NULL) {
+        printf("Erreur: Impossible d'allouer le filtre de référence\n");
+        free(pass.plane0);
+        free(kernel);
+        return -1;
+    }
+    for (int d = 0; d < 256; d++) {
+        range[d] = (float)exp(-(double)d * d / (2.0 * sigmaRange * sigmaRange));
+    }
+    pass.kernel = kernel;
+    pass.range = range;
+
+    for (int c = 0; c < channels; c++) {
+        pass.channel = c;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                pass.plane0[(size_t)y * width + x] = rows[y][(size_t)x * channels + c];
+            }
+        }
+        bmp_parallelFor(height, 1, smooth_referenceBand, &pass);
+    }
+
+    free(pass.plane0);
+    free(kernel);
+    return 0;
+}
+
+
+/* POINTS D'ENTRÉE */
+
+typedef int (*t_smooth_filter)(uint8_t **rows, int channels, int width, int height, int radius, double param);
+
+
+static int smooth_bmp8(t_bmp8 *img, int radius, double param, t_smooth_filter filter) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    // Filtres symétriques : l'ordre des lignes en mémoire convient
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = filter(rows, 1, img->width, img->height, radius, param);
+    free(rows);
+    return status;
+}
+
+
+static int smooth_bmp24(t_bmp24 *img, int radius, double param, t_smooth_filter filter) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = filter(rows, 3, img->width, img->height, radius, param);
+    free(rows);
+    return status;
+}
+
+
+static int smooth_view(const t_bmp_view *view, int radius, double param, t_smooth_filter filter) {
+    uint8_t **rows = bmp_viewRows(view);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    int status = filter(rows, view->channels, view->width, view->height, radius, param);
+    free(rows);
+    return status;
+}
+
+
+int bmp8_guidedFilter(t_bmp8 *img, int radius, double strength) {
+    return smooth_bmp8(img, radius, strength, smooth_guided);
+}
+
+
+int bmp24_guidedFilter(t_bmp24 *img, int radius, double strength) {
+    return smooth_bmp24(img, radius, strength, smooth_guided);
+}
+
+
+int bmp8_bilateralFilter(t_bmp8 *img, int radius, double sigmaRange) {
+    return smooth_bmp8(img, radius, sigmaRange, smooth_bilateral);
+}
+
+
+int bmp24_bilateralFilter(t_bmp24 *img, int radius, double sigmaRange) {
+    return smooth_bmp24(img, radius, sigmaRange, smooth_bilateral);
+}
+
+
+int bmp8_bilateralReference(t_bmp8 *img, int radius, double sigmaRange) {
+    return smooth_bmp8(img, radius, sigmaRange, smooth_reference);
+}
+
+
+int bmp24_bilateralReference(t_bmp24 *img, int radius, double sigmaRange) {
+    return smooth_bmp24(img, radius, sigmaRange, smooth_reference);
+}
+
+
+int bmp_viewGuidedFilter(const t_bmp_view *view, int radius, double strength) {
+    return smooth_view(view, radius, strength, smooth_guided);
+}
+
+
+int bmp_viewBilateralFilter(const t_bmp_view *view, int radius, double sigmaRange) {
+    return smooth_view(view, radius, sigmaRange, smooth_bilateral);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file bmpsmooth.h
+ *
+ * @brief
+ * Lissages qui préservent les contours : contrairement à bmp24_gaussianBlur,
+ * un pixel n'est moyenné qu'avec des voisins de valeur proche, ce qui
+ * retire le bruit sans adoucir les bords.
+ * - Filtre guidé : coût constant par pixel quel que soit le rayon.
+ * - Filtre bilatéral rapide : approximation linéaire par morceaux sur
+ *   l'intensité, et version exacte (lente) qui sert de référence.
+ * Chaque composante d'une image couleur est filtrée séparément.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPSMOOTH_H
+#define BMPSMOOTH_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/* bmp8_guidedFilter
+ * Rôle : Applique le filtre guidé (l'image sert de guide à elle-même)
+ * Paramètres :
+ *   img      - Image à modifier
+ *   radius   - Rayon de la fenêtre carrée (>= 1)
+ *   strength - Écart de niveaux de gris en dessous duquel on lisse
+ *              (> 0 ; les contours plus marqués sont conservés)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_guidedFilter(t_bmp8 *img, int radius, double strength);
+
+/* bmp24_guidedFilter
+ * Rôle : Applique le filtre guidé à chaque composante d'une image couleur
+ * Paramètres : Identiques à bmp8_guidedFilter
+ */
+int bmp24_guidedFilter(t_bmp24 *img, int radius, double strength);
+
+/* bmp8_bilateralFilter
+ * Rôle : Filtre bilatéral approché (quelques niveaux d'intensité filtrés
+ *        puis interpolés linéairement)
+ * Paramètres :
+ *   img        - Image à modifier
+ *   radius     - Rayon de la fenêtre (>= 1) ; l'écart-type spatial vaut radius / 2
+ *   sigmaRange - Écart-type sur l'intensité (> 0, 20 à 40 en général)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_bilateralFilter(t_bmp8 *img, int radius, double sigmaRange);
+
+/* bmp24_bilateralFilter
+ * Rôle : Filtre bilatéral approché sur chaque composante d'une image couleur
+ * Paramètres : Identiques à bmp8_bilateralFilter
+ */
+int bmp24_bilateralFilter(t_bmp24 *img, int radius, double sigmaRange);
+
+/* bmp8_bilateralReference / bmp24_bilateralReference
+ * Rôle : Filtre bilatéral exact, calculé pixel par pixel sur toute la
+ *        fenêtre ; lent, il sert à mesurer la précision de la version rapide
+ *        (tests/test_bilateral.c : moins de 0,25 niveau d'écart en moyenne,
+ *        4 niveaux au plus)
+ * Paramètres : Identiques à bmp8_bilateralFilter
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_bilateralReference(t_bmp8 *img, int radius, double sigmaRange);
+int bmp24_bilateralReference(t_bmp24 *img, int radius, double sigmaRange);
+
+/* bmp_viewGuidedFilter / bmp_viewBilateralFilter
+ * Rôle : Applique le filtre guidé ou le filtre bilatéral approché à une
+ *        zone d'image, sans la copier
+ * Paramètres :
+ *   view - Zone à modifier (chaque composante séparément, alpha compris)
+ *   Autres paramètres identiques à bmp8_guidedFilter / bmp8_bilateralFilter
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : Les pixels hors de la zone ne sont ni lus ni modifiés
+ */
+int bmp_viewGuidedFilter(const t_bmp_view *view, int radius, double strength);
+int bmp_viewBilateralFilter(const t_bmp_view *view, int radius, double sigmaRange);
+
+#endif
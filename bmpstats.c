@@ -0,0 +1,193 @@
+/**
+ * @file bmpstats.c
+ *
+ * @brief
+ * Toutes les statistiques découlent de l'histogramme : une lecture de
+ * l'image (parallèle, dans bmphistogram) suffit, le reste ne coûte que
+ * 256 opérations par composante. L'étirement des niveaux ajoute une
+ * seule lecture pour appliquer la table de correspondance.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpstats.h"
+#include "bmphistogram.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+/* Déduit min, max, moyenne et écart-type de l'histogramme déjà rempli */
+static void stats_fromHistogram(t_channel_stats *stats) {
+    uint64_t count = 0, sum = 0, sumSq = 0;
+    int min = -1, max = 0;
+
+    for (int v = 0; v < 256; v++) {
+        uint64_t n = stats->hist[v];
+        if (n == 0) {
+            continue;
+        }
+        if (min < 0) {
+            min = v;
+        }
+        max = v;
+        count += n;
+        sum += n * v;
+        sumSq += n * v * v;
+    }
+
+    stats->count = count;
+    stats->min = (uint8_t)((min < 0) ? 0 : min);
+    stats->max = (uint8_t)max;
+    if (count == 0) {
+        stats->mean = 0.0;
+        stats->stddev = 0.0;
+        return;
+    }
+
+    stats->mean = (double)sum / count;
+    double variance = (double)sumSq / count - stats->mean * stats->mean;
+    stats->stddev = (variance > 0.0) ? sqrt(variance) : 0.0;
+}
+
+
+int bmp8_computeStats(t_bmp8 *img, t_image_stats *stats) {
+    if (stats == NULL || bmp8_histogram(img, stats->channel[0].hist) != 0) {
+        return -1;
+    }
+
+    stats->channels = 1;
+    stats_fromHistogram(&stats->channel[0]);
+    return 0;
+}
+
+
+int bmp24_computeStats(t_bmp24 *img, t_image_stats *stats) {
+    uint32_t hist[3][256];
+
+    if (stats == NULL || bmp24_histogram(img, hist) != 0) {
+        return -1;
+    }
+
+    stats->channels = 3;
+    for (int c = 0; c < 3; c++) {
+        memcpy(stats->channel[c].hist, hist[c], sizeof(hist[c]));
+        stats_fromHistogram(&stats->channel[c]);
+    }
+    return 0;
+}
+
+
+int bmp_viewComputeStats(const t_bmp_view *view, t_image_stats *stats) {
+    uint32_t hist[4][256];
+
+    if (stats == NULL || bmp_viewHistogram(view, &hist[0][0]) != 0) {
+        return -1;
+    }
+
+    stats->channels = view->channels;
+    for (int c = 0; c < view->channels; c++) {
+        memcpy(stats->channel[c].hist, hist[c], sizeof(hist[c]));
+        stats_fromHistogram(&stats->channel[c]);
+    }
+    return 0;
+}
+
+
+int bmp_statsPercentile(const t_channel_stats *stats, double percent) {
+    if (stats == NULL || stats->count == 0) {
+        return 0;
+    }
+    if (percent <= 0.0) {
+        return stats->min;
+    }
+    if (percent >= 100.0) {
+        return stats->max;
+    }
+
+    double target = percent * stats->count / 100.0;
+    uint64_t cumulated = 0;
+    for (int v = 0; v < 256; v++) {
+        cumulated += stats->hist[v];
+        if ((double)cumulated >= target) {
+            return v;
+        }
+    }
+    return stats->max;
+}
+
+
+/* Table d'étirement : low -> 0, high -> 255, arrondi au plus proche */
+static void stats_levelsLut(int low, int high, uint8_t lut[256]) {
+    if (high <= low) {
+        for (int v = 0; v < 256; v++) {
+            lut[v] = (uint8_t)v;
+        }
+        return;
+    }
+
+    int range = high - low;
+    for (int v = 0; v < 256; v++) {
+        if (v <= low) {
+            lut[v] = 0;
+        } else if (v >= high) {
+            lut[v] = 255;
+        } else {
+            lut[v] = (uint8_t)(((v - low) * 255 + range / 2) / range);
+        }
+    }
+}
+
+
+int bmp8_autoLevels(t_bmp8 *img, double lowPct, double highPct) {
+    t_image_stats stats;
+    if (lowPct < 0.0 || highPct < 0.0 || lowPct + highPct >= 100.0) {
+        fprintf(stderr, "Erreur: Pourcentages invalides\n");
+        return -1;
+    }
+    if (bmp8_computeStats(img, &stats) != 0) {
+        return -1;
+    }
+
+    uint8_t lut[256];
+    stats_levelsLut(bmp_statsPercentile(&stats.channel[0], lowPct),
+                    bmp_statsPercentile(&stats.channel[0], 100.0 - highPct), lut);
+    return bmp8_applyLut(img, lut);
+}
+
+
+int bmp24_autoLevels(t_bmp24 *img, double lowPct, double highPct, int linked) {
+    t_image_stats stats;
+    if (lowPct < 0.0 || highPct < 0.0 || lowPct + highPct >= 100.0) {
+        printf("Erreur: Pourcentages invalides\n");
+        return -1;
+    }
+    if (bmp24_computeStats(img, &stats) != 0) {
+        return -1;
+    }
+
+    uint8_t luts[3][256];
+    if (linked) {
+        // Bornes communes : centiles de l'histogramme des trois composantes réunies
+        t_channel_stats all;
+        memset(&all, 0, sizeof(all));
+        for (int c = 0; c < 3; c++) {
+            for (int v = 0; v < 256; v++) {
+                all.hist[v] += stats.channel[c].hist[v];
+            }
+        }
+        stats_fromHistogram(&all);
+
+        stats_levelsLut(bmp_statsPercentile(&all, lowPct), bmp_statsPercentile(&all, 100.0 - highPct), luts[0]);
+        memcpy(luts[1], luts[0], 256);
+        memcpy(luts[2], luts[0], 256);
+    } else {
+        for (int c = 0; c < 3; c++) {
+            stats_levelsLut(bmp_statsPercentile(&stats.channel[c], lowPct),
+                            bmp_statsPercentile(&stats.channel[c], 100.0 - highPct), luts[c]);
+        }
+    }
+
+    return bmp24_applyLut(img, (const uint8_t (*)[256])luts);
+}
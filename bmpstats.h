@@ -0,0 +1,106 @@
+/**
+ * @file bmpstats.h
+ *
+ * @brief
+ * Statistiques d'image (minimum, maximum, moyenne, écart-type, centiles)
+ * par composante, toutes déduites d'un seul histogramme calculé en une
+ * lecture parallèle. Elles servent notamment à choisir la valeur passée à
+ * bmp8_brightness / bmp24_brightness (par exemple 128 - moyenne) et à
+ * l'étirement automatique des niveaux.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPSTATS_H
+#define BMPSTATS_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpview.h"
+
+/*
+ * Statistiques d'une composante
+ */
+typedef struct {
+    uint8_t min;            // Plus petite valeur présente
+    uint8_t max;            // Plus grande valeur présente
+    double mean;            // Moyenne
+    double stddev;          // Écart-type
+    uint64_t count;         // Nombre de pixels
+    uint32_t hist[256];     // Histogramme (sert aux centiles)
+} t_channel_stats;
+
+/*
+ * Statistiques d'une image : 1 composante (gris), 3 (rouge, vert, bleu)
+ * ou 4 (zone d'une image 32 bits : bleu, vert, rouge, alpha)
+ */
+typedef struct {
+    int channels;
+    t_channel_stats channel[4];
+} t_image_stats;
+
+/* bmp8_computeStats
+ * Rôle : Calcule les statistiques d'une image 8 bits en une seule lecture
+ * Paramètres :
+ *   img   - Image source
+ *   stats - Reçoit les statistiques (channels = 1)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_computeStats(t_bmp8 *img, t_image_stats *stats);
+
+/* bmp24_computeStats
+ * Rôle : Calcule les statistiques des trois composantes en une seule lecture
+ * Paramètres :
+ *   img   - Image source
+ *   stats - Reçoit les statistiques (channels = 3, dans l'ordre R, G, B)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_computeStats(t_bmp24 *img, t_image_stats *stats);
+
+/* bmp_viewComputeStats
+ * Rôle : Calcule les statistiques de chaque composante d'une zone d'image,
+ *        sans la copier
+ * Paramètres :
+ *   view  - Zone source
+ *   stats - Reçoit les statistiques (channels = view->channels, dans
+ *           l'ordre des octets du pixel)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_viewComputeStats(const t_bmp_view *view, t_image_stats *stats);
+
+/* bmp_statsPercentile
+ * Rôle : Donne le centile d'une composante à partir de son histogramme
+ * Paramètres :
+ *   stats   - Statistiques de la composante
+ *   percent - Centile voulu, de 0 (minimum) à 100 (maximum)
+ * Retour : Plus petite valeur v telle qu'au moins percent % des pixels
+ *          soient <= v
+ */
+int bmp_statsPercentile(const t_channel_stats *stats, double percent);
+
+/* bmp8_autoLevels
+ * Rôle : Étire le contraste : les valeurs entre les centiles bas et haut
+ *        sont réparties sur 0..255, celles en dehors sont saturées
+ * Paramètres :
+ *   img     - Image à modifier
+ *   lowPct  - Pourcentage de pixels sacrifiés côté sombre (0.5 en général)
+ *   highPct - Pourcentage de pixels sacrifiés côté clair
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_autoLevels(t_bmp8 *img, double lowPct, double highPct);
+
+/* bmp24_autoLevels
+ * Rôle : Étire le contraste d'une image couleur
+ * Paramètres :
+ *   img     - Image à modifier
+ *   lowPct  - Pourcentage de pixels sacrifiés côté sombre
+ *   highPct - Pourcentage de pixels sacrifiés côté clair
+ *   linked  - 1 : mêmes bornes pour les trois composantes (teinte conservée),
+ *             0 : bornes par composante (corrige aussi une dominante de couleur)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp24_autoLevels(t_bmp24 *img, double lowPct, double highPct, int linked);
+
+#endif
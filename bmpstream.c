@@ -0,0 +1,492 @@
+/**
+ * @file bmpstream.c
+ *
+ * @brief
+ * La chaîne est d'abord compilée en étapes : les opérations ponctuelles
+ * consécutives sont composées en une seule table, les filtres 3x3 gardent
+ * chacun une fenêtre de lignes. Une bande lue passe d'étape en étape :
+ * une table modifie la bande sur place, un filtre ajoute la bande à sa
+ * fenêtre, produit toutes les lignes dont les deux voisines sont connues,
+ * et ne conserve que les deux dernières lignes pour la bande suivante.
+ * Les lignes restent dans l'ordre du fichier d'un bout à l'autre : pour
+ * une image 24 bits rangée de bas en haut, la voisine du haut est donc la
+ * ligne suivante du fichier. Chaque étape répartit ses lignes entre les
+ * threads.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpstream.h"
+#include "bmpprobe.h"
+#include "bmpthread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_GRAIN 16
+#define STREAM_IO_BUFFER (1 << 20)
+
+typedef enum {
+    STREAM_LUT,             // Table appliquée à chaque octet
+    STREAM_GRAY,            // Moyenne des trois composantes
+    STREAM_KERNEL           // Filtre 3x3
+} t_stage_type;
+
+typedef struct {
+    t_stage_type type;
+    uint8_t lut[256];       // STREAM_LUT : tables consécutives déjà composées
+    float kernel[3][3];     // STREAM_KERNEL
+    uint8_t *window;        // Lignes d'entrée en attente, halo compris
+    int windowFirst;        // Ligne du fichier rangée en tête de window
+    int windowCount;
+    int nextRow;            // Prochaine ligne à produire
+    uint8_t *out;           // Lignes produites par le dernier appel
+} t_stream_stage;
+
+typedef struct {
+    int bits;               // 8 ou 24
+    int width;
+    int height;
+    int topDown;
+    size_t rowSize;         // Octets par ligne du fichier, padding compris
+    int capacity;           // Lignes que peut contenir chaque tampon
+    t_stream_stage *stages;
+    int stageCount;
+} t_stream;
+
+typedef struct {
+    const t_stream *stream;
+    const t_stream_stage *stage;
+    uint8_t *rows;          // Bande traitée (ou produite pour un filtre)
+    int first;              // Ligne du fichier de rows[0]
+} t_stream_pass;
+
+
+static void stream_setField(uint8_t *header, int offset, uint32_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        header[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+
+/* Avance jusqu'à offset sans fseek : l'entrée peut être un tube */
+static int stream_skip(FILE *file, uint32_t consumed, uint32_t offset) {
+    uint8_t scratch[256];
+
+    if (offset == 0) {
+        return 0;
+    }
+    if (offset < consumed) {
+        return -1;
+    }
+    while (consumed < offset) {
+        size_t chunk = (offset - consumed < sizeof(scratch)) ? offset - consumed : sizeof(scratch);
+        if (fread(scratch, 1, chunk, file) != chunk) {
+            return -1;
+        }
+        consumed += (uint32_t)chunk;
+    }
+    return 0;
+}
+
+
+/* OPÉRATIONS PONCTUELLES */
+
+static void stream_lutBand(void *arg, int begin, int end) {
+    const t_stream_pass *pass = (const t_stream_pass *)arg;
+    const t_stream *stream = pass->stream;
+    const uint8_t *lut = pass->stage->lut;
+
+    // En 8 bits les fonctions d'origine modifient aussi le padding
+    size_t span = (stream->bits == 8) ? stream->rowSize : (size_t)stream->width * 3;
+    for (int r = begin; r < end; r++) {
+        uint8_t *row = pass->rows + (size_t)r * stream->rowSize;
+        for (size_t i = 0; i < span; i++) {
+            row[i] = lut[row[i]];
+        }
+    }
+}
+
+
+static void stream_grayBand(void *arg, int begin, int end) {
+    const t_stream_pass *pass = (const t_stream_pass *)arg;
+    const t_stream *stream = pass->stream;
+
+    for (int r = begin; r < end; r++) {
+        uint8_t *p = pass->rows + (size_t)r * stream->rowSize;
+        for (int x = 0; x < stream->width; x++, p += 3) {
+            uint8_t gray = (uint8_t)((p[0] + p[1] + p[2]) / 3);
+            p[0] = p[1] = p[2] = gray;
+        }
+    }
+}
+
+
+/* FILTRES 3X3 */
+
+/* Même calcul que bmp24_convolution : voisins hors de l'image ignorés */
+static void stream_kernelRow24(const t_stream *stream, const float kernel[3][3],
+                               const uint8_t *taps[3], uint8_t *dst) {
+    for (int x = 0; x < stream->width; x++) {
+        for (int c = 0; c < 3; c++) {
+            float sum = 0.0f;
+            for (int j = 0; j < 3; j++) {
+                if (taps[j] == NULL) {
+                    continue;
+                }
+                for (int i = -1; i <= 1; i++) {
+                    if (x + i >= 0 && x + i < stream->width) {
+                        sum += taps[j][(x + i) * 3 + c] * kernel[j][i + 1];
+                    }
+                }
+            }
+            dst[x * 3 + c] = (sum > 255.0f) ? 255 : ((sum < 0.0f) ? 0 : (uint8_t)sum);
+        }
+    }
+}
+
+
+/* Même calcul que bmp8_applyFilter : pixels du bord inchangés */
+static void stream_kernelRow8(const t_stream *stream, const float kernel[3][3],
+                              const uint8_t *taps[3], uint8_t *dst) {
+    memcpy(dst, taps[1], stream->rowSize);
+    if (taps[0] == NULL || taps[2] == NULL) {
+        return;
+    }
+
+    for (int x = 1; x + 1 < stream->width; x++) {
+        float sum = 0.0f;
+        for (int j = 0; j < 3; j++) {
+            for (int i = -1; i <= 1; i++) {
+                sum += taps[j][x + i] * kernel[j][i + 1];
+            }
+        }
+        if (sum > 255) {
+            sum = 255;
+        } else if (sum < 0) {
+            sum = 0;
+        }
+        dst[x] = (uint8_t)sum;
+    }
+}
+
+
+static void stream_kernelBand(void *arg, int begin, int end) {
+    const t_stream_pass *pass = (const t_stream_pass *)arg;
+    const t_stream *stream = pass->stream;
+    const t_stream_stage *stage = pass->stage;
+
+    for (int r = begin; r < end; r++) {
+        int row = pass->first + r;
+        const uint8_t *cur = stage->window + (size_t)(row - stage->windowFirst) * stream->rowSize;
+        const uint8_t *prev = (row > 0) ? cur - stream->rowSize : NULL;
+        const uint8_t *next = (row + 1 < stream->height) ? cur + stream->rowSize : NULL;
+        uint8_t *dst = pass->rows + (size_t)r * stream->rowSize;
+
+        if (stream->bits == 8) {
+            // bmp8_applyFilter suit l'ordre de la mémoire, qui est celui du fichier
+            const uint8_t *taps[3] = {prev, cur, next};
+            stream_kernelRow8(stream, stage->kernel, taps, dst);
+        } else {
+            // Ligne 0 du noyau = voisine du haut de l'image
+            const uint8_t *taps[3] = {stream->topDown ? prev : next, cur, stream->topDown ? next : prev};
+            stream_kernelRow24(stream, stage->kernel, taps, dst);
+        }
+    }
+}
+
+
+/*
+ * Ajoute count lignes (les suivantes dans l'ordre du fichier) à la fenêtre
+ * du filtre et produit toutes les lignes possibles dans stage->out.
+ * Renvoie le nombre de lignes produites.
+ */
+static int stream_kernelPush(const t_stream *stream, t_stream_stage *stage, const uint8_t *rows, int count) {
+    memcpy(stage->window + (size_t)stage->windowCount * stream->rowSize, rows, (size_t)count * stream->rowSize);
+    stage->windowCount += count;
+
+    // Une ligne est prête quand sa voisine suivante est arrivée (ou en fin d'image)
+    int end = stage->windowFirst + stage->windowCount;
+    int ready = (end == stream->height) ? end : end - 1;
+    int first = stage->nextRow;
+
+    int produced = (ready > first) ? ready - first : 0;
+    if (produced > 0) {
+        t_stream_pass pass = {stream, stage, stage->out, first};
+        bmp_parallelFor(produced, STREAM_GRAIN, stream_kernelBand, &pass);
+        stage->nextRow = ready;
+    }
+
+    // Seul le halo de la prochaine ligne à produire est conservé
+    int keep = (stage->nextRow - 1 > stage->windowFirst) ? stage->nextRow - 1 : stage->windowFirst;
+    int drop = keep - stage->windowFirst;
+    if (drop > 0) {
+        memmove(stage->window, stage->window + (size_t)drop * stream->rowSize,
+                (size_t)(stage->windowCount - drop) * stream->rowSize);
+        stage->windowFirst = keep;
+        stage->windowCount -= drop;
+    }
+    return produced;
+}
+
+
+/* COMPILATION DE LA CHAÎNE */
+
+static void stream_freeStages(t_stream *stream) {
+    for (int i = 0; i < stream->stageCount; i++) {
+        free(stream->stages[i].window);
+        free(stream->stages[i].out);
+    }
+    free(stream->stages);
+    stream->stages = NULL;
+    stream->stageCount = 0;
+}
+
+
+static int stream_compile(t_stream *stream, const t_bmp_chain *chain, int bandRows) {
+    stream->stages = (t_stream_stage *)calloc(chain->count > 0 ? chain->count : 1, sizeof(t_stream_stage));
+    if (stream->stages == NULL) {
+        return -1;
+    }
+
+    int kernels = 0;
+    for (int i = 0; i < chain->count; i++) {
+        const t_chain_op *op = &chain->ops[i];
+        t_stream_stage *last = (stream->stageCount > 0) ? &stream->stages[stream->stageCount - 1] : NULL;
+        uint8_t lut[256];
+
+        if (op->step == BMP_STEP_GRAYSCALE) {
+            if (stream->bits == 24) {
+                stream->stages[stream->stageCount++].type = STREAM_GRAY;
+            }
+        } else if (bmp_chainLut(op, lut) == 0) {
+            if (last != NULL && last->type == STREAM_LUT) {
+                // Deux tables consécutives n'en font qu'une
+                for (int v = 0; v < 256; v++) {
+                    last->lut[v] = lut[last->lut[v]];
+                }
+            } else {
+                t_stream_stage *stage = &stream->stages[stream->stageCount++];
+                stage->type = STREAM_LUT;
+                memcpy(stage->lut, lut, sizeof(lut));
+            }
+        } else {
+            t_stream_stage *stage = &stream->stages[stream->stageCount++];
+            stage->type = STREAM_KERNEL;
+            bmp_chainKernel(op->step, stage->kernel);
+            kernels++;
+        }
+    }
+
+    // Chaque filtre peut rendre une ligne de plus qu'il n'en reçoit (fin d'image)
+    stream->capacity = bandRows + kernels + 2;
+    for (int i = 0; i < stream->stageCount; i++) {
+        t_stream_stage *stage = &stream->stages[i];
+        if (stage->type != STREAM_KERNEL) {
+            continue;
+        }
+        stage->window = (uint8_t *)malloc((size_t)stream->capacity * stream->rowSize);
+        stage->out = (uint8_t *)malloc((size_t)stream->capacity * stream->rowSize);
+        if (stage->window == NULL || stage->out == NULL) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+/* EN-TÊTES */
+
+/*
+ * Lit les en-têtes (et la palette en 8 bits) jusqu'au début des pixels et
+ * écrit ceux que produirait l'enregistrement de l'image chargée
+ */
+static int stream_headers(t_stream *stream, FILE *input, FILE *output) {
+    uint8_t header[BMP_HEADER_SIZE];
+    t_bmp_probe info;
+
+    if (fread(header, 1, sizeof(header), input) != sizeof(header) ||
+        bmp_probeHeader(header, sizeof(header), &info) != 0 || info.infoSize < 40) {
+        fprintf(stderr, "Erreur: Le fichier n'est pas au format BMP\n");
+        return -1;
+    }
+    if ((info.bitDepth != 8 && info.bitDepth != 24) || info.compression != BMP_BI_RGB) {
+        fprintf(stderr, "Erreur: Seules les images 8 et 24 bits non compressées sont traitées en flux\n");
+        return -1;
+    }
+
+    stream->bits = info.bitDepth;
+    stream->width = info.width;
+    stream->height = info.height;
+    stream->topDown = info.topDown;
+    stream->rowSize = info.rowSize;
+    uint32_t dataSize = (uint32_t)(stream->rowSize * (size_t)stream->height);
+    uint32_t consumed = BMP_HEADER_SIZE;
+
+    if (stream->bits == 8) {
+        // Comme bmp8_loadImage : palette juste après les 54 octets, en-tête réécrit non compressé
+        uint8_t palette[BMP_COLOR_TABLE_SIZE];
+        uint32_t colors = (info.colorsUsed == 0 || info.colorsUsed > 256) ? 256 : info.colorsUsed;
+        memset(palette, 0, sizeof(palette));
+        if (fread(palette, 1, colors * 4, input) != colors * 4) {
+            fprintf(stderr, "Erreur: Impossible de lire la table de couleurs\n");
+            return -1;
+        }
+        consumed += colors * 4;
+
+        stream_setField(header, 2, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE + dataSize, 4);
+        stream_setField(header, 10, BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE, 4);
+        stream_setField(header, 30, BMP_BI_RGB, 4);
+        stream_setField(header, 34, dataSize, 4);
+        stream_setField(header, 46, 256, 4);
+        if (fwrite(header, 1, sizeof(header), output) != sizeof(header) ||
+            fwrite(palette, 1, sizeof(palette), output) != sizeof(palette)) {
+            perror("Erreur: Impossible d'écrire l'en-tête");
+            return -1;
+        }
+    } else {
+        // Comme bmp24_saveImage : en-têtes normalisés, pixels après 54 octets
+        t_bmp_header fileHeader;
+        t_bmp_info infoHeader;
+        memcpy(&fileHeader, header, sizeof(fileHeader));
+        memcpy(&infoHeader, header + HEADER_SIZE, sizeof(infoHeader));
+        fileHeader.type = BMP_TYPE;
+        fileHeader.offset = HEADER_SIZE + INFO_SIZE;
+        fileHeader.size = fileHeader.offset + dataSize;
+        infoHeader.size = INFO_SIZE;
+        infoHeader.width = stream->width;
+        infoHeader.height = stream->topDown ? -stream->height : stream->height;
+        infoHeader.planes = 1;
+        infoHeader.bits = DEFAULT_DEPTH;
+        infoHeader.compression = BMP_BI_RGB;
+        infoHeader.imageSize = dataSize;
+        if (fwrite(&fileHeader, sizeof(fileHeader), 1, output) != 1 ||
+            fwrite(&infoHeader, sizeof(infoHeader), 1, output) != 1) {
+            perror("Erreur: Impossible d'écrire l'en-tête");
+            return -1;
+        }
+    }
+
+    if (stream_skip(input, consumed, info.dataOffset) != 0) {
+        fprintf(stderr, "Erreur: Début des pixels invalide\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+/* BOUCLE PRINCIPALE */
+
+/* Fait passer une bande par toutes les étapes puis écrit les lignes terminées */
+static int stream_band(t_stream *stream, uint8_t *rows, int count, FILE *output) {
+    for (int i = 0; i < stream->stageCount && count > 0; i++) {
+        t_stream_stage *stage = &stream->stages[i];
+        t_stream_pass pass = {stream, stage, rows, 0};
+
+        if (stage->type == STREAM_LUT) {
+            bmp_parallelFor(count, STREAM_GRAIN, stream_lutBand, &pass);
+        } else if (stage->type == STREAM_GRAY) {
+            bmp_parallelFor(count, STREAM_GRAIN, stream_grayBand, &pass);
+        } else {
+            count = stream_kernelPush(stream, stage, rows, count);
+            rows = stage->out;
+        }
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    // En 24 bits le padding est toujours écrit à zéro
+    size_t span = (size_t)stream->width * 3;
+    if (stream->bits == 24 && span < stream->rowSize) {
+        for (int r = 0; r < count; r++) {
+            memset(rows + (size_t)r * stream->rowSize + span, 0, stream->rowSize - span);
+        }
+    }
+    return (fwrite(rows, stream->rowSize, (size_t)count, output) == (size_t)count) ? 0 : -1;
+}
+
+
+int bmp_streamFile(FILE *input, FILE *output, const t_bmp_chain *chain, int bandRows) {
+    if (input == NULL || output == NULL || chain == NULL || bandRows < 0) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    if (bandRows == 0) {
+        bandRows = BMP_STREAM_DEFAULT_BAND;
+    }
+
+    t_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (stream_headers(&stream, input, output) != 0) {
+        return -1;
+    }
+
+    uint8_t *band = NULL;
+    if (stream_compile(&stream, chain, bandRows) != 0 ||
+        (band = (uint8_t *)malloc((size_t)bandRows * stream.rowSize)) == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        stream_freeStages(&stream);
+        return -1;
+    }
+
+    int status = 0;
+    size_t pixelBytes = (size_t)stream.width * (stream.bits / 8);
+    for (int first = 0; status == 0 && first < stream.height; first += bandRows) {
+        int count = (stream.height - first < bandRows) ? stream.height - first : bandRows;
+        size_t want = (size_t)count * stream.rowSize;
+        size_t got = fread(band, 1, want, input);
+
+        // Le padding de la dernière ligne est parfois absent
+        if (got < want) {
+            if (first + count < stream.height || got < want - stream.rowSize + pixelBytes) {
+                fprintf(stderr, "Erreur: Données de l'image incomplètes\n");
+                status = -1;
+                break;
+            }
+            memset(band + got, 0, want - got);
+        }
+
+        if (stream_band(&stream, band, count, output) != 0) {
+            perror("Erreur: Impossible d'écrire les données de l'image");
+            status = -1;
+        }
+    }
+
+    free(band);
+    stream_freeStages(&stream);
+    return status;
+}
+
+
+int bmp_streamProcess(const char *input, const char *output, const t_bmp_chain *chain, int bandRows) {
+    if (input == NULL || output == NULL) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    FILE *in = fopen(input, "rb");
+    if (in == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier");
+        return -1;
+    }
+    FILE *out = fopen(output, "wb");
+    if (out == NULL) {
+        perror("Erreur: Impossible d'ouvrir le fichier pour l'écriture");
+        fclose(in);
+        return -1;
+    }
+
+    // Grands tampons : les bandes sont lues et écrites d'un bloc
+    setvbuf(in, NULL, _IOFBF, STREAM_IO_BUFFER);
+    setvbuf(out, NULL, _IOFBF, STREAM_IO_BUFFER);
+
+    int status = bmp_streamFile(in, out, chain, bandRows);
+    fclose(in);
+    if (fclose(out) != 0 && status == 0) {
+        perror("Erreur: Impossible d'écrire les données de l'image");
+        status = -1;
+    }
+    return status;
+}
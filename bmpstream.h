@@ -0,0 +1,48 @@
+/**
+ * @file bmpstream.h
+ *
+ * @brief
+ * Exécution d'une chaîne d'opérations (bmpchain.h) en flux, pour les images
+ * trop grandes pour la mémoire : le fichier est lu par bandes de lignes,
+ * chaque bande traverse toutes les étapes, et les lignes terminées sont
+ * écrites aussitôt. Un filtre 3x3 ne garde que deux lignes de la bande
+ * précédente (le halo) : la mémoire utilisée dépend de la largeur de
+ * l'image et de la taille des bandes, jamais de sa hauteur. Le fichier
+ * produit est identique à celui de bmp8_applyChain / bmp24_applyChain
+ * suivi d'un enregistrement.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPSTREAM_H
+#define BMPSTREAM_H
+
+#include <stdio.h>
+#include "bmpchain.h"
+
+/* Lignes lues à chaque bande si l'appelant ne précise rien */
+#define BMP_STREAM_DEFAULT_BAND 256
+
+/* bmp_streamFile
+ * Rôle : Applique la chaîne à une image lue séquentiellement dans input et
+ *        écrit le résultat dans output, bande par bande
+ * Paramètres :
+ *   input    - Fichier BMP 8 ou 24 bits non compressé, lu sans retour en
+ *              arrière (un tube convient)
+ *   output   - Destination, écrite séquentiellement (un tube convient)
+ *   chain    - Étapes à appliquer
+ *   bandRows - Lignes lues à la fois (0 : BMP_STREAM_DEFAULT_BAND)
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : Les lignes sont traitées dans l'ordre du fichier (de bas en haut
+ *        ou de haut en bas) ; le résultat garde cet ordre
+ */
+int bmp_streamFile(FILE *input, FILE *output, const t_bmp_chain *chain, int bandRows);
+
+/* bmp_streamProcess
+ * Rôle : Comme bmp_streamFile, à partir des chemins des fichiers
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_streamProcess(const char *input, const char *output, const t_bmp_chain *chain, int bandRows);
+
+#endif
@@ -0,0 +1,486 @@
+/**
+ * @file bmpthread.c
+ *
+ * @brief
+ * Ordonnanceur par vol de travail (pthreads et atomiques C11). Les threads
+ * sont créés une fois, au premier traitement parallèle, puis dorment quand
+ * il n'y a rien à faire. Chaque thread du groupe possède une pile de
+ * Chase-Lev : il empile et dépile ses tâches par le bas sans verrou, les
+ * autres volent par le haut avec une seule comparaison-échange. Un thread
+ * extérieur au groupe (le programme principal) dépose ses tâches dans une
+ * file commune protégée par un verrou.
+ *
+ * bmp_parallelFor découpe l'intervalle en quelques bandes contiguës par
+ * thread : le thread appelant traite la première aussitôt et les suivantes
+ * dans l'ordre, les voleurs prennent les dernières. Quand un filtre est
+ * appelé depuis une tâche (un fichier d'un lot), ses bandes arrivent dans
+ * la pile du thread qui l'exécute et les threads inoccupés viennent les
+ * prendre : les petites images restent sur un thread, les grandes se
+ * répartissent sur tous.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpthread.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define BMP_MAX_THREADS 64
+#define BMP_BANDS_PER_THREAD 4      // Bandes par thread : de quoi équilibrer sans trop découper
+#define BMP_DEQUE_SIZE 1024         // Tâches par pile (puissance de 2) ; pile pleine : exécution directe
+#define BMP_SPIN_ROUNDS 64          // Tentatives de vol avant de s'endormir
+
+static int forcedThreadCount = 0;
+
+/*
+ * Tâche : une bande de bmp_parallelFor ou une tâche de bmp_taskSpawn
+ */
+typedef struct bmp_task {
+    t_band_task band;           // Bande : band(arg, begin, end)
+    t_task_fn fn;               // Tâche isolée : fn(arg)
+    void *arg;
+    int begin;
+    int end;
+    t_task_group *group;
+    int allocated;              // Libérée après exécution (bmp_taskSpawn)
+    struct bmp_task *next;      // Chaînage dans la file commune
+} t_task;
+
+/*
+ * Pile de Chase-Lev : le propriétaire travaille en bas, les voleurs en haut
+ */
+typedef struct {
+    atomic_llong top;
+    atomic_llong bottom;
+    _Atomic(t_task *) slots[BMP_DEQUE_SIZE];
+} t_deque;
+
+/*
+ * Groupe de threads partagé par tous les traitements
+ */
+typedef struct {
+    pthread_mutex_t lock;       // Création des threads, file commune, sommeil
+    pthread_cond_t wake;
+    t_deque *deques[BMP_MAX_THREADS];
+    atomic_int workers;         // Threads créés
+    atomic_int active;          // Threads autorisés à travailler (bmp_threadCount() - 1)
+    atomic_int sleepers;
+    atomic_uint epoch;          // Incrémenté à chaque dépôt de tâches
+    t_task *sharedHead;         // File commune (threads extérieurs)
+    t_task *sharedTail;
+    atomic_int sharedCount;
+} t_pool;
+
+static t_pool pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER
+};
+
+// Indice du thread courant dans le groupe, -1 pour un thread extérieur
+static _Thread_local int workerIndex = -1;
+static _Thread_local unsigned int stealSeed = 0;
+
+
+static int bmp_cpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+#endif
+}
+
+
+int bmp_threadCount(void) {
+    int count = forcedThreadCount;
+
+    if (count <= 0) {
+        const char *env = getenv("BMP_THREADS");
+        count = (env != NULL) ? atoi(env) : 0;
+    }
+    if (count <= 0) {
+        count = bmp_cpuCount();
+    }
+
+    return (count > BMP_MAX_THREADS) ? BMP_MAX_THREADS : count;
+}
+
+
+void bmp_setThreadCount(int count) {
+    forcedThreadCount = (count > 0) ? count : 0;
+}
+
+
+/*
+ * Empile une tâche (propriétaire seulement) : -1 si la pile est pleine
+ */
+static int deque_push(t_deque *deque, t_task *task) {
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    if (b - t >= BMP_DEQUE_SIZE) {
+        return -1;
+    }
+    atomic_store_explicit(&deque->slots[b & (BMP_DEQUE_SIZE - 1)], task, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    return 0;
+}
+
+
+/*
+ * Dépile la tâche la plus récente (propriétaire seulement)
+ */
+static t_task *deque_pop(t_deque *deque) {
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    t_task *task = atomic_load_explicit(&deque->slots[b & (BMP_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Dernière tâche : on la dispute aux voleurs
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+
+/*
+ * Vole la tâche la plus ancienne (n'importe quel thread)
+ */
+static t_task *deque_steal(t_deque *deque) {
+    long long t = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (t >= b) {
+        return NULL;
+    }
+    t_task *task = atomic_load_explicit(&deque->slots[t & (BMP_DEQUE_SIZE - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+
+/*
+ * Réveille les threads endormis après un dépôt de tâches
+ */
+static void pool_notify(void) {
+    atomic_fetch_add(&pool.epoch, 1);
+    if (atomic_load(&pool.sleepers) > 0) {
+        pthread_mutex_lock(&pool.lock);
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+    }
+}
+
+
+static t_task *pool_takeShared(void) {
+    if (atomic_load_explicit(&pool.sharedCount, memory_order_relaxed) == 0) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    t_task *task = pool.sharedHead;
+    if (task != NULL) {
+        pool.sharedHead = task->next;
+        if (pool.sharedHead == NULL) {
+            pool.sharedTail = NULL;
+        }
+        atomic_fetch_sub(&pool.sharedCount, 1);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return task;
+}
+
+
+/*
+ * Dépose des tâches : dans la pile du thread courant s'il fait partie du
+ * groupe, sinon dans la file commune. Rend le nombre de tâches déposées
+ * (une pile pleine refuse les suivantes, que l'appelant exécute lui-même).
+ */
+static int pool_submit(t_task **tasks, int count) {
+    int submitted = 0;
+
+    if (workerIndex >= 0) {
+        t_deque *deque = pool.deques[workerIndex];
+        while (submitted < count && deque_push(deque, tasks[submitted]) == 0) {
+            submitted++;
+        }
+    } else {
+        pthread_mutex_lock(&pool.lock);
+        for (; submitted < count; submitted++) {
+            tasks[submitted]->next = NULL;
+            if (pool.sharedTail != NULL) {
+                pool.sharedTail->next = tasks[submitted];
+            } else {
+                pool.sharedHead = tasks[submitted];
+            }
+            pool.sharedTail = tasks[submitted];
+        }
+        atomic_fetch_add(&pool.sharedCount, count);
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    if (submitted > 0) {
+        pool_notify();
+    }
+    return submitted;
+}
+
+
+/*
+ * Cherche une tâche : sa propre pile, puis la file commune, puis les piles
+ * des autres threads à partir d'une victime tirée au hasard
+ */
+static t_task *pool_find(void) {
+    t_task *task = NULL;
+    if (workerIndex >= 0) {
+        task = deque_pop(pool.deques[workerIndex]);
+    }
+    if (task == NULL) {
+        task = pool_takeShared();
+    }
+    if (task != NULL) {
+        return task;
+    }
+
+    int workers = atomic_load_explicit(&pool.workers, memory_order_acquire);
+    if (workers == 0) {
+        return NULL;
+    }
+    stealSeed = stealSeed * 1103515245u + 12345u;
+    int start = (int)((stealSeed >> 16) % (unsigned int)workers);
+    for (int i = 0; i < workers && task == NULL; i++) {
+        int victim = (start + i) % workers;
+        if (victim != workerIndex) {
+            task = deque_steal(pool.deques[victim]);
+        }
+    }
+    return task;
+}
+
+
+static void pool_run(t_task *task) {
+    t_task_group *group = task->group;
+
+    if (task->band != NULL) {
+        task->band(task->arg, task->begin, task->end);
+    } else {
+        task->fn(task->arg);
+    }
+    if (task->allocated) {
+        free(task);
+    }
+    // Dernier accès à la tâche : une bande vit dans la pile de l'appelant
+    atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release);
+}
+
+
+static void *pool_worker(void *param) {
+    workerIndex = (int)(intptr_t)param;
+    stealSeed = (unsigned int)workerIndex * 2654435761u + 1u;
+
+    for (;;) {
+        t_task *task = NULL;
+        unsigned int epoch = 0;
+
+        for (int round = 0; round < BMP_SPIN_ROUNDS && task == NULL; round++) {
+            epoch = atomic_load(&pool.epoch);
+            // Un thread en trop (bmp_setThreadCount réduit) ne prend plus rien
+            if (workerIndex >= atomic_load(&pool.active)) {
+                break;
+            }
+            task = pool_find();
+            if (task == NULL) {
+                sched_yield();
+            }
+        }
+
+        if (task != NULL) {
+            pool_run(task);
+            continue;
+        }
+
+        // Rien à faire : on dort jusqu'au prochain dépôt de tâches
+        pthread_mutex_lock(&pool.lock);
+        atomic_fetch_add(&pool.sleepers, 1);
+        while (workerIndex >= atomic_load(&pool.active) || atomic_load(&pool.epoch) == epoch) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        atomic_fetch_sub(&pool.sleepers, 1);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return NULL;
+}
+
+
+/*
+ * Adapte le groupe au nombre de threads voulu : crée les threads qui
+ * manquent (l'appelant compte pour un) et met les autres en veille.
+ * Rend le nombre de threads disponibles, appelant compris.
+ */
+static int pool_prepare(int threads) {
+    int wanted = threads - 1;
+
+    if (atomic_load(&pool.workers) < wanted) {
+        pthread_mutex_lock(&pool.lock);
+        int created = atomic_load(&pool.workers);
+        while (created < wanted) {
+            t_deque *deque = (t_deque *)calloc(1, sizeof(t_deque));
+            pthread_t id;
+            if (deque == NULL) {
+                break;
+            }
+            pool.deques[created] = deque;
+            if (pthread_create(&id, NULL, pool_worker, (void *)(intptr_t)created) != 0) {
+                pool.deques[created] = NULL;
+                free(deque);
+                break;
+            }
+            pthread_detach(id);
+            created++;
+            atomic_store_explicit(&pool.workers, created, memory_order_release);
+        }
+        pthread_mutex_unlock(&pool.lock);
+    }
+
+    int workers = atomic_load(&pool.workers);
+    if (workers > wanted) {
+        workers = wanted;
+    }
+    if (atomic_load(&pool.active) != workers) {
+        pthread_mutex_lock(&pool.lock);
+        atomic_store(&pool.active, workers);
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return workers + 1;
+}
+
+
+void bmp_taskGroupInit(t_task_group *group) {
+    atomic_init(&group->pending, 0);
+}
+
+
+void bmp_taskWait(t_task_group *group) {
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        t_task *task = pool_find();
+        if (task != NULL) {
+            pool_run(task);
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+
+void bmp_taskSpawn(t_task_group *group, t_task_fn fn, void *arg) {
+    if (group == NULL || fn == NULL) {
+        return;
+    }
+
+    t_task *task = NULL;
+    if (pool_prepare(bmp_threadCount()) > 1) {
+        task = (t_task *)malloc(sizeof(t_task));
+    }
+    if (task == NULL) {
+        // Pas d'autre thread (ou plus de mémoire) : exécution immédiate
+        fn(arg);
+        return;
+    }
+
+    task->band = NULL;
+    task->fn = fn;
+    task->arg = arg;
+    task->group = group;
+    task->allocated = 1;
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+
+    if (pool_submit(&task, 1) == 0) {
+        atomic_fetch_sub_explicit(&group->pending, 1, memory_order_relaxed);
+        free(task);
+        fn(arg);
+    }
+}
+
+
+void bmp_parallelFor(int count, int grain, t_band_task task, void *arg) {
+    if (count <= 0 || task == NULL) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+
+    int bands = count / grain;
+    if (bands > 1) {
+        int threads = pool_prepare(bmp_threadCount());
+        if (bands > threads * BMP_BANDS_PER_THREAD) {
+            bands = threads * BMP_BANDS_PER_THREAD;
+        }
+        if (threads <= 1) {
+            bands = 1;
+        }
+    }
+    if (bands <= 1) {
+        task(arg, 0, count);
+        return;
+    }
+
+    t_task tasks[BMP_MAX_THREADS * BMP_BANDS_PER_THREAD];
+    t_task *order[BMP_MAX_THREADS * BMP_BANDS_PER_THREAD];
+    t_task_group group;
+    bmp_taskGroupInit(&group);
+
+    for (int b = 0; b < bands; b++) {
+        tasks[b].band = task;
+        tasks[b].fn = NULL;
+        tasks[b].arg = arg;
+        tasks[b].begin = (int)((long long)count * b / bands);
+        tasks[b].end = (int)((long long)count * (b + 1) / bands);
+        tasks[b].group = &group;
+        tasks[b].allocated = 0;
+    }
+
+    // Les bandes 1..n-1 sont déposées de sorte que l'appelant les reprenne
+    // dans l'ordre (bas de sa pile) et que les voleurs prennent la fin
+    int shared = (workerIndex < 0);
+    for (int b = 1; b < bands; b++) {
+        order[b - 1] = shared ? &tasks[b] : &tasks[bands - b];
+    }
+    atomic_store_explicit(&group.pending, bands - 1, memory_order_relaxed);
+    int submitted = pool_submit(order, bands - 1);
+
+    task(arg, tasks[0].begin, tasks[0].end);
+
+    // Bandes refusées par une pile pleine : traitées ici
+    for (int b = submitted; b < bands - 1; b++) {
+        pool_run(order[b]);
+    }
+    bmp_taskWait(&group);
+}
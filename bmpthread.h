@@ -0,0 +1,91 @@
+/**
+ * @file bmpthread.h
+ *
+ * @brief
+ * Petit utilitaire de parallélisation utilisé par les traitements d'images.
+ * Tous les traitements passent par un même groupe de threads (un par cœur
+ * par défaut) qui se répartissent les tâches par vol de travail : chaque
+ * thread a sa propre pile de tâches et, quand elle est vide, prend des
+ * tâches dans celle d'un autre. Le travail d'un traitement est découpé en
+ * bandes de lignes ; une tâche peut elle-même lancer des bandes (un lot de
+ * fichiers dont chaque filtre est parallèle), sans jamais créer plus de
+ * threads que de cœurs.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPTHREAD_H
+#define BMPTHREAD_H
+
+#include <stdatomic.h>
+
+/*
+ * Fonction appelée sur une bande [begin, end[ du travail
+ *   arg   - Contexte propre au traitement
+ *   begin - Premier indice de la bande (inclus)
+ *   end   - Dernier indice de la bande (exclu)
+ */
+typedef void (*t_band_task)(void *arg, int begin, int end);
+
+/*
+ * Fonction d'une tâche isolée (bmp_taskSpawn)
+ */
+typedef void (*t_task_fn)(void *arg);
+
+/*
+ * Groupe de tâches dont on attend la fin ensemble
+ */
+typedef struct {
+    atomic_int pending;     // Tâches lancées et pas encore terminées
+} t_task_group;
+
+/* bmp_threadCount
+ * Rôle : Donne le nombre de threads utilisés pour les traitements
+ * Retour : Valeur fixée par bmp_setThreadCount, sinon la variable
+ *          d'environnement BMP_THREADS, sinon le nombre de cœurs
+ */
+int bmp_threadCount(void);
+
+/* bmp_setThreadCount
+ * Rôle : Force le nombre de threads (0 = retour au réglage automatique)
+ */
+void bmp_setThreadCount(int count);
+
+/* bmp_parallelFor
+ * Rôle : Exécute task sur l'intervalle [0, count[ découpé en bandes
+ * Paramètres :
+ *   count - Nombre total d'éléments (en général des lignes)
+ *   grain - Taille minimale d'une bande (en dessous on ne parallélise pas)
+ *   task  - Fonction à appeler pour chaque bande
+ *   arg   - Contexte transmis à task
+ * Note : La fonction ne rend la main que lorsque toutes les bandes sont
+ *        traitées ; en attendant, le thread appelant traite lui-même des
+ *        bandes (les siennes ou celles d'autres traitements en cours)
+ */
+void bmp_parallelFor(int count, int grain, t_band_task task, void *arg);
+
+/* bmp_taskGroupInit
+ * Rôle : Prépare un groupe de tâches vide
+ */
+void bmp_taskGroupInit(t_task_group *group);
+
+/* bmp_taskSpawn
+ * Rôle : Lance une tâche dans un groupe, exécutée par l'un des threads
+ * Paramètres :
+ *   group - Groupe de la tâche
+ *   fn    - Fonction à exécuter
+ *   arg   - Contexte transmis à fn (doit rester valide jusqu'à bmp_taskWait)
+ * Note : La tâche peut appeler bmp_parallelFor : ses bandes seront prises par
+ *        les threads inoccupés. Sans thread disponible, fn est exécutée
+ *        immédiatement par l'appelant.
+ */
+void bmp_taskSpawn(t_task_group *group, t_task_fn fn, void *arg);
+
+/* bmp_taskWait
+ * Rôle : Attend la fin de toutes les tâches du groupe, en participant au
+ *        travail en attendant
+ */
+void bmp_taskWait(t_task_group *group);
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * @file bmpthreshold.c
+ *
+ * @brief
+ * Seuillage automatique. Le seuil global est déduit de l'histogramme
+ * (première lecture de l'image), puis appliqué par une table de
+ * correspondance de 256 valeurs (deuxième et dernière lecture).
+ * Le seuillage adaptatif s'appuie sur des images intégrales de la somme
+ * et de la somme des carrés, d'où un coût constant par pixel.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpthreshold.h"
+#include "bmphistogram.h"
+#include "bmpintegral.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define THRESHOLD_GRAIN 64
+
+typedef struct {
+    unsigned char **rows;
+    int width;
+    int height;
+    int radius;
+    t_adaptive_method method;
+    double k;
+    const t_integral *integral;
+} t_adaptive_pass;
+
+
+int bmp_otsuThreshold(const uint32_t hist[256]) {
+    double total = 0.0, sum = 0.0;
+    for (int v = 0; v < 256; v++) {
+        total += hist[v];
+        sum += (double)v * hist[v];
+    }
+
+    double weightBack = 0.0, sumBack = 0.0, best = -1.0;
+    int threshold = 0;
+
+    for (int t = 0; t < 256; t++) {
+        weightBack += hist[t];
+        if (weightBack == 0.0) {
+            continue;
+        }
+        double weightFore = total - weightBack;
+        if (weightFore == 0.0) {
+            break;
+        }
+
+        sumBack += (double)t * hist[t];
+        double meanBack = sumBack / weightBack;
+        double meanFore = (sum - sumBack) / weightFore;
+        double between = weightBack * weightFore * (meanBack - meanFore) * (meanBack - meanFore);
+
+        if (between > best) {
+            best = between;
+            threshold = t;
+        }
+    }
+
+    return threshold;
+}
+
+
+int bmp_triangleThreshold(const uint32_t hist[256]) {
+    int first = 0, last = 255, peak = 0;
+
+    while (first < 255 && hist[first] == 0) {
+        first++;
+    }
+    while (last > 0 && hist[last] == 0) {
+        last--;
+    }
+    for (int v = 0; v < 256; v++) {
+        if (hist[v] > hist[peak]) {
+            peak = v;
+        }
+    }
+    if (first >= last) {
+        return first;
+    }
+
+    // Droite entre le sommet du pic et l'extrémité la plus éloignée
+    int end = (last - peak > peak - first) ? last : first;
+    double dx = end - peak;
+    double dy = -(double)hist[peak];
+    int step = (end > peak) ? 1 : -1;
+    int threshold = peak;
+    double best = -1.0;
+
+    for (int v = peak; v != end; v += step) {
+        double distance = fabs(dy * (v - peak) - dx * ((double)hist[v] - hist[peak]));
+        if (distance > best) {
+            best = distance;
+            threshold = v;
+        }
+    }
+
+    // Pic sombre : le seuil est le dernier niveau du fond, pic clair : le premier
+    return (step > 0) ? threshold : threshold - 1;
+}
+
+
+/*
+ * Recherche exhaustive des seuils : on maximise la somme des S²/P des
+ * classes (équivalent à maximiser la variance inter-classes)
+ */
+static void multiotsu_search(const double *between, int start, int level, int classes,
+                             double acc, int *current, double *best, int *bestThresholds) {
+    if (level == classes - 1) {
+        double total = acc + between[start * 256 + 255];
+        if (total > *best) {
+            *best = total;
+            memcpy(bestThresholds, current, (classes - 1) * sizeof(int));
+        }
+        return;
+    }
+
+    for (int t = start; t <= 255 - (classes - 1 - level); t++) {
+        current[level] = t;
+        multiotsu_search(between, t + 1, level + 1, classes, acc + between[start * 256 + t],
+                         current, best, bestThresholds);
+    }
+}
+
+
+int bmp_multiOtsuThresholds(const uint32_t hist[256], int classes, int *thresholds) {
+    if (hist == NULL || thresholds == NULL || classes < 2 || classes > BMP_MAX_CLASSES) {
+        fprintf(stderr, "Erreur: Nombre de classes invalide (2 à %d)\n", BMP_MAX_CLASSES);
+        return -1;
+    }
+
+    double *between = (double *)malloc(256 * 256 * sizeof(double));
+    if (between == NULL) {
+        perror("Erreur: Allocation mémoire échouée");
+        return -1;
+    }
+
+    // between[a * 256 + b] = S(a..b)² / P(a..b)
+    for (int a = 0; a < 256; a++) {
+        double p = 0.0, s = 0.0;
+        for (int b = a; b < 256; b++) {
+            p += hist[b];
+            s += (double)b * hist[b];
+            between[a * 256 + b] = (p > 0.0) ? s * s / p : 0.0;
+        }
+    }
+
+    int current[BMP_MAX_CLASSES];
+    double best = -1.0;
+    multiotsu_search(between, 0, 0, classes, 0.0, current, &best, thresholds);
+
+    free(between);
+    return 0;
+}
+
+
+int bmp8_autoThreshold(t_bmp8 *img, t_threshold_method method) {
+    uint32_t hist[256];
+    if (bmp8_histogram(img, hist) != 0) {
+        return -1;
+    }
+
+    int threshold = (method == BMP_THRESHOLD_TRIANGLE) ? bmp_triangleThreshold(hist) : bmp_otsuThreshold(hist);
+
+    uint8_t lut[256];
+    for (int v = 0; v < 256; v++) {
+        lut[v] = (v > threshold) ? 255 : 0;
+    }
+
+    return (bmp8_applyLut(img, lut) == 0) ? threshold : -1;
+}
+
+
+int bmp8_multiThreshold(t_bmp8 *img, int classes) {
+    uint32_t hist[256];
+    int thresholds[BMP_MAX_CLASSES];
+
+    if (bmp8_histogram(img, hist) != 0 || bmp_multiOtsuThresholds(hist, classes, thresholds) != 0) {
+        return -1;
+    }
+
+    uint8_t lut[256];
+    int c = 0;
+    for (int v = 0; v < 256; v++) {
+        while (c < classes - 1 && v > thresholds[c]) {
+            c++;
+        }
+        lut[v] = (uint8_t)(c * 255 / (classes - 1));
+    }
+
+    return bmp8_applyLut(img, lut);
+}
+
+
+static void threshold_adaptiveBand(void *arg, int begin, int end) {
+    const t_adaptive_pass *pass = (const t_adaptive_pass *)arg;
+    int w1 = pass->width + 1;
+
+    for (int y = begin; y < end; y++) {
+        int y0 = (y - pass->radius < 0) ? 0 : y - pass->radius;
+        int y1 = (y + pass->radius + 1 > pass->height) ? pass->height : y + pass->radius + 1;
+        const uint64_t *sTop = pass->integral->sum + (size_t)y0 * w1;
+        const uint64_t *sBottom = pass->integral->sum + (size_t)y1 * w1;
+        const uint64_t *qTop = pass->integral->sqsum + (size_t)y0 * w1;
+        const uint64_t *qBottom = pass->integral->sqsum + (size_t)y1 * w1;
+        unsigned char *row = pass->rows[y];
+
+        for (int x = 0; x < pass->width; x++) {
+            int x0 = (x - pass->radius < 0) ? 0 : x - pass->radius;
+            int x1 = (x + pass->radius + 1 > pass->width) ? pass->width : x + pass->radius + 1;
+            double count = (double)(x1 - x0) * (y1 - y0);
+            double mean = (double)(sBottom[x1] - sBottom[x0] - sTop[x1] + sTop[x0]) / count;
+            double threshold;
+
+            if (pass->method == BMP_ADAPTIVE_SAUVOLA) {
+                double sq = (double)(qBottom[x1] - qBottom[x0] - qTop[x1] + qTop[x0]) / count;
+                double variance = sq - mean * mean;
+                double deviation = (variance > 0.0) ? sqrt(variance) : 0.0;
+                threshold = mean * (1.0 + pass->k * (deviation / 128.0 - 1.0));
+            } else {
+                threshold = mean * (1.0 - pass->k);
+            }
+
+            row[x] = (row[x] > threshold) ? 255 : 0;
+        }
+    }
+}
+
+
+int bmp8_adaptiveThreshold(t_bmp8 *img, int radius, t_adaptive_method method, double k) {
+    if (img == NULL || img->data == NULL || radius < 1) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    if (rows == NULL) {
+        return -1;
+    }
+
+    // La fenêtre est symétrique : l'ordre des lignes en mémoire convient
+    t_integral *integral = bmp_integralFromRows((const uint8_t *const *)rows, img->width, img->height, 1);
+    if (integral == NULL) {
+        free(rows);
+        return -1;
+    }
+
+    // Les intégrales sont complètes : on peut binariser sur place
+    t_adaptive_pass pass = {rows, img->width, img->height, radius, method, k, integral};
+    bmp_parallelFor(img->height, THRESHOLD_GRAIN, threshold_adaptiveBand, &pass);
+
+    free(rows);
+    bmp_integralFree(integral);
+    return 0;
+}
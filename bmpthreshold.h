@@ -0,0 +1,88 @@
+/**
+ * @file bmpthreshold.h
+ *
+ * @brief
+ * Choix automatique du seuil de binarisation des images 8 bits, à partir de
+ * l'histogramme (Otsu, triangle, Otsu multi-niveaux), et seuillage adaptatif
+ * local (moyenne locale ou Sauvola) pour les documents mal éclairés.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPTHRESHOLD_H
+#define BMPTHRESHOLD_H
+
+#include <stdint.h>
+#include "bmp8.h"
+
+/* Nombre maximal de classes pour l'Otsu multi-niveaux */
+#define BMP_MAX_CLASSES 4
+
+/*
+ * Méthodes de calcul d'un seuil global
+ */
+typedef enum {
+    BMP_THRESHOLD_OTSU,     // Maximise la variance entre les deux classes
+    BMP_THRESHOLD_TRIANGLE  // Adapté aux histogrammes avec un seul grand pic
+} t_threshold_method;
+
+/*
+ * Méthodes de seuillage adaptatif (seuil calculé autour de chaque pixel)
+ */
+typedef enum {
+    BMP_ADAPTIVE_MEAN,      // Seuil = moyenne locale * (1 - k)
+    BMP_ADAPTIVE_SAUVOLA    // Seuil = moyenne * (1 + k * (écart-type / 128 - 1))
+} t_adaptive_method;
+
+/* bmp_otsuThreshold / bmp_triangleThreshold
+ * Rôle : Calcule un seuil à partir d'un histogramme de 256 cases
+ * Retour : Seuil t : les pixels > t passent à 255, les autres à 0
+ */
+int bmp_otsuThreshold(const uint32_t hist[256]);
+int bmp_triangleThreshold(const uint32_t hist[256]);
+
+/* bmp_multiOtsuThresholds
+ * Rôle : Calcule les seuils qui séparent l'histogramme en plusieurs classes
+ * Paramètres :
+ *   hist       - Histogramme de 256 cases
+ *   classes    - Nombre de classes (2 à BMP_MAX_CLASSES)
+ *   thresholds - Reçoit classes - 1 seuils croissants
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_multiOtsuThresholds(const uint32_t hist[256], int classes, int *thresholds);
+
+/* bmp8_autoThreshold
+ * Rôle : Calcule le seuil automatiquement puis binarise l'image
+ * Paramètres :
+ *   img    - Image à modifier
+ *   method - Méthode de choix du seuil
+ * Retour : Seuil utilisé (pixels > seuil -> 255), -1 si erreur
+ * Note : L'image n'est lue que deux fois (histogramme puis binarisation)
+ */
+int bmp8_autoThreshold(t_bmp8 *img, t_threshold_method method);
+
+/* bmp8_multiThreshold
+ * Rôle : Réduit l'image à quelques niveaux de gris régulièrement espacés
+ *        (0, 127, 255 pour 3 classes...) avec des seuils d'Otsu
+ * Paramètres :
+ *   img     - Image à modifier
+ *   classes - Nombre de niveaux (2 à BMP_MAX_CLASSES)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp8_multiThreshold(t_bmp8 *img, int classes);
+
+/* bmp8_adaptiveThreshold
+ * Rôle : Binarise chaque pixel selon les statistiques de son voisinage
+ * Paramètres :
+ *   img    - Image à modifier
+ *   radius - Rayon de la fenêtre carrée ((2 * radius + 1)² pixels)
+ *   method - Moyenne locale ou Sauvola
+ *   k      - Sensibilité (environ 0.15 pour la moyenne, 0.3 pour Sauvola)
+ * Retour : 0 si réussi, -1 si erreur
+ * Note : Les sommes locales viennent d'images intégrales, le coût par pixel
+ *        ne dépend pas du rayon
+ */
+int bmp8_adaptiveThreshold(t_bmp8 *img, int radius, t_adaptive_method method, double k);
+
+#endif
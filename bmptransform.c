@@ -0,0 +1,513 @@
+/**
+ * @file bmptransform.c
+ *
+ * @brief
+ * Rotations, miroirs et transposition. La transposition parcourt l'image
+ * par tuiles de 64x64 pixels pour que les lignes source et destination
+ * touchées restent en cache ; à l'intérieur d'une tuile, les images 8 bits
+ * sont transposées par blocs 8x8 directement dans les registres SSE2.
+ * Les miroirs et le demi-tour se font sur place, ligne par ligne.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmptransform.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define TRANSFORM_TILE 64
+#define TRANSFORM_GRAIN 8
+
+typedef struct {
+    const uint8_t *const *src;
+    uint8_t *const *dst;
+    int width;
+    int height;
+    int elemSize;
+} t_transpose_pass;
+
+typedef struct {
+    uint8_t **rows;
+    int width;
+    int height;
+    int elemSize;
+} t_flip_pass;
+
+
+/*
+ * Transpose un bloc 8x8 d'octets : les 8 lignes à partir de (x, y)
+ * deviennent les colonnes y..y+7 des lignes x..x+7 de la destination
+ */
+static inline void transpose_block8x8(const uint8_t *const *src, int x, int y, uint8_t *const *dst) {
+#ifdef __SSE2__
+    __m128i r0 = _mm_loadl_epi64((const __m128i *)(src[y] + x));
+    __m128i r1 = _mm_loadl_epi64((const __m128i *)(src[y + 1] + x));
+    __m128i r2 = _mm_loadl_epi64((const __m128i *)(src[y + 2] + x));
+    __m128i r3 = _mm_loadl_epi64((const __m128i *)(src[y + 3] + x));
+    __m128i r4 = _mm_loadl_epi64((const __m128i *)(src[y + 4] + x));
+    __m128i r5 = _mm_loadl_epi64((const __m128i *)(src[y + 5] + x));
+    __m128i r6 = _mm_loadl_epi64((const __m128i *)(src[y + 6] + x));
+    __m128i r7 = _mm_loadl_epi64((const __m128i *)(src[y + 7] + x));
+
+    // Entrelacement 8 bits, puis 16 bits, puis 32 bits
+    __m128i a0 = _mm_unpacklo_epi8(r0, r1);
+    __m128i a1 = _mm_unpacklo_epi8(r2, r3);
+    __m128i a2 = _mm_unpacklo_epi8(r4, r5);
+    __m128i a3 = _mm_unpacklo_epi8(r6, r7);
+
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+
+    __m128i c0 = _mm_unpacklo_epi32(b0, b2); // colonnes 0 et 1
+    __m128i c1 = _mm_unpackhi_epi32(b0, b2); // colonnes 2 et 3
+    __m128i c2 = _mm_unpacklo_epi32(b1, b3); // colonnes 4 et 5
+    __m128i c3 = _mm_unpackhi_epi32(b1, b3); // colonnes 6 et 7
+
+    _mm_storel_epi64((__m128i *)(dst[x] + y), c0);
+    _mm_storel_epi64((__m128i *)(dst[x + 1] + y), _mm_srli_si128(c0, 8));
+    _mm_storel_epi64((__m128i *)(dst[x + 2] + y), c1);
+    _mm_storel_epi64((__m128i *)(dst[x + 3] + y), _mm_srli_si128(c1, 8));
+    _mm_storel_epi64((__m128i *)(dst[x + 4] + y), c2);
+    _mm_storel_epi64((__m128i *)(dst[x + 5] + y), _mm_srli_si128(c2, 8));
+    _mm_storel_epi64((__m128i *)(dst[x + 6] + y), c3);
+    _mm_storel_epi64((__m128i *)(dst[x + 7] + y), _mm_srli_si128(c3, 8));
+#else
+    for (int j = 0; j < 8; j++) {
+        for (int i = 0; i < 8; i++) {
+            dst[x + i][y + j] = src[y + j][x + i];
+        }
+    }
+#endif
+}
+
+
+/*
+ * Transposition simple d'un rectangle ; elemSize est une constante
+ * une fois inlinée, la copie d'un pixel devient donc un simple mouvement
+ */
+static inline void transpose_rect(const uint8_t *const *src, uint8_t *const *dst,
+                                  int x0, int x1, int y0, int y1, const int elemSize) {
+    for (int x = x0; x < x1; x++) {
+        uint8_t *out = dst[x];
+        for (int y = y0; y < y1; y++) {
+            memcpy(out + (size_t)y * elemSize, src[y] + (size_t)x * elemSize, elemSize);
+        }
+    }
+}
+
+
+static void transpose_tile(const t_transpose_pass *pass, int x0, int x1, int y0, int y1) {
+    switch (pass->elemSize) {
+        case 1: {
+            int xa = x0 + ((x1 - x0) & ~7);
+            int ya = y0 + ((y1 - y0) & ~7);
+            for (int y = y0; y < ya; y += 8) {
+                for (int x = x0; x < xa; x += 8) {
+                    transpose_block8x8(pass->src, x, y, pass->dst);
+                }
+            }
+            // Bords de la tuile qui ne forment pas un bloc 8x8 complet
+            transpose_rect(pass->src, pass->dst, xa, x1, y0, y1, 1);
+            transpose_rect(pass->src, pass->dst, x0, xa, ya, y1, 1);
+            break;
+        }
+        case 3:
+            transpose_rect(pass->src, pass->dst, x0, x1, y0, y1, 3);
+            break;
+        case 4:
+            transpose_rect(pass->src, pass->dst, x0, x1, y0, y1, 4);
+            break;
+        default:
+            transpose_rect(pass->src, pass->dst, x0, x1, y0, y1, pass->elemSize);
+            break;
+    }
+}
+
+
+/* Une bande = un groupe de colonnes de tuiles (donc de lignes destination) */
+static void transpose_band(void *arg, int begin, int end) {
+    const t_transpose_pass *pass = (const t_transpose_pass *)arg;
+
+    for (int tx = begin; tx < end; tx++) {
+        int x0 = tx * TRANSFORM_TILE;
+        int x1 = (x0 + TRANSFORM_TILE < pass->width) ? x0 + TRANSFORM_TILE : pass->width;
+
+        for (int y0 = 0; y0 < pass->height; y0 += TRANSFORM_TILE) {
+            int y1 = (y0 + TRANSFORM_TILE < pass->height) ? y0 + TRANSFORM_TILE : pass->height;
+            transpose_tile(pass, x0, x1, y0, y1);
+        }
+    }
+}
+
+
+int bmp_transposeRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                      uint8_t *const *dstRows, int elemSize) {
+    if (srcRows == NULL || dstRows == NULL || srcWidth <= 0 || srcHeight <= 0 || elemSize <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    t_transpose_pass pass = {srcRows, dstRows, srcWidth, srcHeight, elemSize};
+    int tiles = (srcWidth + TRANSFORM_TILE - 1) / TRANSFORM_TILE;
+    bmp_parallelFor(tiles, 1, transpose_band, &pass);
+    return 0;
+}
+
+
+/*
+ * Échange deux pixels de elemSize octets
+ */
+static inline void flip_swap(uint8_t *a, uint8_t *b, int elemSize) {
+    for (int k = 0; k < elemSize; k++) {
+        uint8_t t = a[k];
+        a[k] = b[k];
+        b[k] = t;
+    }
+}
+
+
+static void flip_reverseRow(uint8_t *row, int width, int elemSize) {
+    uint8_t *left = row;
+    uint8_t *right = row + (size_t)(width - 1) * elemSize;
+
+    while (left < right) {
+        flip_swap(left, right, elemSize);
+        left += elemSize;
+        right -= elemSize;
+    }
+}
+
+
+static void flip_horizontalBand(void *arg, int begin, int end) {
+    const t_flip_pass *pass = (const t_flip_pass *)arg;
+
+    for (int y = begin; y < end; y++) {
+        flip_reverseRow(pass->rows[y], pass->width, pass->elemSize);
+    }
+}
+
+
+/* Échange le contenu des lignes y et height-1-y pour y dans la bande */
+static void flip_verticalBand(void *arg, int begin, int end) {
+    const t_flip_pass *pass = (const t_flip_pass *)arg;
+    size_t length = (size_t)pass->width * pass->elemSize;
+
+    for (int y = begin; y < end; y++) {
+        uint8_t *a = pass->rows[y];
+        uint8_t *b = pass->rows[pass->height - 1 - y];
+        for (size_t i = 0; i < length; i++) {
+            uint8_t t = a[i];
+            a[i] = b[i];
+            b[i] = t;
+        }
+    }
+}
+
+
+/* Demi-tour : le pixel (x, y) s'échange avec (width-1-x, height-1-y) */
+static void flip_rotate180Band(void *arg, int begin, int end) {
+    const t_flip_pass *pass = (const t_flip_pass *)arg;
+    int es = pass->elemSize;
+
+    for (int y = begin; y < end; y++) {
+        int opposite = pass->height - 1 - y;
+        if (opposite == y) {
+            flip_reverseRow(pass->rows[y], pass->width, es);
+            continue;
+        }
+
+        uint8_t *a = pass->rows[y];
+        uint8_t *b = pass->rows[opposite] + (size_t)(pass->width - 1) * es;
+        for (int x = 0; x < pass->width; x++) {
+            flip_swap(a, b, es);
+            a += es;
+            b -= es;
+        }
+    }
+}
+
+
+static void flip_rows(uint8_t **rows, int width, int height, int elemSize, t_band_task task, int count) {
+    if (rows == NULL) {
+        return;
+    }
+
+    t_flip_pass pass = {rows, width, height, elemSize};
+    bmp_parallelFor(count, TRANSFORM_GRAIN, task, &pass);
+}
+
+
+/*
+ * Rotation de 90 (sens horaire) ou 270 degrés sur des lignes stockées de
+ * haut en bas : c'est une transposition dont on inverse l'ordre des lignes
+ * source (90) ou des lignes destination (270)
+ */
+static int rotate_rows(uint8_t **src, int width, int height, uint8_t **dst, int elemSize, int clockwise) {
+    uint8_t **reversed = (uint8_t **)malloc((clockwise ? height : width) * sizeof(uint8_t *));
+    if (reversed == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour la rotation\n");
+        return -1;
+    }
+
+    int status;
+    if (clockwise) {
+        for (int y = 0; y < height; y++) {
+            reversed[y] = src[height - 1 - y];
+        }
+        status = bmp_transposeRows((const uint8_t *const *)reversed, width, height, dst, elemSize);
+    } else {
+        for (int x = 0; x < width; x++) {
+            reversed[x] = dst[width - 1 - x];
+        }
+        status = bmp_transposeRows((const uint8_t *const *)src, width, height, reversed, elemSize);
+    }
+
+    free(reversed);
+    return status;
+}
+
+
+t_bmp8 *bmp8_rotate(t_bmp8 *img, int angle) {
+    if (img == NULL || img->data == NULL || (angle != 90 && angle != 180 && angle != 270)) {
+        fprintf(stderr, "Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    int quarter = (angle != 180);
+    t_bmp8 *result = quarter ? bmp8_allocate(img->height, img->width) : bmp8_allocate(img->width, img->height);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    memcpy(result->colorTable, img->colorTable, BMP_COLOR_TABLE_SIZE);
+    if (quarter) {
+        memcpy(&result->header[38], &img->header[42], 4);
+        memcpy(&result->header[42], &img->header[38], 4);
+    } else {
+        memcpy(&result->header[38], &img->header[38], 8);
+        for (uint32_t y = 0; y < img->height; y++) {
+            memcpy(bmp8_row(result, y), bmp8_row(img, y), img->width);
+        }
+        bmp8_rotate180(result);
+        return result;
+    }
+
+    unsigned char **src = bmp8_getTopDownRows(img);
+    unsigned char **dst = bmp8_getTopDownRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = rotate_rows(src, img->width, img->height, dst, 1, angle == 90);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp8_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+
+t_bmp24 *bmp24_rotate(t_bmp24 *img, int angle) {
+    if (img == NULL || img->data == NULL || (angle != 90 && angle != 180 && angle != 270)) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    int quarter = (angle != 180);
+    t_bmp24 *result = quarter ? bmp24_allocate(img->height, img->width, img->colorDepth)
+                              : bmp24_allocate(img->width, img->height, img->colorDepth);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    if (quarter) {
+        result->header_info.xPixelsPerMeter = img->header_info.yPixelsPerMeter;
+        result->header_info.yPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    } else {
+        result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+        result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+        for (int y = 0; y < img->height; y++) {
+            memcpy(result->data[y], img->data[y], img->width * sizeof(t_pixel));
+        }
+        bmp24_rotate180(result);
+        return result;
+    }
+
+    uint8_t **src = bmp24_getRows(img);
+    uint8_t **dst = bmp24_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = rotate_rows(src, img->width, img->height, dst, sizeof(t_pixel), angle == 90);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp24_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+
+t_bmp32 *bmp32_rotate(t_bmp32 *img, int angle) {
+    if (img == NULL || img->data == NULL || (angle != 90 && angle != 180 && angle != 270)) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+
+    int quarter = (angle != 180);
+    t_bmp32 *result = quarter ? bmp32_allocate(img->height, img->width)
+                              : bmp32_allocate(img->width, img->height);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    if (quarter) {
+        result->header_info.xPixelsPerMeter = img->header_info.yPixelsPerMeter;
+        result->header_info.yPixelsPerMeter = img->header_info.xPixelsPerMeter;
+    } else {
+        result->header_info.xPixelsPerMeter = img->header_info.xPixelsPerMeter;
+        result->header_info.yPixelsPerMeter = img->header_info.yPixelsPerMeter;
+        memcpy(result->data[0], img->data[0], (size_t)img->width * img->height * sizeof(t_pixel32));
+        bmp32_rotate180(result);
+        return result;
+    }
+
+    uint8_t **src = bmp32_getRows(img);
+    uint8_t **dst = bmp32_getRows(result);
+    int status = -1;
+
+    if (src != NULL && dst != NULL) {
+        status = rotate_rows(src, img->width, img->height, dst, sizeof(t_pixel32), angle == 90);
+    }
+
+    free(src);
+    free(dst);
+    if (status != 0) {
+        bmp32_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+
+void bmp8_rotate180(t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    flip_rows(rows, img->width, img->height, 1, flip_rotate180Band, (img->height + 1) / 2);
+    free(rows);
+}
+
+
+void bmp8_flipHorizontal(t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    flip_rows(rows, img->width, img->height, 1, flip_horizontalBand, img->height);
+    free(rows);
+}
+
+
+void bmp8_flipVertical(t_bmp8 *img) {
+    if (img == NULL || img->data == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return;
+    }
+
+    unsigned char **rows = bmp8_getRows(img);
+    flip_rows(rows, img->width, img->height, 1, flip_verticalBand, img->height / 2);
+    free(rows);
+}
+
+
+void bmp24_rotate180(t_bmp24 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel), flip_rotate180Band, (img->height + 1) / 2);
+    free(rows);
+}
+
+
+void bmp24_flipHorizontal(t_bmp24 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel), flip_horizontalBand, img->height);
+    free(rows);
+}
+
+
+void bmp24_flipVertical(t_bmp24 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp24_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel), flip_verticalBand, img->height / 2);
+    free(rows);
+}
+
+
+void bmp32_rotate180(t_bmp32 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp32_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel32), flip_rotate180Band, (img->height + 1) / 2);
+    free(rows);
+}
+
+
+void bmp32_flipHorizontal(t_bmp32 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp32_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel32), flip_horizontalBand, img->height);
+    free(rows);
+}
+
+
+void bmp32_flipVertical(t_bmp32 *img) {
+    if (img == NULL || img->data == NULL) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    uint8_t **rows = bmp32_getRows(img);
+    flip_rows(rows, img->width, img->height, sizeof(t_pixel32), flip_verticalBand, img->height / 2);
+    free(rows);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file bmptransform.h
+ *
+ * @brief
+ * Transformations géométriques des images BMP 8, 24 et 32 bits : rotations
+ * de 90, 180 et 270 degrés, miroirs horizontal et vertical, transposition.
+ * Les rotations de 90/270 degrés passent par une transposition par blocs
+ * pour rester efficaces sur les grandes images.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPTRANSFORM_H
+#define BMPTRANSFORM_H
+
+#include <stdint.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmp32.h"
+
+/* bmp_transposeRows
+ * Rôle : Transpose une image donnée par ses lignes : dst[x][y] = src[y][x]
+ * Paramètres :
+ *   srcRows   - Lignes source
+ *   srcWidth  - Largeur source en pixels
+ *   srcHeight - Hauteur source
+ *   dstRows   - srcWidth lignes destination de srcHeight pixels chacune
+ *   elemSize  - Nombre d'octets par pixel (1, 3 ou 4)
+ * Retour : 0 si réussi, -1 si erreur
+ * Méthode : Parcours par tuiles (blocs 8x8 transposés en registres pour 1 octet)
+ * Note : Inverser l'ordre des pointeurs de lignes source ou destination
+ *        donne directement les rotations de 90 et 270 degrés
+ */
+int bmp_transposeRows(const uint8_t *const *srcRows, int srcWidth, int srcHeight,
+                      uint8_t *const *dstRows, int elemSize);
+
+/* bmp8_rotate / bmp24_rotate / bmp32_rotate
+ * Rôle : Crée une copie tournée de l'image
+ * Paramètres :
+ *   img   - Image source (non modifiée)
+ *   angle - 90, 180 ou 270 (sens des aiguilles d'une montre)
+ * Retour : Nouvelle image ou NULL si erreur
+ */
+t_bmp8 *bmp8_rotate(t_bmp8 *img, int angle);
+t_bmp24 *bmp24_rotate(t_bmp24 *img, int angle);
+t_bmp32 *bmp32_rotate(t_bmp32 *img, int angle);
+
+/* Transformations sur place (l'image garde ses dimensions) */
+void bmp8_rotate180(t_bmp8 *img);        // Demi-tour
+void bmp8_flipHorizontal(t_bmp8 *img);   // Miroir gauche/droite
+void bmp8_flipVertical(t_bmp8 *img);     // Miroir haut/bas
+void bmp24_rotate180(t_bmp24 *img);
+void bmp24_flipHorizontal(t_bmp24 *img);
+void bmp24_flipVertical(t_bmp24 *img);
+void bmp32_rotate180(t_bmp32 *img);
+void bmp32_flipHorizontal(t_bmp32 *img);
+void bmp32_flipVertical(t_bmp32 *img);
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file bmpview.c
+ *
+ * @brief
+ * Une vue se réduit à une adresse et un pas : la ligne y commence à
+ * base + y * stride. Découper une zone déplace seulement base, ce qui
+ * rend les sous-vues gratuites. Les images 8 bits rangées de bas en haut
+ * ont un pas négatif, ce qui garde la ligne 0 en haut pour tous les types.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpview.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const t_bmp_view *view;
+    int tileWidth;
+    int tileHeight;
+    t_view_task task;
+    void *arg;
+} t_view_pass;
+
+
+static inline uint8_t *view_row(const t_bmp_view *view, int y) {
+    return view->base + (ptrdiff_t)y * view->stride;
+}
+
+
+static int view_isValid(const t_bmp_view *view) {
+    return view != NULL && view->base != NULL && view->width > 0 && view->height > 0 &&
+           (view->channels == 1 || view->channels == 3 || view->channels == 4);
+}
+
+
+int bmp8_view(t_bmp8 *img, t_bmp_view *view) {
+    if (img == NULL || img->data == NULL || view == NULL) {
+        fprintf(stderr, "Erreur: Image invalide\n");
+        return -1;
+    }
+
+    ptrdiff_t stride = (ptrdiff_t)img->width + img->rowPadding;
+    view->base = img->data;
+    view->stride = stride;
+    if (!img->topDown) {
+        // Ligne du haut en fin de tampon : on remonte le tampon
+        view->base = img->data + (size_t)(img->height - 1) * (size_t)stride;
+        view->stride = -stride;
+    }
+    view->width = (int)img->width;
+    view->height = (int)img->height;
+    view->channels = 1;
+    return 0;
+}
+
+
+int bmp24_view(t_bmp24 *img, t_bmp_view *view) {
+    if (img == NULL || img->data == NULL || view == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    // Les lignes sont dans un seul bloc, sans padding
+    view->base = (uint8_t *)img->data[0];
+    view->width = img->width;
+    view->height = img->height;
+    view->stride = (ptrdiff_t)img->width * 3;
+    view->channels = 3;
+    return 0;
+}
+
+
+int bmp32_view(t_bmp32 *img, t_bmp_view *view) {
+    if (img == NULL || img->data == NULL || view == NULL) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    view->base = (uint8_t *)img->data[0];
+    view->width = img->width;
+    view->height = img->height;
+    view->stride = (ptrdiff_t)img->width * 4;
+    view->channels = 4;
+    return 0;
+}
+
+
+int bmp_subView(const t_bmp_view *view, int x, int y, int width, int height, t_bmp_view *sub) {
+    if (!view_isValid(view) || sub == NULL || width <= 0 || height <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = (x + width > view->width) ? view->width : x + width;
+    int y1 = (y + height > view->height) ? view->height : y + height;
+    if (x1 <= x0 || y1 <= y0) {
+        printf("Erreur: La zone est hors de l'image\n");
+        return -1;
+    }
+
+    sub->base = view_row(view, y0) + (size_t)x0 * view->channels;
+    sub->width = x1 - x0;
+    sub->height = y1 - y0;
+    sub->stride = view->stride;
+    sub->channels = view->channels;
+    return 0;
+}
+
+
+uint8_t *bmp_viewRow(const t_bmp_view *view, int y) {
+    return view_row(view, y);
+}
+
+
+uint8_t **bmp_viewRows(const t_bmp_view *view) {
+    if (!view_isValid(view)) {
+        printf("Erreur: Vue invalide\n");
+        return NULL;
+    }
+
+    uint8_t **rows = (uint8_t **)malloc((size_t)view->height * sizeof(uint8_t *));
+    if (rows == NULL) {
+        printf("Erreur: Impossible d'allouer de la mémoire pour les lignes\n");
+        return NULL;
+    }
+
+    for (int y = 0; y < view->height; y++) {
+        rows[y] = view_row(view, y);
+    }
+    return rows;
+}
+
+
+int bmp_viewCopy(const t_bmp_view *dst, const t_bmp_view *src) {
+    if (!view_isValid(dst) || !view_isValid(src) || dst->width != src->width ||
+        dst->height != src->height || dst->channels != src->channels) {
+        printf("Erreur: Les vues doivent avoir les mêmes dimensions\n");
+        return -1;
+    }
+
+    size_t span = (size_t)src->width * src->channels;
+    for (int y = 0; y < src->height; y++) {
+        memcpy(view_row(dst, y), view_row(src, y), span);
+    }
+    return 0;
+}
+
+
+int bmp_viewTileCount(const t_bmp_view *view, int tileWidth, int tileHeight) {
+    if (!view_isValid(view) || tileWidth <= 0 || tileHeight <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    int columns = (view->width + tileWidth - 1) / tileWidth;
+    int rows = (view->height + tileHeight - 1) / tileHeight;
+    return columns * rows;
+}
+
+
+int bmp_viewTile(const t_bmp_view *view, int tileWidth, int tileHeight, int index, t_bmp_view *tile) {
+    int count = bmp_viewTileCount(view, tileWidth, tileHeight);
+    if (count < 0 || index < 0 || index >= count) {
+        printf("Erreur: Numéro de tuile invalide\n");
+        return -1;
+    }
+
+    int columns = (view->width + tileWidth - 1) / tileWidth;
+    return bmp_subView(view, (index % columns) * tileWidth, (index / columns) * tileHeight,
+                       tileWidth, tileHeight, tile);
+}
+
+
+static void view_tileBand(void *arg, int begin, int end) {
+    const t_view_pass *pass = (const t_view_pass *)arg;
+
+    for (int i = begin; i < end; i++) {
+        t_bmp_view tile;
+        if (bmp_viewTile(pass->view, pass->tileWidth, pass->tileHeight, i, &tile) == 0) {
+            pass->task(&tile, pass->arg);
+        }
+    }
+}
+
+
+int bmp_viewParallel(const t_bmp_view *view, int tileWidth, int tileHeight, t_view_task task, void *arg) {
+    int count = bmp_viewTileCount(view, tileWidth, tileHeight);
+    if (count < 0 || task == NULL) {
+        return -1;
+    }
+
+    t_view_pass pass = {view, tileWidth, tileHeight, task, arg};
+    bmp_parallelFor(count, 1, view_tileBand, &pass);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file bmpview.h
+ *
+ * @brief
+ * Vues sur une image : pointeur sur le premier pixel, dimensions, pas entre
+ * deux lignes et nombre de composantes. Une vue n'est propriétaire de rien
+ * (elle emprunte les pixels d'une image existante) : découper une zone ne
+ * copie aucun pixel, et les traitements qui acceptent une vue (filtres,
+ * fusion, statistiques, tables) travaillent directement dans la zone. Les
+ * mêmes vues servent à découper le travail en tuiles pour les threads.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#ifndef BMPVIEW_H
+#define BMPVIEW_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmp32.h"
+
+/*
+ * Zone d'une image, parcourue de haut en bas
+ */
+typedef struct {
+    uint8_t *base;          // Premier pixel de la ligne du haut
+    int width;              // Largeur en pixels
+    int height;             // Hauteur en lignes
+    ptrdiff_t stride;       // Octets d'une ligne à celle du dessous (négatif si
+                            // l'image est rangée de bas en haut en mémoire)
+    int channels;           // Octets par pixel : 1 (gris), 3 (t_pixel), 4 (t_pixel32)
+} t_bmp_view;
+
+/*
+ * Traitement d'une tuile par bmp_viewParallel
+ *   tile - Zone à traiter (sous-vue de la vue d'origine)
+ *   arg  - Contexte propre au traitement
+ */
+typedef void (*t_view_task)(const t_bmp_view *tile, void *arg);
+
+/* bmp8_view / bmp24_view / bmp32_view
+ * Rôle : Donne la vue de toute une image
+ * Paramètres :
+ *   img  - Image dont les pixels sont empruntés (elle doit vivre plus
+ *          longtemps que la vue)
+ *   view - Reçoit la vue
+ * Retour : 0 si réussi, -1 si l'image est invalide
+ * Note : Pour une image 8 bits rangée de bas en haut, le pas est négatif :
+ *        la ligne 0 de la vue reste la ligne du haut
+ */
+int bmp8_view(t_bmp8 *img, t_bmp_view *view);
+int bmp24_view(t_bmp24 *img, t_bmp_view *view);
+int bmp32_view(t_bmp32 *img, t_bmp_view *view);
+
+/* bmp_subView
+ * Rôle : Découpe une zone d'une vue, sans copie
+ * Paramètres :
+ *   view          - Vue d'origine
+ *   x, y          - Coin haut gauche de la zone dans la vue
+ *   width, height - Dimensions de la zone
+ *   sub           - Reçoit la zone, rognée aux bords de la vue
+ * Retour : 0 si réussi, -1 si la zone est vide ou hors de la vue
+ */
+int bmp_subView(const t_bmp_view *view, int x, int y, int width, int height, t_bmp_view *sub);
+
+/* bmp_viewRow
+ * Rôle : Donne le premier octet de la ligne y (0 = haut) de la vue
+ */
+uint8_t *bmp_viewRow(const t_bmp_view *view, int y);
+
+/* bmp_viewRows
+ * Rôle : Donne les lignes de la vue de haut en bas, pour les traitements
+ *        génériques qui travaillent sur des tableaux de lignes
+ * Retour : Tableau de height pointeurs à libérer avec free(), NULL si erreur
+ */
+uint8_t **bmp_viewRows(const t_bmp_view *view);
+
+/* bmp_viewCopy
+ * Rôle : Copie les pixels d'une vue dans une autre
+ * Paramètres :
+ *   dst - Vue de destination (mêmes dimensions et composantes que src)
+ *   src - Vue source (ne doit pas chevaucher dst)
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_viewCopy(const t_bmp_view *dst, const t_bmp_view *src);
+
+/* bmp_viewTileCount
+ * Rôle : Donne le nombre de tuiles de tileWidth x tileHeight qui couvrent la vue
+ * Retour : Nombre de tuiles, -1 si paramètres invalides
+ */
+int bmp_viewTileCount(const t_bmp_view *view, int tileWidth, int tileHeight);
+
+/* bmp_viewTile
+ * Rôle : Donne une tuile de la vue (les tuiles du bord droit et du bas sont
+ *        rognées), numérotées ligne par ligne depuis le coin haut gauche
+ * Paramètres :
+ *   view                  - Vue découpée
+ *   tileWidth, tileHeight - Taille des tuiles
+ *   index                 - Numéro de la tuile (0 à bmp_viewTileCount - 1)
+ *   tile                  - Reçoit la tuile
+ * Retour : 0 si réussi, -1 si erreur
+ */
+int bmp_viewTile(const t_bmp_view *view, int tileWidth, int tileHeight, int index, t_bmp_view *tile);
+
+/* bmp_viewParallel
+ * Rôle : Exécute task sur chaque tuile de la vue, réparties entre les threads
+ * Paramètres :
+ *   view                  - Vue découpée
+ *   tileWidth, tileHeight - Taille des tuiles (tileWidth = view->width
+ *                           pour des bandes de lignes)
+ *   task                  - Traitement d'une tuile ; les tuiles ne se
+ *                           chevauchent pas et peuvent être modifiées sans verrou
+ *   arg                   - Contexte transmis à task
+ * Retour : 0 si réussi, -1 si paramètres invalides
+ */
+int bmp_viewParallel(const t_bmp_view *view, int tileWidth, int tileHeight, t_view_task task, void *arg);
+
+#endif
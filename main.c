@@ -0,0 +1,17 @@
+/**
+ * @file main.c
+ *
+ * @brief
+ * Point d'entrée de l'exécutable : la ligne de commande est interprétée
+ * par bmp_cliMain (chaîne d'opérations sur une image, ou --batch pour un
+ * dossier entier).
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmpcli.h"
+
+int main(int argc, char **argv) {
+    return bmp_cliMain(argc, argv);
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_batch.c
+ *
+ * @brief
+ * Lot d'images 8 bits de tailles variées (la plus grande n'est pas la
+ * première) traité par bmp_batchRun avec une chaîne à deux filtres 3x3 :
+ * chaque fichier enregistré doit être identique à celui de bmp8_loadImage,
+ * bmp8_applyChain puis bmp8_saveImage. Avec un seul thread et un seul
+ * calcul, la même mémoire de travail sert à tous les fichiers et
+ * l'allocateur rend souvent à bmp8_applyFilter l'adresse du bloc qu'il
+ * vient de libérer : la mémoire de travail doit quand même suivre la
+ * taille du tableau de pixels remplacé.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp8.h"
+#include "bmpbatch.h"
+#include "bmpchain.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_FILES 24
+
+static const uint32_t test_sizes[][2] = {
+    {256, 256}, {240, 250}, {256, 256}, {236, 244}, {320, 240}, {300, 250}, {1024, 700}, {13, 9}, {96, 80}, {5, 3}
+};
+#define TEST_SIZE_COUNT (int)(sizeof(test_sizes) / sizeof(test_sizes[0]))
+
+
+/*
+ * Enregistre une image 8 bits au motif propre à son numéro
+ */
+static int test_writeInput(const char *filename, int index) {
+    const uint32_t *size = test_sizes[index % TEST_SIZE_COUNT];
+    t_bmp8 *img = bmp8_allocate(size[0], size[1]);
+    if (img == NULL) {
+        return -1;
+    }
+    for (uint32_t y = 0; y < img->height; y++) {
+        unsigned char *row = bmp8_row(img, y);
+        for (uint32_t x = 0; x < img->width; x++) {
+            row[x] = (unsigned char)((x * 7 + y * 13 + (x ^ y) + index * 31) & 0xFF);
+        }
+    }
+    int status = bmp8_saveImage(filename, img);
+    bmp8_free(img);
+    return status;
+}
+
+
+/*
+ * Lit un fichier entier (NULL si erreur)
+ */
+static unsigned char *test_readAll(const char *filename, long *size) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = (unsigned char *)malloc((size_t)*size);
+    if (data != NULL && fread(data, 1, (size_t)*size, file) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+
+static int test_sameFile(const char *a, const char *b) {
+    long sizeA = 0;
+    long sizeB = 0;
+    unsigned char *dataA = test_readAll(a, &sizeA);
+    unsigned char *dataB = test_readAll(b, &sizeB);
+    int same = (dataA != NULL && dataB != NULL && sizeA == sizeB && memcmp(dataA, dataB, (size_t)sizeA) == 0);
+    free(dataA);
+    free(dataB);
+    return same;
+}
+
+
+/*
+ * Résultat attendu : chargement, chaîne et enregistrement séparés
+ */
+static int test_writeExpected(const char *input, const char *output, const t_bmp_chain *chain) {
+    t_bmp8 *img = bmp8_loadImage(input);
+    if (img == NULL) {
+        return -1;
+    }
+    int status = bmp8_applyChain(img, chain);
+    if (status == 0) {
+        status = bmp8_saveImage(output, img);
+    }
+    bmp8_free(img);
+    return status;
+}
+
+
+int main(void) {
+    char inputs[TEST_FILES][64];
+    char outputs[TEST_FILES][64];
+    char expected[TEST_FILES][64];
+    const char *inputList[TEST_FILES];
+    const char *outputList[TEST_FILES];
+    int fails = 0;
+
+    t_bmp_chain *chain = bmp_chainCreate();
+    if (chain == NULL || bmp_chainAdd(chain, BMP_STEP_BRIGHTNESS, 20) != 0 ||
+        bmp_chainAdd(chain, BMP_STEP_GAUSSIAN_BLUR, 0) != 0 || bmp_chainAdd(chain, BMP_STEP_SHARPEN, 0) != 0) {
+        printf("Erreur: Chaîne impossible à créer\n");
+        return 1;
+    }
+
+    for (int i = 0; i < TEST_FILES; i++) {
+        snprintf(inputs[i], sizeof(inputs[i]), "batch_in_%02d.bmp", i);
+        snprintf(outputs[i], sizeof(outputs[i]), "batch_out_%02d.bmp", i);
+        snprintf(expected[i], sizeof(expected[i]), "batch_ref_%02d.bmp", i);
+        inputList[i] = inputs[i];
+        outputList[i] = outputs[i];
+        if (test_writeInput(inputs[i], i) != 0 || test_writeExpected(inputs[i], expected[i], chain) != 0) {
+            printf("Erreur: Préparation de %s impossible\n", inputs[i]);
+            bmp_chainFree(chain);
+            return 1;
+        }
+    }
+
+    // Un seul thread et un seul calcul (mémoire de travail partagée par
+    // tous les fichiers), puis les réglages par défaut
+    t_batch_config configs[2] = {{1, 1, 1, 1}, {0, 0, 0, 0}};
+    for (int c = 0; c < 2; c++) {
+        bmp_setThreadCount((c == 0) ? 1 : 0);
+        t_batch_report report = {0, 0, 0, 0, 0.0};
+        if (bmp_batchRun(inputList, outputList, TEST_FILES, chain, &configs[c], &report) != 0 ||
+            report.files != TEST_FILES || report.failed != 0) {
+            printf("ECHEC config %d : %d fichiers, %d en échec\n", c, report.files, report.failed);
+            fails++;
+            continue;
+        }
+        for (int i = 0; i < TEST_FILES; i++) {
+            if (!test_sameFile(outputs[i], expected[i])) {
+                printf("ECHEC config %d : %s différent de %s\n", c, outputs[i], expected[i]);
+                fails++;
+            }
+            remove(outputs[i]);
+        }
+    }
+
+    for (int i = 0; i < TEST_FILES; i++) {
+        remove(inputs[i]);
+        remove(expected[i]);
+    }
+    bmp_chainFree(chain);
+
+    printf("test_batch : %d échec(s)\n", fails);
+    return (fails == 0) ? 0 : 1;
+}
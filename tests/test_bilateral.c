@@ -0,0 +1,158 @@
+/**
+ * @file test_bilateral.c
+ *
+ * @brief
+ * Précision du filtre bilatéral approché : sur des marches bruitées en 8 et
+ * 24 bits, l'écart avec bmp8_bilateralReference / bmp24_bilateralReference
+ * doit rester sous TEST_MEAN_TOLERANCE niveaux en moyenne et sous
+ * TEST_MAX_TOLERANCE niveaux pour chaque pixel.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "bmpsmooth.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_MEAN_TOLERANCE 0.25
+#define TEST_MAX_TOLERANCE 4
+
+#define TEST_WIDTH 157
+#define TEST_HEIGHT 103
+
+
+/*
+ * Niveau du pixel (x, y) : marches verticales et diagonale, plus un bruit
+ * de +-12 niveaux (suite pseudo-aléatoire fixe)
+ */
+static unsigned char test_level(int x, int y, int channel, uint32_t *seed) {
+    int value = (x < TEST_WIDTH / 3) ? 40 : (x < 2 * TEST_WIDTH / 3 ? 130 : 210);
+    if (x + y * 2 > TEST_WIDTH + channel * 20) {
+        value -= 30;
+    }
+    *seed = *seed * 1103515245u + 12345u;
+    value += (int)((*seed >> 16) % 25) - 12;
+    return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+
+/*
+ * Cumule les écarts entre deux lignes d'octets
+ */
+static void test_compare(const unsigned char *a, const unsigned char *b, int count, double *sum, int *worst) {
+    for (int i = 0; i < count; i++) {
+        int diff = abs((int)a[i] - (int)b[i]);
+        *sum += diff;
+        if (diff > *worst) {
+            *worst = diff;
+        }
+    }
+}
+
+
+static int test_check(const char *name, int radius, double sigma, double sum, int worst, long count) {
+    double mean = sum / (double)count;
+    printf("%s r=%d sigma=%.0f : écart moyen %.3f, max %d\n", name, radius, sigma, mean, worst);
+    if (mean > TEST_MEAN_TOLERANCE || worst > TEST_MAX_TOLERANCE) {
+        printf("ECHEC %s r=%d sigma=%.0f\n", name, radius, sigma);
+        return 1;
+    }
+    return 0;
+}
+
+
+static int test_bmp8(int radius, double sigma) {
+    t_bmp8 *fast = bmp8_allocate(TEST_WIDTH, TEST_HEIGHT);
+    t_bmp8 *exact = bmp8_allocate(TEST_WIDTH, TEST_HEIGHT);
+    if (fast == NULL || exact == NULL) {
+        bmp8_free(fast);
+        bmp8_free(exact);
+        return 1;
+    }
+
+    uint32_t seed = 7;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        unsigned char *row = bmp8_row(fast, (uint32_t)y);
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            row[x] = test_level(x, y, 0, &seed);
+        }
+    }
+    memcpy(exact->data, fast->data, fast->dataSize);
+
+    int fails = 0;
+    if (bmp8_bilateralFilter(fast, radius, sigma) != 0 || bmp8_bilateralReference(exact, radius, sigma) != 0) {
+        printf("ECHEC bmp8 r=%d sigma=%.0f : erreur du filtre\n", radius, sigma);
+        fails++;
+    } else {
+        double sum = 0.0;
+        int worst = 0;
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            test_compare(bmp8_row(fast, (uint32_t)y), bmp8_row(exact, (uint32_t)y), TEST_WIDTH, &sum, &worst);
+        }
+        fails += test_check("bmp8", radius, sigma, sum, worst, (long)TEST_WIDTH * TEST_HEIGHT);
+    }
+
+    bmp8_free(fast);
+    bmp8_free(exact);
+    return fails;
+}
+
+
+static int test_bmp24(int radius, double sigma) {
+    t_bmp24 *fast = bmp24_allocate(TEST_WIDTH, TEST_HEIGHT, 24);
+    t_bmp24 *exact = bmp24_allocate(TEST_WIDTH, TEST_HEIGHT, 24);
+    if (fast == NULL || exact == NULL) {
+        bmp24_free(fast);
+        bmp24_free(exact);
+        return 1;
+    }
+
+    uint32_t seed = 11;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            fast->data[y][x].red = test_level(x, y, 0, &seed);
+            fast->data[y][x].green = test_level(x, y, 1, &seed);
+            fast->data[y][x].blue = test_level(x, y, 2, &seed);
+        }
+        memcpy(exact->data[y], fast->data[y], TEST_WIDTH * sizeof(t_pixel));
+    }
+
+    int fails = 0;
+    if (bmp24_bilateralFilter(fast, radius, sigma) != 0 || bmp24_bilateralReference(exact, radius, sigma) != 0) {
+        printf("ECHEC bmp24 r=%d sigma=%.0f : erreur du filtre\n", radius, sigma);
+        fails++;
+    } else {
+        double sum = 0.0;
+        int worst = 0;
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            test_compare((const unsigned char *)fast->data[y], (const unsigned char *)exact->data[y],
+                         TEST_WIDTH * 3, &sum, &worst);
+        }
+        fails += test_check("bmp24", radius, sigma, sum, worst, (long)TEST_WIDTH * TEST_HEIGHT * 3);
+    }
+
+    bmp24_free(fast);
+    bmp24_free(exact);
+    return fails;
+}
+
+
+int main(void) {
+    static const int radii[] = {1, 3, 6};
+    static const double sigmas[] = {15.0, 30.0, 60.0};
+    int fails = 0;
+
+    for (int r = 0; r < 3; r++) {
+        for (int s = 0; s < 3; s++) {
+            fails += test_bmp8(radii[r], sigmas[s]);
+            fails += test_bmp24(radii[r], sigmas[s]);
+        }
+    }
+
+    printf("test_bilateral : %d échec(s)\n", fails);
+    return (fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file test_canny.c
+ *
+ * @brief
+ * bmp8_canny (en flux, par bandes) doit donner exactement la carte de
+ * contours de bmp8_cannyReference (étape par étape, un seul thread), pour
+ * des tailles plus petites que les noyaux, des lignes rangées dans les
+ * deux sens et plusieurs nombres de threads. Le temps des deux versions
+ * est ensuite mesuré sur une grande image et affiché.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp8.h"
+#include "bmpcanny.h"
+#include "bmpthread.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_BENCH_WIDTH 4000
+#define TEST_BENCH_HEIGHT 3000
+#define TEST_BENCH_RUNS 3
+
+static const uint32_t test_sizes[][2] = {
+    {1, 1}, {2, 3}, {5, 4}, {17, 5}, {64, 64}, {255, 97}, {641, 480}
+};
+#define TEST_SIZE_COUNT (int)(sizeof(test_sizes) / sizeof(test_sizes[0]))
+
+
+/*
+ * Image de test : dégradé, disque, rectangles et bruit (suite pseudo-aléatoire fixe)
+ */
+static t_bmp8 *test_image(uint32_t width, uint32_t height, int topDown) {
+    t_bmp8 *img = bmp8_allocate(width, height);
+    if (img == NULL || bmp8_setTopDown(img, topDown) != 0) {
+        bmp8_free(img);
+        return NULL;
+    }
+
+    uint32_t seed = width * 7919u + height;
+    for (uint32_t y = 0; y < height; y++) {
+        unsigned char *row = bmp8_row(img, y);
+        for (uint32_t x = 0; x < width; x++) {
+            int dx = (int)x - (int)width / 2;
+            int dy = (int)y - (int)height / 3;
+            int value = (int)((x * 96) / width + (y * 64) / height);
+            if (dx * dx + dy * dy < (int)(width * height / 12)) {
+                value += 90;
+            }
+            if ((x / 23 + y / 17) % 5 == 0) {
+                value += 60;
+            }
+            seed = seed * 1103515245u + 12345u;
+            value += (int)((seed >> 16) % 24);
+            row[x] = (unsigned char)(value > 255 ? 255 : value);
+        }
+    }
+    return img;
+}
+
+
+static int test_sameEdges(const t_bmp8 *a, const t_bmp8 *b) {
+    if (a == NULL || b == NULL || a->width != b->width || a->height != b->height) {
+        return 0;
+    }
+    for (uint32_t y = 0; y < a->height; y++) {
+        if (memcmp(bmp8_row(a, y), bmp8_row(b, y), a->width) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+static double test_now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+int main(void) {
+    static const int thresholds[][2] = {{20, 60}, {40, 120}, {0, 0}};
+    static const int threadCounts[] = {1, 3, 0};
+    int fails = 0;
+
+    for (int s = 0; s < TEST_SIZE_COUNT; s++) {
+        for (int topDown = 0; topDown < 2; topDown++) {
+            t_bmp8 *img = test_image(test_sizes[s][0], test_sizes[s][1], topDown);
+            if (img == NULL) {
+                printf("Erreur: Image de test impossible à créer\n");
+                return 1;
+            }
+            for (int t = 0; t < 3; t++) {
+                t_bmp8 *expected = bmp8_cannyReference(img, thresholds[t][0], thresholds[t][1]);
+                for (int n = 0; n < 3; n++) {
+                    bmp_setThreadCount(threadCounts[n]);
+                    t_bmp8 *edges = bmp8_canny(img, thresholds[t][0], thresholds[t][1]);
+                    if (!test_sameEdges(edges, expected)) {
+                        printf("ECHEC %ux%u topDown=%d seuils %d/%d threads=%d\n",
+                               test_sizes[s][0], test_sizes[s][1], topDown,
+                               thresholds[t][0], thresholds[t][1], threadCounts[n]);
+                        fails++;
+                    }
+                    bmp8_free(edges);
+                }
+                bmp8_free(expected);
+            }
+            bmp8_free(img);
+        }
+    }
+
+    // Mesure : meilleur temps de chaque version sur une grande image
+    t_bmp8 *img = test_image(TEST_BENCH_WIDTH, TEST_BENCH_HEIGHT, 0);
+    if (img == NULL) {
+        printf("Erreur: Image de test impossible à créer\n");
+        return 1;
+    }
+    for (int n = 0; n < 2; n++) {
+        bmp_setThreadCount(threadCounts[n == 0 ? 0 : 2]);
+        double best[2] = {1e30, 1e30};
+        for (int run = 0; run < TEST_BENCH_RUNS; run++) {
+            double start = test_now();
+            t_bmp8 *expected = bmp8_cannyReference(img, 40, 120);
+            double middle = test_now();
+            t_bmp8 *edges = bmp8_canny(img, 40, 120);
+            double end = test_now();
+            if (!test_sameEdges(edges, expected)) {
+                printf("ECHEC %dx%d threads=%d\n", TEST_BENCH_WIDTH, TEST_BENCH_HEIGHT, bmp_threadCount());
+                fails++;
+            }
+            bmp8_free(expected);
+            bmp8_free(edges);
+            best[0] = (middle - start < best[0]) ? middle - start : best[0];
+            best[1] = (end - middle < best[1]) ? end - middle : best[1];
+        }
+        printf("Canny %dx%d, %d thread(s) : référence %.1f ms, flux %.1f ms (x%.2f)\n",
+               TEST_BENCH_WIDTH, TEST_BENCH_HEIGHT, bmp_threadCount(),
+               best[0] * 1000.0, best[1] * 1000.0, best[0] / best[1]);
+    }
+    bmp8_free(img);
+
+    printf("test_canny : %d échec(s)\n", fails);
+    return (fails == 0) ? 0 : 1;
+}
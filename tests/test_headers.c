@@ -0,0 +1,122 @@
+/**
+ * @file test_headers.c
+ *
+ * @brief
+ * En-têtes 8 bits forgés : dimensions nulles, hauteur INT32_MIN, largeur
+ * négative et tailles dont le produit déborde 32 bits (65536 x 65536 avec
+ * un flux RLE8 de quelques octets) doivent être refusés par bmp8_loadImage
+ * et bmp8_decode avant toute allocation. Une petite image valide, brute
+ * puis en RLE8, doit toujours se charger.
+ *
+ * @author [Aurelien Devaux-Rivière]
+ * @date   [18/10/26]
+ */
+
+#include "bmp8.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_FILE "headers_test.bmp"
+#define TEST_PIXELS (BMP_HEADER_SIZE + BMP_COLOR_TABLE_SIZE)
+#define TEST_SIZE (TEST_PIXELS + 16)
+
+
+static void test_put32(unsigned char *p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+
+/*
+ * Fichier 8 bits de width x height pixels ; les 16 octets de données sont
+ * deux lignes brutes de 4 pixels ou un flux RLE8 (deux suites puis fin)
+ */
+static void test_build(unsigned char *file, uint32_t width, uint32_t height, uint32_t compression) {
+    static const unsigned char rle[16] = {100, 7, 100, 9, 0, 0, 0, 1};
+    memset(file, 0, TEST_SIZE);
+    file[0] = 'B';
+    file[1] = 'M';
+    test_put32(file + 2, TEST_SIZE);
+    test_put32(file + 10, TEST_PIXELS);
+    test_put32(file + 14, 40);
+    test_put32(file + 18, width);
+    test_put32(file + 22, height);
+    file[26] = 1;
+    file[28] = 8;
+    test_put32(file + 30, compression);
+    if (compression == BMP_BI_RLE8) {
+        memcpy(file + TEST_PIXELS, rle, sizeof(rle));
+    } else {
+        for (int i = 0; i < 16; i++) {
+            file[TEST_PIXELS + i] = (unsigned char)(i * 16);
+        }
+    }
+}
+
+
+/* 1 si le fichier est chargé par les deux chemins, 0 s'il est refusé par les deux, -1 sinon */
+static int test_load(const unsigned char *file) {
+    FILE *out = fopen(TEST_FILE, "wb");
+    if (out == NULL || fwrite(file, 1, TEST_SIZE, out) != TEST_SIZE) {
+        if (out != NULL) {
+            fclose(out);
+        }
+        return -1;
+    }
+    fclose(out);
+
+    t_bmp8 *loaded = bmp8_loadImage(TEST_FILE);
+    t_bmp8 decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    size_t capacity = 0;
+    int status = bmp8_decode(file, TEST_SIZE, &decoded, &capacity);
+    free(decoded.data);
+
+    int result = -1;
+    if (loaded == NULL && status != 0) {
+        result = 0;
+    } else if (loaded != NULL && status == 0) {
+        result = 1;
+    }
+    bmp8_free(loaded);
+    remove(TEST_FILE);
+    return result;
+}
+
+
+int main(void) {
+    static const struct {
+        uint32_t width;
+        uint32_t height;
+        uint32_t compression;
+        int valid;
+    } cases[] = {
+        {4, 2, BMP_BI_RGB, 1},
+        {4, 2, BMP_BI_RLE8, 1},
+        {0, 2, BMP_BI_RGB, 0},
+        {4, 0, BMP_BI_RLE8, 0},
+        {4, 0x80000000u, BMP_BI_RGB, 0},
+        {0xFFFFFFFCu, 2, BMP_BI_RGB, 0},
+        {65536, 65536, BMP_BI_RLE8, 0},
+        {65536, 65536, BMP_BI_RGB, 0},
+        {70000, 70000, BMP_BI_RLE8, 0},
+        {4, 5, BMP_BI_RGB, 0},          // Données plus courtes que l'image
+    };
+    unsigned char file[TEST_SIZE];
+    int fails = 0;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        test_build(file, cases[c].width, cases[c].height, cases[c].compression);
+        int result = test_load(file);
+        if (result != cases[c].valid) {
+            printf("ECHEC %ux%u compression %u : %s\n", cases[c].width, cases[c].height, cases[c].compression,
+                   (result < 0) ? "chemins en désaccord" : (cases[c].valid ? "refusé" : "accepté"));
+            fails++;
+        }
+    }
+
+    printf("test_headers : %d échec(s)\n", fails);
+    return (fails == 0) ? 0 : 1;
+}